@@ -1129,6 +1129,7 @@ void C4Command::Get()
 		{
 			Finish(); return;
 		}
+	RegisterTargets();
 
 	// No target: failure
 	if (!Target) { Finish(); return; }
@@ -1313,6 +1314,7 @@ void C4Command::Activate()
 	if (!Target2)
 		if (Target)
 			Target2 = Target->Contained;
+	RegisterTargets();
 
 	// No container specified: fail
 	if (!Target2) { Finish(); return; }
@@ -1333,7 +1335,7 @@ void C4Command::Activate()
 					if (pObj->Status && (pObj->Def->id == static_cast<C4ID>(Data)))
 						if (!pObj->Command || (pObj->Command->Command != C4CMD_Exit))
 						{
-							Target = pObj; break;
+							Target = pObj; RegisterTargets(); break;
 						}
 			// No target
 			if (!Target) { Finish(); return; }
@@ -1380,6 +1382,7 @@ void C4Command::Put() // Notice: Put command is currently using Ty as an interna
 		{
 			Finish(); return;
 		}
+	RegisterTargets();
 
 	// No thing to put specified
 	if (!Target2)
@@ -1391,6 +1394,7 @@ void C4Command::Put() // Notice: Put command is currently using Ty as an interna
 		{
 			Finish(true); return;
 		}
+	RegisterTargets();
 
 	// Thing is in target
 	if (Target2->Contained == Target)
@@ -1499,6 +1503,14 @@ void C4Command::Put() // Notice: Put command is currently using Ty as an interna
 	}
 }
 
+void C4Command::RegisterTargets()
+{
+	// the object executing the command holds the pointers
+	if (!cObj) return;
+	cObj->AddReference(Target);
+	cObj->AddReference(Target2);
+}
+
 void C4Command::ClearPointers(C4Object *pObj)
 {
 	if (cObj == pObj) cObj = nullptr;
@@ -1982,6 +1994,7 @@ void C4Command::Buy()
 		for (cnt = 0; pBase = Game.FindFriendlyBase(cObj->Owner, cnt); cnt++)
 			if (!Target || Distance(cObj->x, cObj->y, pBase->x, pBase->y) < Distance(cObj->x, cObj->y, Target->x, Target->y))
 				Target = pBase;
+	RegisterTargets();
 	// No target (base) object: fail
 	if (!Target) { Finish(); return; }
 	// No type to buy specified: open buy menu for base
@@ -2035,6 +2048,7 @@ void C4Command::Sell()
 		for (cnt = 0; pBase = Game.FindBase(cObj->Owner, cnt); cnt++)
 			if (!Target || Distance(cObj->x, cObj->y, pBase->x, pBase->y) < Distance(cObj->x, cObj->y, Target->x, Target->y))
 				Target = pBase;
+	RegisterTargets();
 	// No target (base) object: fail
 	if (!Target) { Finish(); return; }
 	// No type to sell specified: open sell menu for base
@@ -2247,6 +2261,7 @@ void C4Command::Energy()
 	}
 	// No energy supply specified: find one
 	if (!Target2) Target2 = Game.FindObject(0, Target->x, Target->y, -1, -1, OCF_PowerSupply, nullptr, nullptr, Target);
+	RegisterTargets();
 	// No energy supply: fail
 	if (!Target2) { Finish(); return; }
 	// Energy supply too far away: fail
@@ -2284,6 +2299,7 @@ void C4Command::Energy()
 			Target2 = pLine->Action.Target2;
 		else
 			Target2 = pLine->Action.Target;
+		RegisterTargets();
 	}
 	// Move to target
 	if (!Target->At(cObj->x, cObj->y, ocf))
@@ -2315,6 +2331,7 @@ void C4Command::Home()
 		for (cnt = 0; pBase = Game.FindBase(cObj->Owner, cnt); cnt++)
 			if (!Target || Distance(cObj->x, cObj->y, pBase->x, pBase->y) < Distance(cObj->x, cObj->y, Target->x, Target->y))
 				Target = pBase;
+	RegisterTargets();
 	// No base: fail
 	if (!Target) { Finish(); return; }
 	// Enter base
@@ -2333,6 +2350,7 @@ void C4Command::Set(int32_t iCommand, C4Object *pObj, C4Object *pTarget, C4Value
 	Target = pTarget;
 	Tx = nTx; Ty = iTy;
 	Target2 = pTarget2;
+	RegisterTargets();
 	Data = iData;
 	UpdateInterval = iUpdateInterval;
 	Evaluated = fEvaluated;
@@ -102,6 +102,7 @@ public:
 	void CompileFunc(StdCompiler *pComp);
 
 protected:
+	void RegisterTargets(); // register targets as referenced by cObj
 	void Call();
 	void Home();
 	void Retry();
@@ -51,6 +51,7 @@
 #define C4CFN_Landscape        "Landscape.bmp"
 #define C4CFN_LandscapePNG     "Landscape.png"
 #define C4CFN_DiffLandscape    "DiffLandscape.bmp"
+#define C4CFN_DiffLandscapeTiles "DiffLandscape.c4b"
 #define C4CFN_Sky              "Sky"
 #define C4CFN_Script           "Script.c|Script%s.c|C4Script%s.c"
 #define C4CFN_ScriptStringTbl  "StringTbl.txt|StringTbl%s.txt"
@@ -115,6 +116,8 @@
 #define C4CFN_Names  "Names.txt"
 #define C4CFN_Titles "Title*.txt|Title.txt"
 
+#define C4CFN_NetResCache "NetworkCache"
+
 #define C4CFN_TempMusic2       "~Music2.tmp"
 #define C4CFN_TempMap          "~Map.tmp"
 #define C4CFN_TempLandscape    "~Landscape.tmp"
@@ -138,7 +141,7 @@
 
 // File Load Sequences
 
-#define C4FLS_Scenario         "Loader*.bmp|Loader*.png|Loader*.jpeg|Loader*.jpg|Fonts.txt|Scenario.txt|Title*.txt|Info.txt|Desc*.rtf|Icon.png|Icon.bmp|Game.txt|StringTbl*.txt|Teams.txt|Parameters.txt|Info.txt|Sect*.c4g|Music.c4g|*.mid|*.wav|Desc*.rtf|Title.bmp|Title.png|*.c4d|Material.c4g|MatMap.txt|Landscape.bmp|Landscape.png|" C4CFN_DiffLandscape "|Sky.bmp|Sky.png|Sky.jpeg|Sky.jpg|PXS.c4b|MassMover.c4b|CtrlRec.c4b|Strings.txt|Objects.txt|RoundResults.txt|Author.txt|Version.txt|Names.txt|*.c4d|Script.c|Script*.c|System.c4g"
+#define C4FLS_Scenario         "Loader*.bmp|Loader*.png|Loader*.jpeg|Loader*.jpg|Fonts.txt|Scenario.txt|Title*.txt|Info.txt|Desc*.rtf|Icon.png|Icon.bmp|Game.txt|StringTbl*.txt|Teams.txt|Parameters.txt|Info.txt|Sect*.c4g|Music.c4g|*.mid|*.wav|Desc*.rtf|Title.bmp|Title.png|*.c4d|Material.c4g|MatMap.txt|Landscape.bmp|Landscape.png|" C4CFN_DiffLandscape "|" C4CFN_DiffLandscapeTiles "|Sky.bmp|Sky.png|Sky.jpeg|Sky.jpg|PXS.c4b|MassMover.c4b|CtrlRec.c4b|Strings.txt|Objects.txt|RoundResults.txt|Author.txt|Version.txt|Names.txt|*.c4d|Script.c|Script*.c|System.c4g"
 #define C4FLS_Section          "Scenario.txt|Game.txt|Landscape.bmp|Landscape.png|Sky.bmp|Sky.png|Sky.jpeg|Sky.jpg|PXS.c4b|MassMover.c4b|CtrlRec.c4b|Strings.txt|Objects.txt"
 #define C4FLS_SectionLandscape "Scenario.txt|Landscape.bmp|Landscape.png|PXS.c4b|MassMover.c4b"
 #define C4FLS_SectionObjects   "Strings.txt|Objects.txt"
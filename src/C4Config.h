@@ -177,6 +177,7 @@ public:
 	ValidatedStdStrBuf<C4InVal::VAL_NameNoEmpty> LocalName;
 	ValidatedStdStrBuf<C4InVal::VAL_NameAllowEmpty> Nick;
 	int32_t MaxLoadFileSize;
+	int32_t ResCacheSize; // (MB) loaded ressources are kept for later sessions, 0 to disable
 	char LastPassword[CFG_MaxString + 1];
 	char ServerAddress[CFG_MaxString + 1];
 	char AlternateServerAddress[CFG_MaxString + 1];
@@ -190,6 +191,8 @@ public:
 	bool AutomaticUpdate;
 	uint64_t LastUpdateTime;
 	int32_t AsyncMaxWait;
+	bool AdaptiveControlRate; // host raises the control rate above ControlRate if latency demands it
+	int32_t StreamCompressionLevel; // zlib level (0-9) for record streaming
 
 public:
 	void CompileFunc(StdCompiler *pComp);
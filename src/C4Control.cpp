@@ -124,6 +124,7 @@ void C4ControlSet::Execute() const
 	switch (eValType)
 	{
 	case C4CVT_ControlRate: // adjust control rate
+	case C4CVT_AutoControlRate:
 		// host only
 		if (!HostControl()) break;
 		// adjust control rate
@@ -131,7 +132,7 @@ void C4ControlSet::Execute() const
 		Game.Control.ControlRate = BoundBy<int32_t>(Game.Control.ControlRate, 1, C4MaxControlRate);
 		Game.Parameters.ControlRate = Game.Control.ControlRate;
 		// write back adjusted control rate to network settings
-		if (Game.Control.isCtrlHost() && !Game.Control.isReplay() && Game.Control.isNetwork())
+		if (eValType == C4CVT_ControlRate && Game.Control.isCtrlHost() && !Game.Control.isReplay() && Game.Control.isNetwork())
 			Config.Network.ControlRate = Game.Control.ControlRate;
 		// always show msg
 		Game.GraphicsSystem.FlashMessage(FormatString(LoadResStr("IDS_NET_CONTROLRATE"), Game.Control.ControlRate, Game.FrameCounter).getData());
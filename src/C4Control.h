@@ -100,6 +100,7 @@ enum C4CtrlValueType
 	C4CVT_TeamDistribution = 3,
 	C4CVT_TeamColors = 4,
 	C4CVT_FairCrew = 5,
+	C4CVT_AutoControlRate = 6, // like C4CVT_ControlRate, but not written back to config
 };
 
 class C4ControlSet : public C4ControlPacket // sync, lobby
@@ -1171,6 +1171,7 @@ bool C4DefList::Remove(C4ID id)
 		{
 			if (prev) prev->Next = cdef->Next;
 			else FirstDef = cdef->Next;
+			RemoveFromTable(cdef);
 			delete cdef;
 			return true;
 		}
@@ -1185,11 +1186,35 @@ void C4DefList::Remove(C4Def *def)
 		{
 			if (prev) prev->Next = cdef->Next;
 			else FirstDef = cdef->Next;
+			RemoveFromTable(cdef);
 			delete cdef;
 			return;
 		}
 }
 
+void C4DefList::RemoveFromTable(C4Def *pDef)
+{
+	if (!fTable) return;
+	const size_t iMask = Table.size() - 1;
+	size_t i = GetTableIndex(pDef->id);
+	while (Table[i] != pDef)
+	{
+		if (!Table[i]) return;
+		i = (i + 1) & iMask;
+	}
+	// close the gap by moving back following entries that would not be found anymore otherwise
+	for (size_t j = (i + 1) & iMask; Table[j]; j = (j + 1) & iMask)
+	{
+		const size_t iHome = GetTableIndex(Table[j]->id);
+		if (((j - iHome) & iMask) >= ((j - i) & iMask))
+		{
+			Table[i] = Table[j];
+			i = j;
+		}
+	}
+	Table[i] = nullptr;
+}
+
 void C4DefList::Clear()
 {
 	C4Def *cdef, *next;
@@ -1200,7 +1225,7 @@ void C4DefList::Clear()
 	}
 	FirstDef = nullptr;
 	// clear quick access table
-	for (int32_t i = 0; i < 64; i++) { delete[] Table[i]; Table[i] = nullptr; }
+	Table.clear();
 	fTable = false;
 }
 
@@ -1213,20 +1238,16 @@ C4Def *C4DefList::ID2Def(C4ID id)
 		C4Def *cdef;
 		for (cdef = FirstDef; cdef; cdef = cdef->Next)
 			if (cdef->id == id) return cdef;
+		return nullptr;
 	}
-	C4Def **ppDef, ***pppDef = Table;
-	// get table entry to query
-	int32_t iTblIndex = (id >> 24) - 32;
-	if (Inside<int32_t>(iTblIndex, 0, 63)) pppDef += iTblIndex;
-	// no entry matching?
-	if (!(ppDef = *pppDef)) return nullptr;
-	// search list
-	for (C4Def *pDef = *ppDef; pDef = *ppDef; ppDef++)
+	// probe table until the ID or an empty slot is found
+	const size_t iMask = Table.size() - 1;
+	for (size_t i = GetTableIndex(id); ; i = (i + 1) & iMask)
 	{
+		C4Def *pDef = Table[i];
+		if (!pDef) return nullptr;
 		if (pDef->id == id) return pDef;
 	}
-	// none found
-	return nullptr;
 }
 
 int32_t C4DefList::GetIndex(C4ID id)
@@ -1341,7 +1362,8 @@ void C4DefList::Default()
 {
 	FirstDef = nullptr;
 	LoadFailure = false;
-	std::fill(Table, std::end(Table), nullptr);
+	Table.clear();
+	TableShift = 32;
 	fTable = false;
 }
 
@@ -1381,40 +1403,25 @@ bool C4DefList::Reload(C4Def *pDef, uint32_t dwLoadWhat, const char *szLanguage,
 
 void C4DefList::BuildTable()
 {
-	// clear any current table
-	int32_t i;
-	for (i = 0; i < 64; i++) { delete[] Table[i]; Table[i] = nullptr; }
-	// build temp count list
-	int32_t Counts[64]{};
-	C4Def *pDef;
-	for (pDef = FirstDef; pDef; pDef = pDef->Next)
-		if (LooksLikeID(pDef->id))
-			if (pDef->id < 10000)
-				Counts[0]++;
-			else
-				Counts[(pDef->id >> 24) - 32]++;
-	// get mem for table; !!! leave space for stop entry !!!
-	for (i = 0; i < 64; i++) if (Counts[i])
+	// sort list first, so the table doesn't depend on the loading order
+	SortByID();
+	// get table size: at most half filled
+	int32_t iCount = 0;
+	for (C4Def *pDef = FirstDef; pDef; pDef = pDef->Next) ++iCount;
+	size_t iSize = 16; TableShift = 28;
+	while (iSize < static_cast<size_t>(iCount) * 2) { iSize *= 2; --TableShift; }
+	Table.assign(iSize, nullptr);
+	// build table
+	const size_t iMask = iSize - 1;
+	for (C4Def *pDef = FirstDef; pDef; pDef = pDef->Next)
 	{
-		C4Def **ppDef = new C4Def*[Counts[i] + 1]{};
-		Table[i] = ppDef;
+		size_t i = GetTableIndex(pDef->id);
+		while (Table[i] && Table[i]->id != pDef->id) i = (i + 1) & iMask;
+		// first def wins for duplicate IDs
+		if (!Table[i]) Table[i] = pDef;
 	}
-	// build table
-	for (pDef = FirstDef; pDef; pDef = pDef->Next)
-		if (LooksLikeID(pDef->id))
-		{
-			C4Def **ppDef;
-			if (pDef->id < 10000)
-				ppDef = Table[0];
-			else
-				ppDef = Table[(pDef->id >> 24) - 32];
-			while (*ppDef) ppDef++;
-			*ppDef = pDef;
-		}
 	// done
 	fTable = true;
-	// use table for sorting now
-	SortByID();
 }
 
 bool C4Def::LoadPortraits(C4Group &hGroup)
@@ -1566,15 +1573,6 @@ bool C4DefList::GetFontImage(const char *szImageTag, CFacet &rOutImgFacet)
 	return true;
 }
 
-#ifdef _WIN32
-int __cdecl C4DefListSortFunc(const void *elem1, const void *elem2)
-#else
-int C4DefListSortFunc(const void *elem1, const void *elem2)
-#endif
-{
-	return (*(C4Def * const *)elem1)->id - (*(C4Def * const *)elem2)->id;
-}
-
 void C4DefList::SortByID()
 {
 	// ID sorting will prevent some possible sync losses due to definition loading in different order
@@ -1582,28 +1580,20 @@ void C4DefList::SortByID()
 	//  within the same object pack and multiple appendtos with function overloads that depend on their
 	//  order.)
 
-	// Must be called directly after quick access table has been built.
-	assert(fTable);
-	// sort all quick access slots
-	int i = sizeof(Table) / sizeof(C4Def **);
-	FirstDef = nullptr;
-	C4Def ***pppDef = Table, **ppDef, **ppDefCount, **ppCurrLastDef = &FirstDef;
-	while (i--)
+	// only defs with valid IDs are kept
+	std::vector<C4Def *> Defs;
+	for (C4Def *pDef = FirstDef; pDef; pDef = pDef->Next)
+		if (LooksLikeID(pDef->id))
+			Defs.push_back(pDef);
+	std::stable_sort(Defs.begin(), Defs.end(), [](C4Def *pDef1, C4Def *pDef2) { return pDef1->id < pDef2->id; });
+	// build new linked list from sorted defs
+	C4Def **ppCurrLastDef = &FirstDef;
+	for (C4Def *pDef : Defs)
 	{
-		// only used slots
-		if (ppDefCount = ppDef = *pppDef)
-		{
-			int cnt = 0; while (*ppDefCount++) ++cnt;
-			if (cnt)
-			{
-				qsort(ppDef, cnt, sizeof(C4Def *), &C4DefListSortFunc);
-				// build new linked list from sorted table
-				// note this method also terminates the list!
-				while (*ppCurrLastDef = *ppDef++) ppCurrLastDef = &((*ppCurrLastDef)->Next);
-			}
-		}
-		++pppDef;
+		*ppCurrLastDef = pDef;
+		ppCurrLastDef = &pDef->Next;
 	}
+	*ppCurrLastDef = nullptr;
 }
 
 #ifdef C4ENGINE
@@ -30,6 +30,8 @@
 #include <C4ScriptHost.h>
 #include <C4DefGraphics.h>
 #include "C4LangStringTable.h"
+
+#include <vector>
 #endif
 
 const int32_t C4D_None                   = 0,
@@ -381,7 +383,7 @@ public:
 
 public:
 	bool LoadFailure;
-	C4Def **Table[64]; // From space to _; some minor waste of mem
+	std::vector<C4Def *> Table; // quick access table: open addressing hash by ID; size is a power of two
 	bool fTable;
 	C4Def *FirstDef;
 
@@ -420,7 +422,11 @@ public:
 	virtual bool GetFontImage(const char *szImageTag, CFacet &rOutImgFacet);
 
 private:
-	void SortByID(); // sorts list by quick access table
+	void SortByID(); // sorts list by ID; drops defs with invalid IDs
+	size_t GetTableIndex(C4ID id) const { return (static_cast<uint32_t>(id) * 2654435769u) >> TableShift; }
+	void RemoveFromTable(C4Def *pDef);
+
+	uint32_t TableShift; // 32 - log2(Table.size())
 };
 
 // Default Action Procedures
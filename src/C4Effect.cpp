@@ -66,6 +66,7 @@ C4Effect::C4Effect(C4Object *pForObj, const char *szName, int32_t iPrio, int32_t
 	iTime = 0;
 	pCommandTarget = pCmdTarget;
 	idCommandTarget = idCmdTarget;
+	if (pForObj) pForObj->AddReference(pCmdTarget);
 	AssignCallbackFunctions();
 	// get effect target
 	C4Effect **ppEffectList = pForObj ? &pForObj->pEffects : &Game.pGlobalEffects;
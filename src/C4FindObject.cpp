@@ -157,6 +157,12 @@ C4FindObject *C4FindObject::CreateByValue(const C4Value &DataVal, C4SortObject *
 	return nullptr;
 }
 
+bool C4FindObject::PreCheck(const C4ObjectLink *pLnk)
+{
+	const C4ObjectHot &rHot = ObjectSlots.GetHot(pLnk->Slot);
+	return rHot.Status && CheckHot(rHot);
+}
+
 int32_t C4FindObject::Count(const C4ObjectList &Objs)
 {
 	// Trivial cases
@@ -167,7 +173,7 @@ int32_t C4FindObject::Count(const C4ObjectList &Objs)
 	// Count
 	int32_t iCount = 0;
 	for (C4ObjectLink *pLnk = Objs.First; pLnk; pLnk = pLnk->Next)
-		if (pLnk->Obj->Status)
+		if (PreCheck(pLnk))
 			if (Check(pLnk->Obj))
 				iCount++;
 	return iCount;
@@ -182,7 +188,7 @@ C4Object *C4FindObject::Find(const C4ObjectList &Objs)
 	// Double-check object status, as object might be deleted after Check()!
 	C4Object *pBestResult = nullptr;
 	for (C4ObjectLink *pLnk = Objs.First; pLnk; pLnk = pLnk->Next)
-		if (pLnk->Obj->Status)
+		if (PreCheck(pLnk))
 			if (Check(pLnk->Obj))
 				if (pLnk->Obj->Status)
 				{
@@ -206,7 +212,7 @@ C4ValueArray *C4FindObject::FindMany(const C4ObjectList &Objs)
 	int32_t iSize = 0;
 	// Search
 	for (C4ObjectLink *pLnk = Objs.First; pLnk; pLnk = pLnk->Next)
-		if (pLnk->Obj->Status)
+		if (PreCheck(pLnk))
 			if (Check(pLnk->Obj))
 			{
 				// Grow the array, if neccessary
@@ -248,7 +254,7 @@ int32_t C4FindObject::Count(const C4ObjectList &Objs, const C4LSectors &Sct)
 		int32_t iCount = 0;
 		for (; pLst; pLst = Area.NextObjectShapes(pLst, &pSct))
 			for (C4ObjectLink *pLnk = pLst->First; pLnk; pLnk = pLnk->Next)
-				if (pLnk->Obj->Status)
+				if (PreCheck(pLnk))
 					if (pLnk->Obj->Marker != iMarker)
 					{
 						pLnk->Obj->Marker = iMarker;
@@ -331,7 +337,7 @@ C4ValueArray *C4FindObject::FindMany(const C4ObjectList &Objs, const C4LSectors
 		uint32_t iMarker = ::Game.Objects.GetNextMarker();
 		for (; pLst; pLst = Area.NextObjectShapes(pLst, &pSct))
 			for (C4ObjectLink *pLnk = pLst->First; pLnk; pLnk = pLnk->Next)
-				if (pLnk->Obj->Status)
+				if (PreCheck(pLnk))
 					if (pLnk->Obj->Marker != iMarker)
 					{
 						pLnk->Obj->Marker = iMarker;
@@ -353,7 +359,7 @@ C4ValueArray *C4FindObject::FindMany(const C4ObjectList &Objs, const C4LSectors
 		C4LArea Area(&Game.Objects.Sectors, *pBounds); C4LSector *pSct;
 		for (C4ObjectList *pLst = Area.FirstObjects(&pSct); pLst; pLst = Area.NextObjects(pLst, &pSct))
 			for (C4ObjectLink *pLnk = pLst->First; pLnk; pLnk = pLnk->Next)
-				if (pLnk->Obj->Status)
+				if (PreCheck(pLnk))
 					if (Check(pLnk->Obj))
 					{
 						// Grow the array, if neccessary
@@ -466,6 +472,27 @@ bool C4FindObjectAnd::Check(C4Object *pObj)
 	return true;
 }
 
+bool C4FindObjectAnd::CheckHot(const C4ObjectHot &rHot)
+{
+	for (int32_t i = 0; i < iCnt; i++)
+	{
+		if (!ppConds[i]->CheckHot(rHot))
+			return false;
+		// conditions after a script call can only reject the object once the call has been made
+		if (ppConds[i]->HasCallbacks())
+			break;
+	}
+	return true;
+}
+
+bool C4FindObjectAnd::HasCallbacks()
+{
+	for (int32_t i = 0; i < iCnt; i++)
+		if (ppConds[i]->HasCallbacks())
+			return true;
+	return false;
+}
+
 bool C4FindObjectAnd::IsImpossible()
 {
 	for (int32_t i = 0; i < iCnt; i++)
@@ -528,6 +555,22 @@ bool C4FindObjectOr::Check(C4Object *pObj)
 	return false;
 }
 
+bool C4FindObjectOr::CheckHot(const C4ObjectHot &rHot)
+{
+	for (int32_t i = 0; i < iCnt; i++)
+		if (ppConds[i]->CheckHot(rHot))
+			return true;
+	return false;
+}
+
+bool C4FindObjectOr::HasCallbacks()
+{
+	for (int32_t i = 0; i < iCnt; i++)
+		if (ppConds[i]->HasCallbacks())
+			return true;
+	return false;
+}
+
 bool C4FindObjectOr::IsEnsured()
 {
 	for (int32_t i = 0; i < iCnt; i++)
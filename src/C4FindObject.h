@@ -93,9 +93,13 @@ protected:
 	virtual bool UseShapes() { return false; }
 	virtual bool IsImpossible() { return false; }
 	virtual bool IsEnsured() { return false; }
+	// quick check on the hot fields; may only return false if Check would, too
+	virtual bool CheckHot(const C4ObjectHot &rHot) { return true; }
+	virtual bool HasCallbacks() { return false; } // Check might call script functions
 
 private:
 	void CheckObjectStatus(C4ValueArray *pArray);
+	bool PreCheck(const C4ObjectLink *pLnk); // status and hot field check, without touching the object
 };
 
 // Combinators
@@ -113,6 +117,7 @@ protected:
 	virtual bool Check(C4Object *pObj);
 	virtual bool IsImpossible() { return pCond->IsEnsured(); }
 	virtual bool IsEnsured() { return pCond->IsImpossible(); }
+	virtual bool HasCallbacks() { return pCond->HasCallbacks(); }
 };
 
 class C4FindObjectAnd : public C4FindObject
@@ -132,6 +137,8 @@ protected:
 	virtual bool UseShapes() { return fUseShapes; }
 	virtual bool IsEnsured() { return !iCnt; }
 	virtual bool IsImpossible();
+	virtual bool CheckHot(const C4ObjectHot &rHot);
+	virtual bool HasCallbacks();
 };
 
 class C4FindObjectOr : public C4FindObject
@@ -150,6 +157,8 @@ protected:
 	virtual C4Rect *GetBounds() { return fHasBounds ? &Bounds : nullptr; }
 	virtual bool IsEnsured();
 	virtual bool IsImpossible() { return !iCnt; }
+	virtual bool CheckHot(const C4ObjectHot &rHot);
+	virtual bool HasCallbacks();
 };
 
 // Primitive conditions
@@ -271,6 +280,7 @@ private:
 protected:
 	virtual bool Check(C4Object *pObj);
 	virtual bool IsImpossible();
+	virtual bool CheckHot(const C4ObjectHot &rHot) { return !!(rHot.OCF & ocf); }
 };
 
 class C4FindObjectCategory : public C4FindObject
@@ -285,6 +295,7 @@ private:
 protected:
 	virtual bool Check(C4Object *pObj);
 	virtual bool IsEnsured();
+	virtual bool CheckHot(const C4ObjectHot &rHot) { return !!(rHot.Category & iCategory); }
 };
 
 class C4FindObjectAction : public C4FindObject
@@ -325,6 +336,7 @@ private:
 
 protected:
 	virtual bool Check(C4Object *pObj);
+	virtual bool CheckHot(const C4ObjectHot &rHot) { return rHot.Contained == !!pContainer; }
 };
 
 class C4FindObjectAnyContainer : public C4FindObject
@@ -334,6 +346,7 @@ public:
 
 protected:
 	virtual bool Check(C4Object *pObj);
+	virtual bool CheckHot(const C4ObjectHot &rHot) { return rHot.Contained; }
 };
 
 class C4FindObjectOwner : public C4FindObject
@@ -363,6 +376,7 @@ private:
 protected:
 	virtual bool Check(C4Object *pObj);
 	virtual bool IsImpossible();
+	virtual bool HasCallbacks() { return true; }
 };
 
 class C4FindObjectLayer : public C4FindObject
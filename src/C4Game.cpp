@@ -962,12 +962,10 @@ void C4Game::ClearObjectPtrs(C4Object *pObj)
 	// May not call Objects.ClearPointers() because that would
 	// remove pObj from primary list and pObj is to be kept
 	// until CheckObjectRemoval().
-	C4Object *cObj; C4ObjectLink *clnk;
-	for (clnk = Objects.First; clnk && (cObj = clnk->Obj); clnk = clnk->Next)
-		cObj->ClearPointers(pObj);
-	// check in inactive objects as well
-	for (clnk = Objects.InactiveObjects.First; clnk && (cObj = clnk->Obj); clnk = clnk->Next)
-		cObj->ClearPointers(pObj);
+	// Only objects that registered a reference to pObj (active
+	// or inactive) can point to it, plus the object itself.
+	pObj->ClearPointers(pObj);
+	pObj->ClearReferrers();
 	Application.SoundSystem.ClearPointers(pObj);
 }
 
@@ -3621,6 +3619,8 @@ void C4Game::Synchronize(bool fSavePlayerFiles)
 	// TransferZone synchronization: Must do this after dynamic creation to avoid synchronization loss
 	// if UpdateTransferZone-callbacks do sync-relevant changes
 	TransferZones.Synchronize();
+	// cached paths are local history
+	PathFinder.Synchronize();
 }
 
 C4Object *C4Game::FindBase(int32_t iPlayer, int32_t iIndex)
@@ -4108,6 +4108,8 @@ bool C4Game::LoadScenarioSection(const char *szSection, uint32_t dwFlags)
 	Particles.ClearParticles();
 	// clear transfer zones
 	TransferZones.Clear();
+	// forget paths through the old landscape
+	PathFinder.Synchronize();
 	// backup old sky
 	char szOldSky[C4MaxDefString + 1];
 	SCopy(C4S.Landscape.SkyDef, szOldSky, C4MaxDefString);
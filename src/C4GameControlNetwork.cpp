@@ -24,18 +24,29 @@
 #include <C4Game.h>
 #include <C4Log.h>
 
+#include <algorithm>
+
 // *** C4GameControlNetwork
 
 C4GameControlNetwork::C4GameControlNetwork(C4GameControl *pnParent)
 	: fEnabled(false), fRunning(false), iClientID(C4ClientIDUnknown),
 	fActivated(false), iTargetTick(-1),
 	iControlPreSend(1), iWaitStart(-1), iAvgControlSendTime(0), iTargetFPS(DefaultTargetFPS),
+	iControlSendTimeSample(0), iControlSendTimeCnt(0),
+	iControlSendTimePercentile(0), iControlArrivalPercentile(0), iLastControlRateChange(0),
+	iPrepareWaitTime(0), iPrepareWaitMax(0), iPrepareWaitCnt(0),
 	iControlSent(0), iControlReady(0),
-	pCtrlStack(nullptr),
+	pClients(nullptr),
+	pSyncCtrlQueue(nullptr),
 	iNextControlReqeust(0),
 	pParent(pnParent)
 {
 	assert(pParent);
+	for (int32_t i = 0; i < C4ControlRingSize; i++)
+	{
+		CtrlRing[i] = nullptr;
+		CompleteCtrl[i] = nullptr;
+	}
 }
 
 C4GameControlNetwork::~C4GameControlNetwork()
@@ -59,6 +70,8 @@ bool C4GameControlNetwork::Init(int32_t inClientID, bool fnHost, int32_t iStartT
 	// ok
 	fEnabled = true; fRunning = false;
 	iTargetFPS = DefaultTargetFPS; iNextControlReqeust = timeGetTime() + C4ControlRequestInterval;
+	iControlSendTimeSample = iControlSendTimeCnt = iControlSendTimePercentile = iControlArrivalPercentile = 0;
+	iLastControlRateChange = iStartTick;
 	return true;
 }
 
@@ -66,6 +79,7 @@ void C4GameControlNetwork::Clear() // by main thread
 {
 	fEnabled = false; fRunning = false;
 	iAvgControlSendTime = 0;
+	ClearPrepareWaitStatistic();
 	ClearCtrl(); ClearClients();
 	// clear sync control
 	SyncControl.Clear();
@@ -93,6 +107,8 @@ void C4GameControlNetwork::Execute() // by main thread
 
 bool C4GameControlNetwork::CtrlReady(int32_t iTick) // by main thread
 {
+	// already published?
+	if (iControlReady.load(std::memory_order_acquire) >= iTick) return true;
 	// check for complete control and pack it
 	CheckCompleteCtrl(false);
 	// control ready?
@@ -101,15 +117,31 @@ bool C4GameControlNetwork::CtrlReady(int32_t iTick) // by main thread
 
 bool C4GameControlNetwork::GetControl(C4Control *pCtrl, int32_t iTick) // by main thread
 {
-	// lock
-	CStdLock CtrlLock(&CtrlCSec);
 	// look for control
-	C4GameControlPacket *pPkt = getCtrl(C4ClientIDAll, iTick);
-	if (!pPkt)
-		return false;
-	// set
-	pCtrl->Clear();
-	pCtrl->Append(pPkt->getControl());
+	if (C4GameControlPacket *pPkt = getCompleteCtrl(iTick))
+	{
+		// set
+		pCtrl->Clear();
+		pCtrl->Append(pPkt->getControl());
+	}
+	else
+	{
+		// not published (yet)? lock and search
+		CStdLock CtrlLock(&CtrlCSec);
+		if (!(pPkt = getCtrl(C4ClientIDAll, iTick)))
+			return false;
+		// set
+		pCtrl->Clear();
+		pCtrl->Append(pPkt->getControl());
+	}
+	// time spent waiting in Prepare()
+	if (iWaitStart != -1)
+	{
+		int32_t iWait = timeGetTime() - iWaitStart;
+		iPrepareWaitTime += iWait;
+		iPrepareWaitMax = (std::max)(iPrepareWaitMax, iWait);
+		iPrepareWaitCnt++;
+	}
 	// calc performance
 	CalcPerformance(iTick);
 	iWaitStart = -1;
@@ -146,7 +178,8 @@ bool C4GameControlNetwork::CtrlNeeded(int32_t iFrame) const // by main thread
 {
 	if (!IsEnabled() || !fActivated) return false;
 	// check: should we send something at the moment?
-	int32_t iSendFor = pParent->getCtrlTick(iFrame + iControlPreSend);
+	// PreSend counts from the end of a control tick, so coarser ticks send control earlier
+	int32_t iSendFor = pParent->getCtrlTick(iFrame + iControlPreSend + pParent->ControlRate - 1);
 	// target tick set? do special check
 	if (iTargetTick >= 0 && iControlSent >= iTargetTick) return false;
 	// control sent for this ctrl tick?
@@ -389,6 +422,7 @@ void C4GameControlNetwork::CalcPerformance(int32_t iCtrlTick)
 	assert(CtrlReady(iCtrlTick));
 	// calc perfomance for all clients
 	int32_t iClientsPing = 0; int32_t iPingClientCount = 0; int32_t iNumTunnels = 0; int32_t iHostPing = 0;
+	int32_t iArrivalPercentile = INT32_MIN;
 	for (C4GameControlClient *pClient = pClients; pClient; pClient = pClient->pNext)
 	{
 		// Some rudimentary PreSend-calculation
@@ -416,7 +450,14 @@ void C4GameControlNetwork::CalcPerformance(int32_t iCtrlTick)
 		if (!pCtrl) continue;
 		// calc stats
 		pClient->AddPerf(pCtrl->getTime() - iWaitStart);
+		// arrival distribution of remote control (jitter buffer)
+		if (pClient->getClientID() != iClientID && iWaitStart != -1)
+		{
+			pClient->AddArrival(pCtrl->getTime() - iWaitStart);
+			iArrivalPercentile = (std::max)(iArrivalPercentile, pClient->getArrivalPercentile(C4ControlJitterPercentile));
+		}
 	}
+	iControlArrivalPercentile = iArrivalPercentile != INT32_MIN ? iArrivalPercentile : 0;
 	// Now do PreSend-calcs based on ping times
 	int32_t iControlSendTime;
 	if (eMode == CNM_Decentral)
@@ -435,10 +476,21 @@ void C4GameControlNetwork::CalcPerformance(int32_t iCtrlTick)
 	if (iControlSendTime)
 	{
 		iAvgControlSendTime = (iAvgControlSendTime * 149 + iControlSendTime * 1000) / 150;
-		// now calculate the all-time optimum PreSend there is
-		int32_t iBestPreSend = BoundBy((iTargetFPS * iAvgControlSendTime) / 1000000 + 1, 1, 15);
+		// keep the distribution, too: PreSend has to cover the slow ticks, not the average one
+		ControlSendTimes[iControlSendTimeSample] = iControlSendTime;
+		iControlSendTimeSample = (iControlSendTimeSample + 1) % C4ControlJitterSamples;
+		iControlSendTimeCnt = (std::min)(iControlSendTimeCnt + 1, C4ControlJitterSamples);
+		iControlSendTimePercentile = GetPercentile(ControlSendTimes, iControlSendTimeCnt, C4ControlJitterPercentile);
+		// the lead needed for that, plus what other clients' control has been late recently
+		// (their view of our control is assumed to be alike)
+		int32_t iLeadTime = iControlSendTimePercentile + (std::max)(iControlArrivalPercentile, 0);
+		int32_t iLeadFrames = (iTargetFPS * iLeadTime + 999) / 1000 + 1;
+		// the control tick spacing provides part of the lead already (see CtrlNeeded)
+		int32_t iBestPreSend = BoundBy(iLeadFrames - (pParent->ControlRate - 1), 1, C4MaxPreSend);
 		// fixed PreSend?
 		if (iTargetFPS <= 0) iBestPreSend = -iTargetFPS;
+		// PreSend is not enough? coarser control ticks might be
+		else AdaptControlRate(iLeadFrames);
 		// Ha! Set it!
 		if (getControlPreSend() != iBestPreSend)
 		{
@@ -448,6 +500,25 @@ void C4GameControlNetwork::CalcPerformance(int32_t iCtrlTick)
 	}
 }
 
+void C4GameControlNetwork::AdaptControlRate(int32_t iLeadFrames) // by main thread
+{
+	// host decides (sync control), and not too often
+	if (!fHost || !Config.Network.AdaptiveControlRate) return;
+	if (pParent->ControlTick < iLastControlRateChange + C4ControlRateAdaptInterval) return;
+	// never below what has been configured
+	const int32_t iMinRate = BoundBy<int32_t>(Config.Network.ControlRate, 1, C4MaxAdaptiveControlRate);
+	int32_t iBy = 0;
+	// the lead is PreSend plus ControlRate - 1 frames (see CtrlNeeded): raise the rate if
+	// even the maximum PreSend falls short, lower it if half of it would do at the lower rate
+	if (iLeadFrames > C4MaxPreSend + pParent->ControlRate - 1 && pParent->ControlRate < C4MaxAdaptiveControlRate)
+		iBy = +1;
+	else if (iLeadFrames <= C4MaxPreSend / 2 + pParent->ControlRate - 2 && pParent->ControlRate > iMinRate)
+		iBy = -1;
+	if (!iBy) return;
+	pParent->DoInput(CID_Set, new C4ControlSet(C4CVT_AutoControlRate, iBy), CDT_Decide);
+	iLastControlRateChange = pParent->ControlTick;
+}
+
 void C4GameControlNetwork::HandlePacket(char cStatus, const C4PacketBase *pPacket, C4Network2IOConnection *pConn)
 {
 	// security
@@ -546,7 +617,7 @@ void C4GameControlNetwork::HandleControlReq(const C4PacketControlReq &rPkt, C4Ne
 		// send everything we have for this tick (this is an emergency case, so efficiency
 		// isn't that important for now).
 		bool fFound = false;
-		for (pCtrl = pCtrlStack; pCtrl; pCtrl = pCtrl->pNext)
+		for (pCtrl = CtrlRing[getRingIndex(iTick)]; pCtrl; pCtrl = pCtrl->pNext)
 			if (pCtrl->getCtrlTick() == iTick)
 			{
 				pConn->Send(MkC4NetIOPacket(PID_Control, *pCtrl));
@@ -637,19 +708,36 @@ C4GameControlPacket *C4GameControlNetwork::getCtrl(int32_t iClientID, int32_t iC
 	// lock
 	CStdLock CtrlLock(&CtrlCSec);
 	// search
-	for (C4GameControlPacket *pCtrl = pCtrlStack; pCtrl; pCtrl = pCtrl->pNext)
+	for (C4GameControlPacket *pCtrl = CtrlRing[getRingIndex(iCtrlTick)]; pCtrl; pCtrl = pCtrl->pNext)
 		if (pCtrl->getClientID() == iClientID && pCtrl->getCtrlTick() == iCtrlTick)
 			return pCtrl;
 	return nullptr;
 }
 
+C4GameControlPacket *C4GameControlNetwork::getCompleteCtrl(int32_t iCtrlTick) // by main thread, no lock
+{
+	// only published control may be looked at
+	if (iCtrlTick < 0 || iControlReady.load(std::memory_order_acquire) < iCtrlTick) return nullptr;
+	C4GameControlPacket *pCtrl = CompleteCtrl[getRingIndex(iCtrlTick)].load(std::memory_order_acquire);
+	// slot might have advanced to a later tick already
+	return pCtrl && pCtrl->getCtrlTick() == iCtrlTick ? pCtrl : nullptr;
+}
+
 void C4GameControlNetwork::AddCtrl(C4GameControlPacket *pCtrl) // by both
 {
 	// lock
 	CStdLock CtrlLock(&CtrlCSec);
 	// add to list
-	pCtrl->pNext = pCtrlStack;
-	pCtrlStack = pCtrl;
+	const size_t iIndex = getRingIndex(pCtrl->getCtrlTick());
+	pCtrl->pNext = CtrlRing[iIndex];
+	CtrlRing[iIndex] = pCtrl;
+	// publish complete control
+	if (pCtrl->getClientID() == C4ClientIDAll)
+	{
+		C4GameControlPacket *pPrev = CompleteCtrl[iIndex].load(std::memory_order_relaxed);
+		if (!pPrev || pPrev->getCtrlTick() < pCtrl->getCtrlTick())
+			CompleteCtrl[iIndex].store(pCtrl, std::memory_order_release);
+	}
 }
 
 void C4GameControlNetwork::ClearCtrl(int32_t iBeforeTick) // by main thread
@@ -657,27 +745,39 @@ void C4GameControlNetwork::ClearCtrl(int32_t iBeforeTick) // by main thread
 	// lock
 	CStdLock CtrlLock(&CtrlCSec);
 	// clear all old control
-	C4GameControlPacket *pCtrl = pCtrlStack, *pLast = nullptr;
-	while (pCtrl)
+	for (int32_t i = 0; i < C4ControlRingSize; i++)
 	{
-		// old?
-		if (iBeforeTick == -1 || pCtrl->getCtrlTick() < iBeforeTick)
-		{
-			// unlink
-			C4GameControlPacket *pDelete = pCtrl;
-			pCtrl = pCtrl->pNext;
-			(pLast ? pLast->pNext : pCtrlStack) = pCtrl;
-			// delete
-			delete pDelete;
-		}
-		else
+		C4GameControlPacket *pCtrl = CtrlRing[i], *pLast = nullptr;
+		while (pCtrl)
 		{
-			pLast = pCtrl;
-			pCtrl = pCtrl->pNext;
+			// old?
+			if (iBeforeTick == -1 || pCtrl->getCtrlTick() < iBeforeTick)
+			{
+				// unlink
+				C4GameControlPacket *pDelete = pCtrl;
+				pCtrl = pCtrl->pNext;
+				(pLast ? pLast->pNext : CtrlRing[i]) = pCtrl;
+				if (CompleteCtrl[i].load(std::memory_order_relaxed) == pDelete)
+					CompleteCtrl[i].store(nullptr, std::memory_order_release);
+				// delete
+				delete pDelete;
+			}
+			else
+			{
+				pLast = pCtrl;
+				pCtrl = pCtrl->pNext;
+			}
 		}
 	}
 }
 
+int32_t C4GameControlNetwork::GetPrepareWaitStatistic(int32_t *pMax, int32_t *pCnt) const
+{
+	if (pMax) *pMax = iPrepareWaitMax;
+	if (pCnt) *pCnt = iPrepareWaitCnt;
+	return iPrepareWaitCnt ? iPrepareWaitTime / iPrepareWaitCnt : 0;
+}
+
 void C4GameControlNetwork::CheckCompleteCtrl(bool fSetEvent) // by both
 {
 	// only when running (client list may be invalid)
@@ -876,7 +976,8 @@ void C4GameControlPacket::CompileFunc(StdCompiler *pComp)
 // *** C4GameControlClient
 
 C4GameControlClient::C4GameControlClient()
-	: iClientID(C4ClientIDUnknown), iPerformance(0), iNextControl(0)
+	: iClientID(C4ClientIDUnknown), iPerformance(0), iNextControl(0),
+	iArrivalSample(0), iArrivalCnt(0)
 {
 	szName[0] = '\0';
 }
@@ -886,6 +987,29 @@ int32_t C4GameControlClient::getPerfStat() const
 	return iPerformance / 100;
 }
 
+int32_t C4GameControlClient::getArrivalPercentile(int32_t iPercent) const
+{
+	return GetPercentile(Arrivals, iArrivalCnt, iPercent);
+}
+
+void C4GameControlClient::AddArrival(int32_t iTime)
+{
+	Arrivals[iArrivalSample] = iTime;
+	iArrivalSample = (iArrivalSample + 1) % C4ControlJitterSamples;
+	iArrivalCnt = (std::min)(iArrivalCnt + 1, C4ControlJitterSamples);
+}
+
+int32_t GetPercentile(const int32_t *pSamples, int32_t iCnt, int32_t iPercent)
+{
+	if (iCnt <= 0) return 0;
+	int32_t Sorted[C4ControlJitterSamples];
+	iCnt = (std::min)(iCnt, C4ControlJitterSamples);
+	std::copy(pSamples, pSamples + iCnt, Sorted);
+	int32_t *pNth = Sorted + BoundBy((iCnt * iPercent + 99) / 100 - 1, 0, iCnt - 1);
+	std::nth_element(Sorted, pNth, Sorted + iCnt);
+	return *pNth;
+}
+
 void C4GameControlClient::Set(int32_t inClientID, const char *sznName)
 {
 	iClientID = inClientID;
@@ -23,11 +23,18 @@
 #include "C4PacketBase.h"
 #include "C4Network2.h"
 
+#include <atomic>
+
 // constants
 const int32_t C4ControlBacklog = 100, // (ctrl ticks)
               C4ClientIDAll = C4ClientIDUnknown,
               C4ControlOverflowLimit = 3, // (ctrl ticks)
-              C4MaxPreSend = 15; // (frames) - must be smaller than C4ControlBacklog!
+              C4MaxPreSend = 15, // (frames) - must be smaller than C4ControlBacklog!
+              C4ControlRingSize = 256, // (ctrl ticks) - power of two, must be bigger than C4ControlBacklog!
+              C4ControlJitterSamples = 64, // (ctrl ticks) - control timing samples kept per client
+              C4ControlJitterPercentile = 95, // control timing that PreSend should cover (%)
+              C4ControlRateAdaptInterval = 100, // (ctrl ticks) - minimum time between automatic control rate changes
+              C4MaxAdaptiveControlRate = 10;
 
 const uint32_t C4ControlRequestInterval = 2000; // (ms)
 
@@ -66,15 +73,25 @@ protected:
 	// statistics
 	int32_t iWaitStart;
 	int32_t iAvgControlSendTime;
+	int32_t ControlSendTimes[C4ControlJitterSamples], iControlSendTimeSample, iControlSendTimeCnt; // (ms)
+	int32_t iControlSendTimePercentile; // (ms)
+	int32_t iControlArrivalPercentile; // how late other clients' control arrives (ms, negative: early)
+	int32_t iLastControlRateChange; // (ctrl tick)
 	int32_t iTargetFPS; // used for PreSend-colculation
+	int32_t iPrepareWaitTime, iPrepareWaitMax, iPrepareWaitCnt; // time spent waiting for control (ms, main thread)
 
 	// control send / recv status
-	volatile int32_t iControlSent, iControlReady;
+	volatile int32_t iControlSent;
+	std::atomic<int32_t> iControlReady; // published after the complete control for the tick
 
-	// control list
-	C4GameControlPacket *pCtrlStack;
+	// control, chained by control tick (iCtrlTick % C4ControlRingSize)
+	C4GameControlPacket *CtrlRing[C4ControlRingSize];
 	CStdCSec CtrlCSec;
 
+	// complete control by control tick, readable without lock. Slots only advance to later ticks
+	// and are cleared before deletion, which never concerns the ticks the main thread asks for.
+	std::atomic<C4GameControlPacket *> CompleteCtrl[C4ControlRingSize];
+
 	// list of clients (activated only!)
 	C4GameControlClient *pClients;
 	CStdCSec ClientsCSec;
@@ -98,8 +115,14 @@ public:
 	int32_t getControlPreSend() const { return iControlPreSend; }
 	void setControlPreSend(int32_t iToVal) { iControlPreSend = (std::min)(iToVal, C4MaxPreSend); }
 	int32_t getAvgControlSendTime() const { return iAvgControlSendTime; }
+	int32_t getControlSendTimePercentile() const { return iControlSendTimePercentile; }
+	int32_t getControlArrivalPercentile() const { return iControlArrivalPercentile; }
 	void setTargetFPS(int32_t iToVal) { iTargetFPS = iToVal; }
 
+	// statistics
+	int32_t GetPrepareWaitStatistic(int32_t *pMax = nullptr, int32_t *pCnt = nullptr) const; // average (ms)
+	void ClearPrepareWaitStatistic() { iPrepareWaitTime = iPrepareWaitMax = iPrepareWaitCnt = 0; }
+
 	// main thread communication
 	bool Init(int32_t iClientID, bool fHost, int32_t iStartTick, bool fActivated, C4Network2 *pNetwork); // by main thread
 	void Clear(); // by main thread
@@ -133,6 +156,7 @@ public:
 
 	// performance
 	void CalcPerformance(int32_t iCtrlTick); // by main thread
+	void AdaptControlRate(int32_t iLeadFrames); // by main thread
 
 	// interfaces
 	void HandlePacket(char cStatus, const C4PacketBase *pPacket, C4Network2IOConnection *pConn);
@@ -155,6 +179,8 @@ protected:
 
 	// control stack
 	C4GameControlPacket *getCtrl(int32_t iClientID, int32_t iCtrlTick); // by both
+	C4GameControlPacket *getCompleteCtrl(int32_t iCtrlTick); // by main thread, no lock
+	static size_t getRingIndex(int32_t iCtrlTick) { return static_cast<uint32_t>(iCtrlTick) % C4ControlRingSize; }
 	void AddCtrl(C4GameControlPacket *pCtrl);
 	void ClearCtrl(int32_t iBeforeTick = -1);
 	void CheckCompleteCtrl(bool fSetEvent); // by both
@@ -217,6 +243,7 @@ protected:
 
 	// performance data
 	int32_t iPerformance;
+	int32_t Arrivals[C4ControlJitterSamples], iArrivalSample, iArrivalCnt; // control arrival relative to the control tick (ms)
 
 	// list (C4GameControl)
 	C4GameControlClient *pNext;
@@ -226,12 +253,16 @@ public:
 	const char *getName()        const { return szName; }
 	int32_t     getNextControl() const { return iNextControl; }
 	int32_t     getPerfStat()    const;
+	int32_t     getArrivalPercentile(int32_t iPercent) const;
 
 	void Set(int32_t iClientID, const char *szName);
 	void SetNextControl(int32_t inNextControl) { iNextControl = inNextControl; }
 	void AddPerf(int32_t iTime);
+	void AddArrival(int32_t iTime);
 };
 
+int32_t GetPercentile(const int32_t *pSamples, int32_t iCnt, int32_t iPercent);
+
 // * Packet classes *
 
 class C4PacketControlReq : public C4PacketBase
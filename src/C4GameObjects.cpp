@@ -28,6 +28,8 @@
 #include <C4Game.h>
 #include <C4Wrappers.h>
 
+#include <algorithm>
+
 C4GameObjects::C4GameObjects()
 {
 	Default();
@@ -43,6 +45,9 @@ void C4GameObjects::Default()
 	ResortProc = nullptr;
 	Sectors.Clear();
 	LastUsedMarker = 0;
+	DrawPrepared = false;
+	DrawCount = 0;
+	DrawAlways.clear();
 }
 
 void C4GameObjects::Init(int32_t iWidth, int32_t iHeight)
@@ -53,6 +58,8 @@ void C4GameObjects::Init(int32_t iWidth, int32_t iHeight)
 
 bool C4GameObjects::Add(C4Object *nObj)
 {
+	// draw order outdated
+	DrawPrepared = false;
 	// add inactive objects to the inactive list only
 	if (nObj->Status == C4OS_INACTIVE)
 		return InactiveObjects.Add(nObj, C4ObjectList::stMain);
@@ -72,6 +79,8 @@ bool C4GameObjects::Add(C4Object *nObj)
 
 bool C4GameObjects::Remove(C4Object *pObj)
 {
+	// draw order outdated; DrawAlways might point to the object
+	DrawPrepared = false;
 	// if it's an inactive object, simply remove from the inactiv elist
 	if (pObj->Status == C4OS_INACTIVE) return InactiveObjects.Remove(pObj);
 	// remove from sectors
@@ -84,6 +93,63 @@ bool C4GameObjects::Remove(C4Object *pObj)
 	return C4ObjectList::Remove(pObj);
 }
 
+void C4GameObjects::PrepareDraw()
+{
+	// number objects in draw order (last to first) and collect those that can't be found by sector
+	DrawAlways.clear();
+	int32_t iOrder = 0;
+	for (C4ObjectLink *clnk = Last; clnk; clnk = clnk->Prev)
+	{
+		C4Object *cobj = clnk->Obj;
+		cobj->ResetAudibility();
+		C4ObjectHot &rHot = ObjectSlots.GetHot(clnk->Slot);
+		rHot.DrawOrder = iOrder++;
+		const int32_t iRange = cobj->GetDrawRange();
+		rHot.DrawAlways = (iRange < 0 || iRange > C4GO_DrawMargin);
+		if (rHot.DrawAlways) DrawAlways.emplace_back(rHot.DrawOrder, cobj);
+	}
+	DrawCount = iOrder;
+	DrawPrepared = true;
+}
+
+int32_t C4GameObjects::DrawCulled(C4FacetEx &cgo, int32_t iPlayer, int32_t &riCulled)
+{
+	riCulled = 0;
+	// order outdated or debug display drawn outside the objects: draw everything
+	if (!DrawPrepared || Game.GraphicsSystem.ShowCommand)
+	{
+		Draw(cgo, iPlayer);
+		return ObjectCount();
+	}
+	// objects in sectors near the view; each object is in exactly one Objects list
+	DrawList.assign(DrawAlways.begin(), DrawAlways.end());
+	C4LArea Area(&Sectors, C4Rect(cgo.TargetX - C4GO_DrawMargin, cgo.TargetY - C4GO_DrawMargin, cgo.Wdt + 2 * C4GO_DrawMargin, cgo.Hgt + 2 * C4GO_DrawMargin));
+	C4LSector *pSct;
+	for (C4ObjectList *pLst = Area.FirstObjects(&pSct); pLst; pLst = Area.NextObjects(pLst, &pSct))
+		for (C4ObjectLink *clnk = pLst->First; clnk; clnk = clnk->Next)
+		{
+			const C4ObjectHot &rHot = ObjectSlots.GetHot(clnk->Slot);
+			if (rHot.Status && !rHot.DrawAlways)
+				DrawList.emplace_back(rHot.DrawOrder, clnk->Obj);
+		}
+	// restore list order
+	std::sort(DrawList.begin(), DrawList.end(), [](const std::pair<int32_t, C4Object *> &rObj1, const std::pair<int32_t, C4Object *> &rObj2) { return rObj1.first < rObj2.first; });
+	int32_t iDrawn = 0;
+	// Draw objects (base)
+	for (const auto &rEntry : DrawList)
+		if (!(rEntry.second->Category & C4D_BackgroundOrForeground))
+		{
+			rEntry.second->Draw(cgo, iPlayer);
+			++iDrawn;
+		}
+	// Draw objects (top face)
+	for (const auto &rEntry : DrawList)
+		if (!(rEntry.second->Category & C4D_BackgroundOrForeground))
+			rEntry.second->DrawTopFace(cgo, iPlayer);
+	riCulled = DrawCount - static_cast<int32_t>(DrawList.size());
+	return iDrawn;
+}
+
 C4ObjectList &C4GameObjects::ObjectsAt(int ix, int iy)
 {
 	return Sectors.SectorAt(ix, iy)->ObjectShapes;
@@ -94,6 +160,23 @@ void C4GameObjects::CrossCheck() // Every Tick1 by ExecObjects
 	C4Object *obj1, *obj2;
 	uint32_t ocf1, ocf2, focf, tocf;
 
+#ifdef _DEBUG
+	// the hot fields must not have missed any change
+	for (C4ObjectLink *clnk = First; clnk; clnk = clnk->Next)
+	{
+		const C4ObjectHot &rHot = ObjectSlots.GetHot(clnk->Slot);
+		assert(rHot.Obj == clnk->Obj && rHot.Status == clnk->Obj->Status && rHot.OCF == clnk->Obj->OCF);
+		assert(rHot.Category == clnk->Obj->Category && rHot.Contained == !!clnk->Obj->Contained);
+	}
+#endif
+
+	// status, containment and OCF are checked on the hot fields, so most objects are skipped without touching them
+	const auto IsFreeWithOCF = [](const C4ObjectLink *pLnk, uint32_t dwOCF)
+	{
+		const C4ObjectHot &rHot = ObjectSlots.GetHot(pLnk->Slot);
+		return rHot.Status && !rHot.Contained && (rHot.OCF & dwOCF);
+	};
+
 	// AtObject-Check: Checks for first match of obj1 at obj2
 
 	// Checks for this frame
@@ -111,33 +194,32 @@ void C4GameObjects::CrossCheck() // Every Tick1 by ExecObjects
 
 	if (focf && tocf)
 		for (C4ObjectList::iterator iter = begin(); iter != end() && (obj1 = *iter); ++iter)
-			if (obj1->Status && !obj1->Contained)
-				if (obj1->OCF & focf)
+			if (IsFreeWithOCF(iter.GetLink(), focf))
+			{
+				ocf1 = obj1->OCF; ocf2 = tocf;
+				if (obj2 = AtObject(obj1->x, obj1->y, ocf2, obj1))
 				{
-					ocf1 = obj1->OCF; ocf2 = tocf;
-					if (obj2 = AtObject(obj1->x, obj1->y, ocf2, obj1))
-					{
-						// Incineration
-						if ((ocf1 & OCF_OnFire) && (ocf2 & OCF_Inflammable))
-							if (!Random(obj2->Def->ContactIncinerate))
-							{
-								obj2->Incinerate(obj1->GetFireCausePlr(), false, obj1); continue;
-							}
-						// Fight
-						if ((ocf1 & OCF_FightReady) && (ocf2 & OCF_FightReady))
-							if (Game.Players.Hostile(obj1->Owner, obj2->Owner))
-							{
-								// RejectFight callback
-								C4AulParSet parset1(C4VObj(obj2));
-								C4AulParSet parset2(C4VObj(obj1));
-								if (obj1->Call(PSF_RejectFight, &parset1).getBool()) continue;
-								if (obj2->Call(PSF_RejectFight, &parset2).getBool()) continue;
-								ObjectActionFight(obj1, obj2);
-								ObjectActionFight(obj2, obj1);
-								continue;
-							}
-					}
+					// Incineration
+					if ((ocf1 & OCF_OnFire) && (ocf2 & OCF_Inflammable))
+						if (!Random(obj2->Def->ContactIncinerate))
+						{
+							obj2->Incinerate(obj1->GetFireCausePlr(), false, obj1); continue;
+						}
+					// Fight
+					if ((ocf1 & OCF_FightReady) && (ocf2 & OCF_FightReady))
+						if (Game.Players.Hostile(obj1->Owner, obj2->Owner))
+						{
+							// RejectFight callback
+							C4AulParSet parset1(C4VObj(obj2));
+							C4AulParSet parset2(C4VObj(obj1));
+							if (obj1->Call(PSF_RejectFight, &parset1).getBool()) continue;
+							if (obj2->Call(PSF_RejectFight, &parset2).getBool()) continue;
+							ObjectActionFight(obj1, obj2);
+							ObjectActionFight(obj2, obj1);
+							continue;
+						}
 				}
+			}
 
 	// Reverse area check: Checks for all obj2 at obj1
 
@@ -151,13 +233,13 @@ void C4GameObjects::CrossCheck() // Every Tick1 by ExecObjects
 
 	if (focf && tocf)
 		for (C4ObjectList::iterator iter = begin(); iter != end() && (obj1 = *iter); ++iter)
-			if (obj1->Status && !obj1->Contained && (obj1->OCF & focf))
+			if (IsFreeWithOCF(iter.GetLink(), focf))
 			{
 				uint32_t Marker = GetNextMarker();
 				C4LSector *pSct;
 				for (C4ObjectList *pLst = obj1->Area.FirstObjects(&pSct); pLst; pLst = obj1->Area.NextObjects(pLst, &pSct))
 					for (C4ObjectList::iterator iter2 = pLst->begin(); iter2 != pLst->end() && (obj2 = *iter2); ++iter2)
-						if (obj2->Status && !obj2->Contained && (obj2 != obj1) && (obj2->OCF & tocf))
+						if (IsFreeWithOCF(iter2.GetLink(), tocf) && (obj2 != obj1))
 							if (Inside<int32_t>(obj2->x - (obj1->x + obj1->Shape.x), 0, obj1->Shape.Wdt - 1))
 								if (Inside<int32_t>(obj2->y - (obj1->y + obj1->Shape.y), 0, obj1->Shape.Hgt - 1))
 									if (obj1->pLayer == obj2->pLayer)
@@ -501,7 +583,7 @@ void C4ObjResort::Sort(C4ObjectLink *pFirst, C4ObjectLink *pLast)
 			{
 				// so there's something to be reordered: swap the links
 				// FIXME: Inform C4ObjectList about this reorder
-				C4Object *pObj = pCurr->Obj; pCurr->Obj = pCurr2->Obj; pCurr2->Obj = pObj;
+				Game.Objects.SwapLinkObjects(pCurr, pCurr2);
 				// and readd to sector lists
 				pCurr->Obj->Unsorted = pCurr2->Obj->Unsorted = true;
 				// grow list section to scan next
@@ -627,6 +709,7 @@ int C4GameObjects::Load(C4Group &hGroup, bool fKeepInactive)
 					{
 						DebugLogF("Error in Objects.txt: Object #%d not in container #%d as referenced!", pObj2->Number, pObj->Number);
 						pObj2->Contained = pObj;
+						pObj2->SyncHotFields();
 					}
 			}
 		}
@@ -637,13 +720,7 @@ int C4GameObjects::Load(C4Group &hGroup, bool fKeepInactive)
 		cLnkNext = cLnk->Next;
 		if (cLnk->Obj->Status == C4OS_INACTIVE)
 		{
-			if (cLnk->Prev) cLnk->Prev->Next = cLnkNext; else First = cLnkNext;
-			if (cLnkNext) cLnkNext->Prev = cLnk->Prev; else Last = cLnk->Prev;
-			if (cLnk->Prev = InactiveObjects.Last)
-				InactiveObjects.Last->Next = cLnk;
-			else
-				InactiveObjects.First = cLnk;
-			InactiveObjects.Last = cLnk; cLnk->Next = nullptr;
+			TransferLink(cLnk, InactiveObjects);
 			Mass -= pObj->Mass;
 		}
 	}
@@ -743,6 +820,7 @@ void C4GameObjects::UpdatePosResort(C4Object *pObj)
 
 bool C4GameObjects::OrderObjectBefore(C4Object *pObj1, C4Object *pObj2)
 {
+	DrawPrepared = false;
 	// check that this won't screw the category sort
 	if ((pObj1->Category & C4D_SortLimit) < (pObj2->Category & C4D_SortLimit))
 		return false;
@@ -757,6 +835,7 @@ bool C4GameObjects::OrderObjectBefore(C4Object *pObj1, C4Object *pObj2)
 
 bool C4GameObjects::OrderObjectAfter(C4Object *pObj1, C4Object *pObj2)
 {
+	DrawPrepared = false;
 	// check that this won't screw the category sort
 	if ((pObj1->Category & C4D_SortLimit) > (pObj2->Category & C4D_SortLimit))
 		return false;
@@ -772,6 +851,7 @@ bool C4GameObjects::OrderObjectAfter(C4Object *pObj1, C4Object *pObj2)
 void C4GameObjects::FixObjectOrder()
 {
 	// fixes the object order so it matches the global object order sorting constraints
+	DrawPrepared = false;
 	C4ObjectLink *pLnk0 = First, *pLnkL = Last;
 	while (pLnk0 != pLnkL)
 	{
@@ -789,6 +869,7 @@ void C4GameObjects::FixObjectOrder()
 			{
 				DebugLogF("Objects.txt: Object #%d is missing sorting category!", (int)pObj->Number);
 				++pObj->Category; dwCategory = 1;
+				pObj->SyncHotFields();
 			}
 			else
 			{
@@ -799,6 +880,7 @@ void C4GameObjects::FixObjectOrder()
 					DebugLogF("Objects.txt: Object #%d has invalid sorting category %x!", (int)pObj->Number, (unsigned int)dwCategory);
 					dwCategory = (1 << i);
 					pObj->Category = (pObj->Category & ~C4D_SortLimit) | dwCategory;
+					pObj->SyncHotFields();
 				}
 			}
 			// fix order
@@ -810,8 +892,7 @@ void C4GameObjects::FixObjectOrder()
 					DebugLogF("Objects.txt: Wrong object order of #%d-#%d! (down)", (int)pObj->Number, (int)pLnkPrev->Obj->Number);
 					pLastWarnObj = pLnkPrev->Obj;
 				}
-				pLnk->Obj = pLnkPrev->Obj;
-				pLnkPrev->Obj = pObj;
+				SwapLinkObjects(pLnk, pLnkPrev);
 				pLnkLastUnsorted = pLnkPrev;
 			}
 			else
@@ -835,8 +916,7 @@ void C4GameObjects::FixObjectOrder()
 					DebugLogF("Objects.txt: Wrong object order of #%d-#%d! (up)", (int)pObj->Number, (int)pLnkPrev->Obj->Number);
 					pLastWarnObj = pLnkPrev->Obj;
 				}
-				pLnk->Obj = pLnkPrev->Obj;
-				pLnkPrev->Obj = pObj;
+				SwapLinkObjects(pLnk, pLnkPrev);
 				pLnk1stUnsorted = pLnkPrev;
 			}
 			else
@@ -888,6 +968,7 @@ void C4GameObjects::ExecuteResorts()
 {
 	// custom object sort
 	C4ObjResort *pRes = ResortProc;
+	if (pRes) DrawPrepared = false;
 	while (pRes)
 	{
 		C4ObjResort *pNextRes = pRes->Next;
@@ -23,8 +23,13 @@
 #include <C4FindObject.h>
 #include <C4Sector.h>
 
+#include <vector>
+
 class C4ObjResort;
 
+// objects drawing further than this from their position are drawn in every viewport
+const int32_t C4GO_DrawMargin = 2 * C4LSectorWdt;
+
 // main object list class
 class C4GameObjects : public C4NotifyingObjectList
 {
@@ -37,6 +42,11 @@ public:
 
 private:
 	uint32_t LastUsedMarker; // last used value for C4Object::Marker
+	bool DrawPrepared; // draw order numbers valid; reset whenever the list changes
+	int32_t DrawCount; // objects numbered by PrepareDraw
+	// draw order and object; sorting these doesn't touch the objects
+	std::vector<std::pair<int32_t, C4Object *>> DrawAlways; // objects that are drawn in every viewport
+	std::vector<std::pair<int32_t, C4Object *>> DrawList; // buffer for DrawCulled
 
 public:
 	C4LSectors Sectors; // section object lists
@@ -48,6 +58,9 @@ public:
 
 	C4ObjectList &ObjectsAt(int ix, int iy); // get object list for map pos
 
+	void PrepareDraw(); // reset audibility and number objects for DrawCulled; once per draw frame
+	int32_t DrawCulled(C4FacetEx &cgo, int32_t iPlayer, int32_t &riCulled); // draw objects near the view only; returns number of objects drawn
+
 	void CrossCheck(); // various collision-checks
 	C4Object *AtObject(int ctx, int cty, uint32_t &ocf, C4Object *exclude = nullptr); // find object at ctx/cty
 	void Synchronize(); // network synchronization
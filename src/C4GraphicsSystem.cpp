@@ -149,6 +149,9 @@ void C4GraphicsSystem::Execute()
 	// activity check
 	if (!StartDrawing()) return;
 
+	// upload texture changes of the last game ticks at once
+	if (pTexMgr) pTexMgr->FlushUploads();
+
 	bool fBGDrawn = false;
 
 	// If lobby running, message board only (page flip done by startup message board)
@@ -186,8 +189,8 @@ void C4GraphicsSystem::Execute()
 	// Screen rate skip frame draw
 	ScreenTick++; if (ScreenTick >= ScreenRate) ScreenTick = 0;
 
-	// Reset object audibility
-	Game.Objects.ResetAudibility();
+	// Reset object audibility and number objects for culled drawing
+	Game.Objects.PrepareDraw();
 
 	// some hack to ensure the mouse is drawn after a dialog close and before any
 	// movement messages
@@ -39,14 +39,120 @@
 #include <StdBitmap.h>
 #include <StdPNG.h>
 
+#include <zlib.h>
+
+#include <algorithm>
 #include <memory>
 #include <stdexcept>
+#include <thread>
+#include <vector>
 
 int32_t MVehic = MNone, MTunnel = MNone, MWater = MNone, MSnow = MNone, MEarth = MNone, MGranite = MNone;
 uint8_t MCVehic = 0;
 
 const int C4LS_MaxLightDistY = 8;
 const int C4LS_MaxLightDistX = 1;
+const int C4LS_LightSumRows = 8; // rows above and below that are summed up for lighting
+
+// landscape diff format: header, then per changed tile a tile header followed by the zlib compressed pixels
+struct C4LSDiffHeader
+{
+	uint32_t Magic, Version;
+	uint32_t Width, Height, TileSize;
+	uint32_t TileCount;
+};
+
+struct C4LSDiffTileHeader
+{
+	uint32_t Index; // tile index, row by row
+	uint32_t CompressedSize;
+};
+
+const uint32_t C4LSDiffMagic = 0x4644534c, // "LSDF"
+               C4LSDiffVersion = 1;
+const int32_t C4LS_DiffTileSize = 64;
+
+const int32_t C4LS_MaxZoomThreads = 8,
+              C4LS_MinThreadedZoomArea = 512 * 512;
+
+const int32_t C4LS_MaxLightingThreads = 8,
+              C4LS_MinLightingStripeWdt = 64,
+              C4LS_MinThreadedLightingArea = 256 * 256;
+
+// path checks use material runs if the pixels of the line fall into rows or columns at least this long
+const int32_t C4LS_MinSpanPathRun = 4;
+
+// get index of the run containing iPos
+static size_t FindSpan(const std::vector<C4LSSpan> &Spans, int32_t iPos)
+{
+	return std::upper_bound(Spans.begin(), Spans.end(), iPos, [](int32_t iPos, const C4LSSpan &Span) { return iPos < Span.Start; }) - Spans.begin() - 1;
+}
+
+static int32_t GetSpanEnd(const std::vector<C4LSSpan> &Spans, size_t i, int32_t iLength)
+{
+	return i + 1 < Spans.size() ? Spans[i + 1].Start : iLength;
+}
+
+// change material of a single pixel in a row or column
+static void SetSpanMat(std::vector<C4LSSpan> &Spans, int32_t iPos, int32_t iLength, int32_t iMat, int32_t iDens)
+{
+	const size_t i = FindSpan(Spans, iPos);
+	if (Spans[i].Mat == iMat) return;
+	const int32_t iStart = Spans[i].Start, iEnd = GetSpanEnd(Spans, i, iLength);
+	const bool fJoinPrev = iPos == iStart && i > 0 && Spans[i - 1].Mat == iMat,
+		fJoinNext = iPos + 1 == iEnd && i + 1 < Spans.size() && Spans[i + 1].Mat == iMat;
+	if (iStart + 1 == iEnd)
+	{
+		// replace single pixel run
+		Spans[i].Mat = iMat; Spans[i].Dens = iDens;
+		if (fJoinNext) Spans.erase(Spans.begin() + i + 1);
+		if (fJoinPrev) Spans.erase(Spans.begin() + i);
+	}
+	else if (iPos == iStart)
+	{
+		// cut off first pixel
+		Spans[i].Start++;
+		if (!fJoinPrev) Spans.insert(Spans.begin() + i, C4LSSpan{iPos, iMat, iDens});
+	}
+	else if (iPos + 1 == iEnd)
+	{
+		// cut off last pixel
+		if (fJoinNext) Spans[i + 1].Start--;
+		else Spans.insert(Spans.begin() + i + 1, C4LSSpan{iPos, iMat, iDens});
+	}
+	else
+	{
+		// split run
+		const C4LSSpan Rest{iPos + 1, Spans[i].Mat, Spans[i].Dens};
+		Spans.insert(Spans.begin() + i + 1, {C4LSSpan{iPos, iMat, iDens}, Rest});
+	}
+}
+
+// rescan pixels [iFrom, iTo) of a row or column; fnGetPix(iPos) returns the landscape pixel
+template<typename GetPixFunc>
+static void RebuildSpans(std::vector<C4LSSpan> &Spans, int32_t iFrom, int32_t iTo, int32_t iLength, const int32_t *pPix2Mat, const int32_t *pPix2Dens, GetPixFunc fnGetPix)
+{
+	std::vector<C4LSSpan> NewSpans;
+	NewSpans.reserve(Spans.size() + 2);
+	auto Add = [&NewSpans](int32_t iStart, int32_t iMat, int32_t iDens)
+	{
+		if (NewSpans.empty() || NewSpans.back().Mat != iMat) NewSpans.push_back(C4LSSpan{iStart, iMat, iDens});
+	};
+	// keep runs before the range
+	size_t i = 0;
+	for (; i < Spans.size() && Spans[i].Start < iFrom; ++i) Add(Spans[i].Start, Spans[i].Mat, Spans[i].Dens);
+	// scan range
+	for (int32_t iPos = iFrom; iPos < iTo; ++iPos)
+	{
+		const uint8_t byPix = fnGetPix(iPos);
+		Add(iPos, pPix2Mat[byPix], pPix2Dens[byPix]);
+	}
+	// continue with the run that contained the end of the range
+	for (; i < Spans.size() && Spans[i].Start <= iTo; ++i);
+	if (iTo < iLength) Add(iTo, Spans[i - 1].Mat, Spans[i - 1].Dens);
+	for (; i < Spans.size(); ++i) Add(Spans[i].Start, Spans[i].Mat, Spans[i].Dens);
+	Spans.swap(NewSpans);
+}
 
 C4Landscape::C4Landscape()
 {
@@ -250,9 +356,13 @@ void C4Landscape::Clear(bool fClearMapCreator, bool fClearSky)
 	// clear scan
 	ScanX = 0;
 	Mode = C4LSC_Undefined;
+	// drop pending relights
+	for (auto &relight : Relights) relight.Default();
 	// clear pixel count
 	delete[] PixCnt;         PixCnt           = nullptr;
 	PixCntPitch = 0;
+	// clear material runs
+	ColSpans.clear(); RowSpans.clear();
 }
 
 void C4Landscape::Draw(C4FacetEx &cgo, int32_t iPlayer)
@@ -275,14 +385,17 @@ int32_t C4Landscape::ChunkyRandom(int32_t &iOffset, int32_t iRange)
 	return (iOffset ^ MapSeed) % iRange;
 }
 
-void C4Landscape::DrawChunk(int32_t tx, int32_t ty, int32_t wdt, int32_t hgt, int32_t mcol, int32_t iChunkType, int32_t cro)
+void C4Landscape::DrawChunk(int32_t tx, int32_t ty, int32_t wdt, int32_t hgt, int32_t mcol, int32_t iChunkType, int32_t cro, const C4Rect *pClip)
 {
 	uint8_t top_rough; uint8_t side_rough;
 	// what to do?
 	switch (iChunkType)
 	{
 	case C4M_Flat:
-		Surface8->Box(tx, ty, tx + wdt, ty + hgt, mcol);
+		if (pClip)
+			Surface8->Box(tx, ty, tx + wdt, ty + hgt, mcol, pClip->x, pClip->y, pClip->x + pClip->Wdt - 1, pClip->y + pClip->Hgt - 1);
+		else
+			Surface8->Box(tx, ty, tx + wdt, ty + hgt, mcol);
 		return;
 	case C4M_TopFlat:
 		top_rough = 0; side_rough = 1;
@@ -306,10 +419,13 @@ void C4Landscape::DrawChunk(int32_t tx, int32_t ty, int32_t wdt, int32_t hgt, in
 	vtcs[12] = tx + wdt + ChunkyRandom(cro, rx / 2);          vtcs[13] = ty - ChunkyRandom(cro, rx / 2 * top_rough);
 	vtcs[14] = tx + wdt / 2;                                  vtcs[15] = ty - ChunkyRandom(cro, rx * top_rough);
 
-	Surface8->Polygon(8, vtcs, mcol);
+	if (pClip)
+		Surface8->Polygon(8, vtcs, mcol, pClip->x, pClip->y, pClip->x + pClip->Wdt - 1, pClip->y + pClip->Hgt - 1);
+	else
+		Surface8->Polygon(8, vtcs, mcol);
 }
 
-void C4Landscape::DrawSmoothOChunk(int32_t tx, int32_t ty, int32_t wdt, int32_t hgt, int32_t mcol, uint8_t flip, int32_t cro)
+void C4Landscape::DrawSmoothOChunk(int32_t tx, int32_t ty, int32_t wdt, int32_t hgt, int32_t mcol, uint8_t flip, int32_t cro, const C4Rect *pClip)
 {
 	int vtcs[8];
 	int32_t rx = (std::max)(wdt / 2, 1);
@@ -328,10 +444,13 @@ void C4Landscape::DrawSmoothOChunk(int32_t tx, int32_t ty, int32_t wdt, int32_t
 		vtcs[6] = tx + wdt / 2; vtcs[7] = ty + hgt / 3;
 	}
 
-	Surface8->Polygon(4, vtcs, mcol);
+	if (pClip)
+		Surface8->Polygon(4, vtcs, mcol, pClip->x, pClip->y, pClip->x + pClip->Wdt - 1, pClip->y + pClip->Hgt - 1);
+	else
+		Surface8->Polygon(4, vtcs, mcol);
 }
 
-void C4Landscape::ChunkOZoom(CSurface8 *sfcMap, int32_t iMapX, int32_t iMapY, int32_t iMapWdt, int32_t iMapHgt, int32_t iTexture, int32_t iOffX, int32_t iOffY)
+void C4Landscape::ChunkOZoom(CSurface8 *sfcMap, int32_t iMapX, int32_t iMapY, int32_t iMapWdt, int32_t iMapHgt, int32_t iTexture, int32_t iOffX, int32_t iOffY, const C4Rect *pClip)
 {
 	int32_t iX, iY, iChunkWidth, iChunkHeight, iToX, iToY;
 	int32_t iIFT;
@@ -348,8 +467,6 @@ void C4Landscape::ChunkOZoom(CSurface8 *sfcMap, int32_t iMapX, int32_t iMapY, in
 	iMapWdt = BoundBy<int32_t>(iMapWdt, 0, iMapWidth - iMapX); iMapHgt = BoundBy<int32_t>(iMapHgt, 0, iMapHeight - iMapY);
 	// get chunk size
 	iChunkWidth = MapZoom; iChunkHeight = MapZoom;
-	Surface32->Lock();
-	if (AnimationSurface) AnimationSurface->Lock();
 	// Scan map lines
 	for (iY = iMapY; iY < iMapY + iMapHgt; iY++)
 	{
@@ -370,7 +487,7 @@ void C4Landscape::ChunkOZoom(CSurface8 *sfcMap, int32_t iMapX, int32_t iMapY, in
 				// Determine IFT
 				iIFT = 0; if (byMapPixel >= 128) iIFT = IFT;
 				// Draw chunk
-				DrawChunk(iToX, iToY, iChunkWidth, iChunkHeight, byColor + iIFT, pMaterial->MapChunkType, (iX << 2) + iY);
+				DrawChunk(iToX, iToY, iChunkWidth, iChunkHeight, byColor + iIFT, pMaterial->MapChunkType, (iX << 2) + iY, pClip);
 			}
 			// Other chunk, check for slope smoothers
 			else
@@ -383,7 +500,7 @@ void C4Landscape::ChunkOZoom(CSurface8 *sfcMap, int32_t iMapX, int32_t iMapY, in
 						// Determine IFT
 						iIFT = 0; if (sfcMap->GetPix(iX - 1, iY) >= 128) iIFT = IFT;
 						// Draw smoother
-						DrawSmoothOChunk(iToX, iToY, iChunkWidth, iChunkHeight, byColor + iIFT, 0, (iX << 2) + iY);
+						DrawSmoothOChunk(iToX, iToY, iChunkWidth, iChunkHeight, byColor + iIFT, 0, (iX << 2) + iY, pClip);
 					}
 					// Same texture-material on right
 					if ((iX < iMapWidth - 1) && ((sfcMap->GetPix(iX + 1, iY) & 127) == iTexture))
@@ -391,13 +508,11 @@ void C4Landscape::ChunkOZoom(CSurface8 *sfcMap, int32_t iMapX, int32_t iMapY, in
 						// Determine IFT
 						iIFT = 0; if (sfcMap->GetPix(iX + 1, iY) >= 128) iIFT = IFT;
 						// Draw smoother
-						DrawSmoothOChunk(iToX, iToY, iChunkWidth, iChunkHeight, byColor + iIFT, 1, (iX << 2) + iY);
+						DrawSmoothOChunk(iToX, iToY, iChunkWidth, iChunkHeight, byColor + iIFT, 1, (iX << 2) + iY, pClip);
 					}
 				}
 		}
 	}
-	Surface32->Unlock();
-	if (AnimationSurface) AnimationSurface->Unlock();
 }
 
 bool C4Landscape::GetTexUsage(CSurface8 *sfcMap, int32_t iMapX, int32_t iMapY, int32_t iMapWdt, int32_t iMapHgt, uint32_t *dwpTextureUsage)
@@ -421,18 +536,45 @@ bool C4Landscape::GetTexUsage(CSurface8 *sfcMap, int32_t iMapX, int32_t iMapY, i
 
 bool C4Landscape::TexOZoom(CSurface8 *sfcMap, int32_t iMapX, int32_t iMapY, int32_t iMapWdt, int32_t iMapHgt, uint32_t *dwpTextureUsage, int32_t iToX, int32_t iToY)
 {
-	int32_t iIndex;
+	// Clip map segment like ChunkOZoom does
+	iMapX = BoundBy<int32_t>(iMapX, 0, sfcMap->Wdt - 1); iMapY = BoundBy<int32_t>(iMapY, 0, sfcMap->Hgt - 1);
+	iMapWdt = BoundBy<int32_t>(iMapWdt, 0, sfcMap->Wdt - iMapX); iMapHgt = BoundBy<int32_t>(iMapHgt, 0, sfcMap->Hgt - iMapY);
+	const C4Rect Clip(Surface8->ClipX, Surface8->ClipY, Surface8->ClipX2 - Surface8->ClipX + 1, Surface8->ClipY2 - Surface8->ClipY + 1);
+	// Chunks only depend on the map and MapSeed, so the target can be split into horizontal bands that are zoomed
+	// in parallel. Each band draws all chunks reaching into it in the same order, clipped to the band, so the result
+	// is the same as drawing everything at once.
+	const int32_t iBands = std::min<int32_t>({static_cast<int32_t>(std::thread::hardware_concurrency()), C4LS_MaxZoomThreads, Clip.Hgt / (4 * MapZoom)});
+	if (iBands <= 1 || Clip.Wdt * Clip.Hgt < C4LS_MinThreadedZoomArea)
+	{
+		TexOZoomBand(sfcMap, iMapX, iMapY, iMapWdt, iMapHgt, dwpTextureUsage, iToX, iToY, Clip);
+		return true;
+	}
+	std::vector<std::thread> workers;
+	const int32_t iBandHgt = (Clip.Hgt + iBands - 1) / iBands;
+	for (int32_t iY = Clip.y; iY < Clip.y + Clip.Hgt; iY += iBandHgt)
+	{
+		const C4Rect Band(Clip.x, iY, Clip.Wdt, std::min<int32_t>(iBandHgt, Clip.y + Clip.Hgt - iY));
+		// chunks may exceed their map pixel by up to two times the zoom
+		const int32_t iFirstRow = std::max<int32_t>(iMapY, (Band.y - iToY) / MapZoom - 3);
+		const int32_t iLastRow = std::min<int32_t>(iMapY + iMapHgt - 1, (Band.y + Band.Hgt - iToY) / MapZoom + 3);
+		if (iFirstRow > iLastRow) continue;
+		workers.emplace_back([=] { TexOZoomBand(sfcMap, iMapX, iFirstRow, iMapWdt, iLastRow - iFirstRow + 1, dwpTextureUsage, iToX, iToY, Band); });
+	}
+	for (auto &worker : workers) worker.join();
 
+	// Done
+	return true;
+}
+
+void C4Landscape::TexOZoomBand(CSurface8 *sfcMap, int32_t iMapX, int32_t iMapY, int32_t iMapWdt, int32_t iMapHgt, const uint32_t *dwpTextureUsage, int32_t iToX, int32_t iToY, const C4Rect &Clip)
+{
 	// ChunkOZoom all used textures
-	for (iIndex = 1; iIndex < C4M_MaxTexIndex; iIndex++)
+	for (int32_t iIndex = 1; iIndex < C4M_MaxTexIndex; iIndex++)
 		if (dwpTextureUsage[iIndex] > 0)
 		{
 			// ChunkOZoom map to landscape
-			ChunkOZoom(sfcMap, iMapX, iMapY, iMapWdt, iMapHgt, iIndex, iToX, iToY);
+			ChunkOZoom(sfcMap, iMapX, iMapY, iMapWdt, iMapHgt, iIndex, iToX, iToY, &Clip);
 		}
-
-	// Done
-	return true;
 }
 
 bool C4Landscape::SkyToLandscape(int32_t iToX, int32_t iToY, int32_t iToWdt, int32_t iToHgt, int32_t iOffX, int32_t iOffY)
@@ -713,6 +855,9 @@ bool C4Landscape::Init(C4Group &hGroup, bool fOverloadCurrent, bool fLoadSky, bo
 	PixCntPitch = (Height + 14) / 15;
 	PixCnt = new uint8_t[PixCntWidth * PixCntPitch];
 	UpdatePixCnt(C4Rect(0, 0, Width, Height));
+	// Create material runs
+	ColSpans.resize(Width); RowSpans.resize(Height);
+	UpdateSpans(C4Rect(0, 0, Width, Height));
 	ClearMatCount();
 	UpdateMatCnt(C4Rect(0, 0, Width, Height), true);
 
@@ -749,15 +894,21 @@ bool C4Landscape::SetPix(int32_t x, int32_t y, uint8_t npix)
 	if (npix == _GetPix(x, y))
 		return true;
 	// note for relight
-	C4Rect CheckRect(x - 2 * C4LS_MaxLightDistX, y - 2 * C4LS_MaxLightDistY, 4 * C4LS_MaxLightDistX + 1, 4 * C4LS_MaxLightDistY + 1);
+	AddRelight(C4Rect(x, y, 1, 1));
+	// set pixel
+	return _SetPix(x, y, npix);
+}
+
+void C4Landscape::AddRelight(const C4Rect &rect)
+{
+	// merge into the first relight that is close enough, so neighbouring changes are lit in one go
+	C4Rect CheckRect(rect.x - 2 * C4LS_MaxLightDistX, rect.y - 2 * C4LS_MaxLightDistY, rect.Wdt + 4 * C4LS_MaxLightDistX, rect.Hgt + 4 * C4LS_MaxLightDistY);
 	for (int32_t i = 0; i < C4LS_MaxRelights; i++)
 		if (!Relights[i].Wdt || Relights[i].Overlap(CheckRect) || i + 1 >= C4LS_MaxRelights)
 		{
-			Relights[i].Add(C4Rect(x, y, 1, 1));
+			Relights[i].Add(rect);
 			break;
 		}
-	// set pixel
-	return _SetPix(x, y, npix);
 }
 
 bool C4Landscape::SetPixDw(int32_t x, int32_t y, uint32_t dwPix)
@@ -829,8 +980,17 @@ bool C4Landscape::_SetPix(int32_t x, int32_t y, uint8_t npix)
 			}
 		}
 	}
+	// update material runs
+	if (omat != nmat && !RowSpans.empty())
+	{
+		SetSpanMat(ColSpans[x], y, Height, nmat, Pix2Dens[npix]);
+		SetSpanMat(RowSpans[y], x, Width, nmat, Pix2Dens[npix]);
+	}
 	// set 8bpp-surface only!
 	Surface8->SetPix(x, y, npix);
+	// passability changed
+	if (DensitySolid(Pix2Dens[opix]) != DensitySolid(Pix2Dens[npix]))
+		Game.PathFinder.OnLandscapeChange(x, y, !DensitySolid(Pix2Dens[npix]));
 	// success
 	return true;
 }
@@ -906,6 +1066,14 @@ int32_t C4Landscape::GetMatHeight(int32_t x, int32_t y, int32_t iYDir, int32_t i
 	if (iYDir > 0)
 	{
 		iMax = std::min<int32_t>(iMax, Height - y);
+		if (iMax > 0 && !ColSpans.empty())
+		{
+			// look up run instead
+			const std::vector<C4LSSpan> &Spans = ColSpans[x];
+			const size_t i = FindSpan(Spans, y);
+			if (Spans[i].Mat != iMat) return 0;
+			return std::min<int32_t>(iMax, GetSpanEnd(Spans, i, Height) - y);
+		}
 		for (int32_t i = 0; i < iMax; i++)
 			if (_GetMat(x, y + i) != iMat)
 				return i;
@@ -913,6 +1081,14 @@ int32_t C4Landscape::GetMatHeight(int32_t x, int32_t y, int32_t iYDir, int32_t i
 	else
 	{
 		iMax = std::min<int32_t>(iMax, y + 1);
+		if (iMax > 0 && !ColSpans.empty())
+		{
+			// look up run instead
+			const std::vector<C4LSSpan> &Spans = ColSpans[x];
+			const size_t i = FindSpan(Spans, y);
+			if (Spans[i].Mat != iMat) return 0;
+			return std::min<int32_t>(iMax, y - Spans[i].Start + 1);
+		}
 		for (int32_t i = 0; i < iMax; i++)
 			if (_GetMat(x, y - i) != iMat)
 				return i;
@@ -1096,9 +1272,24 @@ int32_t C4Landscape::AreaSolidCount(int32_t x, int32_t y, int32_t wdt, int32_t h
 {
 	int32_t cx, cy, ascnt = 0;
 	for (cy = y; cy < y + hgt; cy++)
-		for (cx = x; cx < x + wdt; cx++)
+	{
+		// count [cx1, cx2) by material runs, the rest pixel by pixel
+		int32_t cx1 = x + wdt, cx2 = x + wdt;
+		if (!RowSpans.empty() && Inside<int32_t>(cy, 0, Height - 1))
+		{
+			cx1 = BoundBy<int32_t>(x, 0, Width); cx2 = BoundBy<int32_t>(x + wdt, cx1, Width);
+			const std::vector<C4LSSpan> &Spans = RowSpans[cy];
+			for (size_t i = FindSpan(Spans, cx1); i < Spans.size() && Spans[i].Start < cx2; ++i)
+				if (DensitySolid(Spans[i].Dens))
+					ascnt += std::min<int32_t>(GetSpanEnd(Spans, i, Width), cx2) - std::max<int32_t>(Spans[i].Start, cx1);
+		}
+		for (cx = x; cx < std::min<int32_t>(cx1, x + wdt); cx++)
+			if (GBackSolid(cx, cy))
+				ascnt++;
+		for (cx = std::max<int32_t>(cx2, x); cx < x + wdt; cx++)
 			if (GBackSolid(cx, cy))
 				ascnt++;
+	}
 	return ascnt;
 }
 
@@ -1112,6 +1303,10 @@ void C4Landscape::FindMatTop(int32_t mat, int32_t &x, int32_t &y)
 
 	do
 	{
+		// Climb straight up through the material at once
+		if (!ColSpans.empty() && Inside<int32_t>(x, 0, Width - 1) && Inside<int32_t>(y, 1, Height - 1) && _GetMat(x, y) == mat)
+			y -= GetMatHeight(x, y - 1, -1, mat, y);
+
 		// Find upwards slide
 		fLeft = true; fRight = true; tslide = 0;
 		for (cslide = 0; (cslide <= mslide) && (fLeft || fRight); cslide++)
@@ -1300,49 +1495,32 @@ bool C4Landscape::FindMatPathPush(int32_t &fx, int32_t &fy, int32_t mdens, int32
 	// Right density?
 	else if (dens == mdens)
 	{
-		// Find start point for border search
-		for (int32_t i = 0; ; i++)
-			if (x - i - 1 < left || GetDensity(x - i - 1, y) != mdens)
-			{
-				x -= i; dir = L; break;
-			}
-			else if (y - i - 1 < top || GetDensity(x, y - i - 1) != mdens)
-			{
-				y -= i; dir = U; break;
-			}
-			else if (x + i + 1 > right || GetDensity(x + i + 1, y) != mdens)
-			{
-				x += i; dir = R; break;
-			}
-			else if (y + i + 1 > bottom || GetDensity(x, y + i + 1) != mdens)
-			{
-				y += i; dir = D; break;
-			}
+		// Find start point for border search: closest end of the material in any direction
+		const int32_t iL = GetDensityRun(x - 1, y, -1, 0, mdens, mdens, x - left),
+			iU = GetDensityRun(x, y - 1, 0, -1, mdens, mdens, y - top),
+			iR = GetDensityRun(x + 1, y, +1, 0, mdens, mdens, right - x),
+			iD = GetDensityRun(x, y + 1, 0, +1, mdens, mdens, bottom - y);
+		const int32_t i = std::min({iL, iU, iR, iD});
+		if (i == iL) { x -= i; dir = L; }
+		else if (i == iU) { y -= i; dir = U; }
+		else if (i == iR) { x += i; dir = R; }
+		else { y += i; dir = D; }
 	}
 	// Greater density
 	else
 	{
 		// Try to find a way out
-		int i = 1;
-		for (; i < iPushRange; i++)
-			if (GetDensity(x - i, y) <= mdens)
-			{
-				x -= i; dir = R; break;
-			}
-			else if (GetDensity(x, y - i) <= mdens)
-			{
-				y -= i; dir = D; break;
-			}
-			else if (GetDensity(x + i, y) <= mdens)
-			{
-				x += i; dir = L; break;
-			}
-			else if (GetDensity(x, y + i) <= mdens)
-			{
-				y += i; dir = U; break;
-			}
+		const int32_t iL = 1 + GetDensityRun(x - 1, y, -1, 0, mdens + 1, INT32_MAX, iPushRange - 1),
+			iU = 1 + GetDensityRun(x, y - 1, 0, -1, mdens + 1, INT32_MAX, iPushRange - 1),
+			iR = 1 + GetDensityRun(x + 1, y, +1, 0, mdens + 1, INT32_MAX, iPushRange - 1),
+			iD = 1 + GetDensityRun(x, y + 1, 0, +1, mdens + 1, INT32_MAX, iPushRange - 1);
+		const int32_t i = std::min({iL, iU, iR, iD});
 		// Not found?
 		if (i >= iPushRange) return false;
+		if (i == iL) { x -= i; dir = R; }
+		else if (i == iU) { y -= i; dir = D; }
+		else if (i == iR) { x += i; dir = L; }
+		else { y += i; dir = U; }
 		// Done?
 		if (GetDensity(x, y) < mdens)
 		{
@@ -1463,36 +1641,47 @@ bool C4Landscape::SaveDiff(C4Group &hGroup, bool fSyncSave)
 	assert(pInitial);
 	if (!pInitial) return false;
 
-	// If it shouldn't be sync-save: Clear all bytes that have not changed
-	bool fChanged = false;
-	if (!fSyncSave)
-		for (int y = 0; y < Height; y++)
-			for (int x = 0; x < Width; x++)
-				if (pInitial[y * Width + x] == _GetPix(x, y))
-					Surface8->SetPix(x, y, 0xff);
-				else
-					fChanged = true;
+	// Only tiles that differ from the initial landscape are stored, each one compressed on its own.
+	// If it should be sync-save, all tiles are stored, so the landscape can be restored completely.
+	StdBuf Diff;
+	C4LSDiffHeader Header{C4LSDiffMagic, C4LSDiffVersion, static_cast<uint32_t>(Width), static_cast<uint32_t>(Height), static_cast<uint32_t>(C4LS_DiffTileSize), 0};
+	Diff.Append(&Header, sizeof(Header));
+	const int32_t iTilesX = (Width + C4LS_DiffTileSize - 1) / C4LS_DiffTileSize, iTilesY = (Height + C4LS_DiffTileSize - 1) / C4LS_DiffTileSize;
+	StdBuf Tile; Tile.New(C4LS_DiffTileSize * C4LS_DiffTileSize);
+	StdBuf Compressed; Compressed.New(compressBound(C4LS_DiffTileSize * C4LS_DiffTileSize));
+	for (int32_t iTileY = 0; iTileY < iTilesY; ++iTileY)
+		for (int32_t iTileX = 0; iTileX < iTilesX; ++iTileX)
+		{
+			const int32_t iX = iTileX * C4LS_DiffTileSize, iY = iTileY * C4LS_DiffTileSize;
+			const int32_t iWdt = std::min<int32_t>(C4LS_DiffTileSize, Width - iX), iHgt = std::min<int32_t>(C4LS_DiffTileSize, Height - iY);
+			// unchanged?
+			bool fChanged = fSyncSave;
+			for (int32_t y = iY; y < iY + iHgt && !fChanged; ++y)
+				fChanged = !!memcmp(pInitial + y * Width + iX, Surface8->Bits + y * Surface8->Pitch + iX, iWdt);
+			if (!fChanged) continue;
+			// gather and compress tile
+			for (int32_t y = 0; y < iHgt; ++y)
+				Tile.Write(Surface8->Bits + (iY + y) * Surface8->Pitch + iX, iWdt, y * iWdt);
+			uLongf iCompressedSize = Compressed.getSize();
+			if (compress2(getMBufPtr<Bytef>(Compressed), &iCompressedSize, getBufPtr<Bytef>(Tile), iWdt * iHgt, Z_BEST_SPEED) != Z_OK)
+				return false;
+			const C4LSDiffTileHeader TileHeader{static_cast<uint32_t>(iTileY * iTilesX + iTileX), static_cast<uint32_t>(iCompressedSize)};
+			Diff.Append(&TileHeader, sizeof(TileHeader));
+			Diff.Append(Compressed.getData(), iCompressedSize);
+			++Header.TileCount;
+		}
 
-	if (fSyncSave || fChanged)
+	// remove any old diff (including the old, uncompressed format)
+	hGroup.Delete(C4CFN_DiffLandscape);
+	hGroup.Delete(C4CFN_DiffLandscapeTiles);
+	if (Header.TileCount)
 	{
-		// Save landscape surface
-		if (!Surface8->Save(Config.AtTempPath(C4CFN_TempLandscape)))
-			return false;
-
-		// Move temp file to group
-		if (!hGroup.Move(Config.AtTempPath(C4CFN_TempLandscape),
-			C4CFN_DiffLandscape))
+		Diff.Write(&Header, sizeof(Header));
+		// the buffer is handed over to the group directly
+		if (!hGroup.Add(C4CFN_DiffLandscapeTiles, Diff, false, true))
 			return false;
 	}
 
-	// Restore landscape pixels
-	if (!fSyncSave)
-		if (pInitial)
-			for (int y = 0; y < Height; y++)
-				for (int x = 0; x < Width; x++)
-					if (_GetPix(x, y) == 0xff)
-						Surface8->SetPix(x, y, pInitial[y * Width + x]);
-
 	// Save changed map, too
 	if (fMapChanged && Map)
 		if (!SaveMap(hGroup)) return false;
@@ -1609,6 +1798,9 @@ bool C4Landscape::Load(C4Group &hGroup, bool fLoadSky, bool fSavegame)
 
 bool C4Landscape::ApplyDiff(C4Group &hGroup)
 {
+	// Prefer tiled diff
+	if (hGroup.AccessEntry(C4CFN_DiffLandscapeTiles))
+		return ApplyTiledDiff(hGroup);
 	CSurface8 *pDiff;
 	// Load diff landscape from group
 	if (!hGroup.AccessEntry(C4CFN_DiffLandscape)) return false;
@@ -1625,6 +1817,47 @@ bool C4Landscape::ApplyDiff(C4Group &hGroup)
 	return true;
 }
 
+bool C4Landscape::ApplyTiledDiff(C4Group &hGroup)
+{
+	// read tiles one by one straight from the group entry
+	C4LSDiffHeader Header;
+	if (!hGroup.Read(&Header, sizeof(Header))) return false;
+	if (Header.Magic != C4LSDiffMagic || Header.Version != C4LSDiffVersion || !Header.TileSize)
+	{
+		Log("Landscape diff: unknown format");
+		return false;
+	}
+	if (Header.Width != static_cast<uint32_t>(Width) || Header.Height != static_cast<uint32_t>(Height))
+	{
+		LogF("Landscape diff: size mismatch (%ux%u instead of %dx%d)", Header.Width, Header.Height, Width, Height);
+		return false;
+	}
+	const int32_t iTileSize = Header.TileSize;
+	const int32_t iTilesX = (Width + iTileSize - 1) / iTileSize, iTilesY = (Height + iTileSize - 1) / iTileSize;
+	StdBuf Tile; Tile.New(iTileSize * iTileSize);
+	StdBuf Compressed;
+	for (uint32_t i = 0; i < Header.TileCount; ++i)
+	{
+		C4LSDiffTileHeader TileHeader;
+		if (!hGroup.Read(&TileHeader, sizeof(TileHeader))) return false;
+		if (TileHeader.Index >= static_cast<uint32_t>(iTilesX * iTilesY)) return false;
+		Compressed.New(TileHeader.CompressedSize);
+		if (!hGroup.Read(Compressed.getMData(), Compressed.getSize())) return false;
+		const int32_t iX = (TileHeader.Index % iTilesX) * iTileSize, iY = (TileHeader.Index / iTilesX) * iTileSize;
+		const int32_t iWdt = std::min<int32_t>(iTileSize, Width - iX), iHgt = std::min<int32_t>(iTileSize, Height - iY);
+		uLongf iSize = Tile.getSize();
+		if (uncompress(getMBufPtr<Bytef>(Tile), &iSize, getBufPtr<Bytef>(Compressed), Compressed.getSize()) != Z_OK || iSize != static_cast<uLongf>(iWdt * iHgt))
+			return false;
+		// material has changed here: readjust with new texture
+		const uint8_t *pTilePix = getBufPtr<uint8_t>(Tile);
+		for (int32_t y = 0; y < iHgt; ++y)
+			for (int32_t x = 0; x < iWdt; ++x, ++pTilePix)
+				if (_GetPix(iX + x, iY + y) != *pTilePix)
+					SetPix(iX + x, iY + y, *pTilePix);
+	}
+	return true;
+}
+
 void C4Landscape::Default()
 {
 	Mode = C4LSC_Undefined;
@@ -1980,7 +2213,7 @@ bool PathFreePix(int32_t x, int32_t y, int32_t par)
 
 bool PathFree(int32_t x1, int32_t y1, int32_t x2, int32_t y2, int32_t *ix, int32_t *iy)
 {
-	return ForLine(x1, y1, x2, y2, &PathFreePix, 0, ix, iy);
+	return Game.Landscape.LinePathFree(x1, y1, x2, y2, false, ix, iy);
 }
 
 bool PathFreeIgnoreVehiclePix(int32_t x, int32_t y, int32_t par)
@@ -1991,7 +2224,73 @@ bool PathFreeIgnoreVehiclePix(int32_t x, int32_t y, int32_t par)
 
 bool PathFreeIgnoreVehicle(int32_t x1, int32_t y1, int32_t x2, int32_t y2, int32_t *ix, int32_t *iy)
 {
-	return ForLine(x1, y1, x2, y2, &PathFreeIgnoreVehiclePix, 0, ix, iy);
+	return Game.Landscape.LinePathFree(x1, y1, x2, y2, true, ix, iy);
+}
+
+bool C4Landscape::LinePathFree(int32_t x1, int32_t y1, int32_t x2, int32_t y2, bool fIgnoreVehicle, int32_t *ix, int32_t *iy)
+{
+	const int32_t dx = Abs(x2 - x1), dy = Abs(y2 - y1);
+	// material runs only help for lines inside the landscape that aren't too diagonal
+	if (RowSpans.empty() || std::min(dx, dy) * C4LS_MinSpanPathRun > std::max(dx, dy)
+		|| !Inside<int32_t>(x1, 0, Width - 1) || !Inside<int32_t>(x2, 0, Width - 1)
+		|| !Inside<int32_t>(y1, 0, Height - 1) || !Inside<int32_t>(y2, 0, Height - 1))
+		return ForLine(x1, y1, x2, y2, fIgnoreVehicle ? &PathFreeIgnoreVehiclePix : &PathFreePix, 0, ix, iy);
+	// same pixels as ForLine: step along the major axis a, minor axis b
+	const bool fVertical = dx < dy;
+	int32_t a1 = fVertical ? y1 : x1, b1 = fVertical ? x1 : y1, a2 = fVertical ? y2 : x2, b2 = fVertical ? x2 : y2;
+	if (a1 > a2) { std::swap(a1, a2); std::swap(b1, b2); }
+	const int32_t bdir = (b2 > b1) ? 1 : -1, da = a2 - a1, db = Abs(b2 - b1),
+		aincr = 2 * (db - da), bincr = 2 * db;
+	int32_t d = 2 * db - da, a = a1, b = b1;
+	for (;;)
+	{
+		// all pixels up to aEnd share the minor coordinate
+		int32_t aEnd = a2;
+		if (d >= 0) aEnd = a;
+		else if (bincr) aEnd = std::min<int32_t>(a2, a + (bincr - 1 - d) / bincr);
+		// check them in one go
+		const std::vector<C4LSSpan> &Spans = fVertical ? ColSpans[b] : RowSpans[b];
+		for (size_t i = FindSpan(Spans, a); i < Spans.size() && Spans[i].Start <= aEnd; ++i)
+		{
+			const C4LSSpan &Span = Spans[i];
+			// same conditions as PathFreePix and PathFreeIgnoreVehiclePix
+			const bool fSolid = fIgnoreVehicle ? (Span.Mat != MNone && DensitySolid(Span.Mat) && Span.Mat != MVehic) : DensitySolid(Span.Dens);
+			if (fSolid)
+			{
+				const int32_t aSolid = std::max<int32_t>(Span.Start, a);
+				if (ix) *ix = fVertical ? b : aSolid;
+				if (iy) *iy = fVertical ? aSolid : b;
+				return false;
+			}
+		}
+		// next run
+		if (aEnd >= a2) return true;
+		d += (aEnd - a) * bincr + aincr;
+		a = aEnd + 1; b += bdir;
+	}
+}
+
+int32_t C4Landscape::GetDensityRun(int32_t x, int32_t y, int32_t dx, int32_t dy, int32_t iMinDens, int32_t iMaxDens, int32_t iMax)
+{
+	int32_t i = 0;
+	while (i < iMax)
+	{
+		const int32_t cx = x + i * dx, cy = y + i * dy;
+		if (RowSpans.empty() || !Inside<int32_t>(cx, 0, Width - 1) || !Inside<int32_t>(cy, 0, Height - 1))
+		{
+			// pixel by pixel outside the landscape
+			if (!Inside<int32_t>(GetDensity(cx, cy), iMinDens, iMaxDens)) return i;
+			++i;
+			continue;
+		}
+		// skip the whole run
+		const std::vector<C4LSSpan> &Spans = dx ? RowSpans[cy] : ColSpans[cx];
+		const int32_t iPos = dx ? cx : cy, iDir = dx ? dx : dy;
+		const size_t iSpan = FindSpan(Spans, iPos);
+		if (!Inside<int32_t>(Spans[iSpan].Dens, iMinDens, iMaxDens)) return i;
+		i += (iDir > 0) ? GetSpanEnd(Spans, iSpan, dx ? Width : Height) - iPos : iPos - Spans[iSpan].Start + 1;
+	}
+	return iMax;
 }
 
 int32_t TrajectoryDistance(int32_t iFx, int32_t iFy, FIXED iXDir, FIXED iYDir, int32_t iTx, int32_t iTy)
@@ -2422,6 +2721,23 @@ uint8_t C4Landscape::GetMapIndex(int32_t iX, int32_t iY)
 
 bool C4Landscape::DoRelights()
 {
+	// relights may have grown into each other since they were added: merge them
+	for (int32_t i = 0; i < C4LS_MaxRelights && Relights[i].Wdt; i++)
+	{
+		C4Rect CheckRect = Relights[i];
+		CheckRect.x -= 2 * C4LS_MaxLightDistX; CheckRect.y -= 2 * C4LS_MaxLightDistY;
+		CheckRect.Wdt += 4 * C4LS_MaxLightDistX; CheckRect.Hgt += 4 * C4LS_MaxLightDistY;
+		for (int32_t j = i + 1; j < C4LS_MaxRelights && Relights[j].Wdt; j++)
+			if (Relights[j].Overlap(CheckRect))
+			{
+				Relights[i].Add(Relights[j]);
+				// close the gap and recheck everything against the enlarged rect
+				std::copy(Relights + j + 1, Relights + C4LS_MaxRelights, Relights + j);
+				Relights[C4LS_MaxRelights - 1].Default();
+				--i;
+				break;
+			}
+	}
 	for (int32_t i = 0; i < C4LS_MaxRelights; i++)
 	{
 		if (!Relights[i].Wdt)
@@ -2462,6 +2778,7 @@ bool C4Landscape::ApplyLighting(C4Rect To)
 	// everything clipped?
 	if (To.Wdt <= 0 || To.Hgt <= 0) return true;
 
+	// clearing locks all affected textures for the rect, so the stripes below can write into them from any thread
 	if (!Surface32->Lock()) return false;
 	Surface32->ClearBoxDw(To.x, To.y, To.Wdt, To.Hgt);
 	if (AnimationSurface)
@@ -2469,60 +2786,119 @@ bool C4Landscape::ApplyLighting(C4Rect To)
 		AnimationSurface->Lock();
 		AnimationSurface->ClearBoxDw(To.x, To.y, To.Wdt, To.Hgt);
 	}
-	// do lightning
-	for (int32_t iX = To.x; iX < To.x + To.Wdt; ++iX)
+	// lighting isn't sync relevant, so large areas can be split into column stripes handled by worker threads
+	const int32_t iThreads = std::min<int32_t>({static_cast<int32_t>(std::thread::hardware_concurrency()), C4LS_MaxLightingThreads, To.Wdt / C4LS_MinLightingStripeWdt});
+	if (iThreads > 1 && To.Wdt * To.Hgt >= C4LS_MinThreadedLightingArea)
 	{
-		int AboveDensity = 0, BelowDensity = 0;
-		for (int i = 1; i <= 8; ++i)
+		std::vector<std::thread> workers;
+		const int32_t iStripeWdt = (To.Wdt + iThreads - 1) / iThreads;
+		for (int32_t iX = To.x + iStripeWdt; iX < To.x + To.Wdt; iX += iStripeWdt)
 		{
-			AboveDensity += GetPlacement(iX, To.y - i - 1);
-			BelowDensity += GetPlacement(iX, To.y + i - 1);
+			const C4Rect Stripe(iX, To.y, std::min<int32_t>(iStripeWdt, To.x + To.Wdt - iX), To.Hgt);
+			workers.emplace_back([this, Stripe] { ApplyLightingStripe(Stripe); });
 		}
-		for (int32_t iY = To.y; iY < To.y + To.Hgt; ++iY)
+		// the main thread does the first stripe itself
+		ApplyLightingStripe(C4Rect(To.x, To.y, iStripeWdt, To.Hgt));
+		for (auto &worker : workers) worker.join();
+	}
+	else
+		ApplyLightingStripe(To);
+	Surface32->Unlock();
+	if (AnimationSurface) AnimationSurface->Unlock();
+	// done
+	return true;
+}
+
+void C4Landscape::GetPlacementRow(int32_t iX, int32_t iY, int32_t iWdt, int32_t *piPlace)
+{
+	// row completely inside the landscape: read straight from the surface
+	if (iY >= 0 && iY < Height && iX >= 0 && iX + iWdt <= Width)
+	{
+		const uint8_t *pPix = Surface8->Bits + iY * Surface8->Pitch + iX;
+		for (int32_t i = 0; i < iWdt; ++i)
+			piPlace[i] = Pix2Place[pPix[i]];
+	}
+	else
+		// border pixels depend on the open sides
+		for (int32_t i = 0; i < iWdt; ++i)
+			piPlace[i] = GetPlacement(iX + i, iY);
+}
+
+void C4Landscape::ApplyLightingStripe(const C4Rect &To)
+{
+	// Lighting of a pixel depends on its horizontal neighbours and the eight pixels above and below.
+	// The placements of the 18 rows needed for the current row are kept in a ring, and the sums above
+	// and below are updated for the whole row at once, so the inner loops are free of branches and lookups.
+	const int32_t iRingRows = 2 * C4LS_LightSumRows + 2;
+	const int32_t iRowWdt = To.Wdt + 2; // one extra pixel left and right
+	std::vector<int32_t> Ring(iRingRows * iRowWdt), AboveDensity(To.Wdt), BelowDensity(To.Wdt);
+	std::vector<int32_t> Light(To.Wdt), Dark(To.Wdt);
+	std::vector<uint32_t> Clrs(To.Wdt), AnimClrs(To.Wdt);
+	const auto row = [&](int32_t iY) { return &Ring[((iY - To.y + iRingRows) % iRingRows) * iRowWdt]; };
+	// fill ring with the rows above and below the first one
+	for (int32_t iY = To.y - C4LS_LightSumRows - 1; iY < To.y + C4LS_LightSumRows; ++iY)
+		GetPlacementRow(To.x - 1, iY, iRowWdt, row(iY));
+	for (int32_t i = 1; i <= C4LS_LightSumRows; ++i)
+	{
+		const int32_t *pAbove = row(To.y - i - 1) + 1, *pBelow = row(To.y + i - 1) + 1;
+		for (int32_t iX = 0; iX < To.Wdt; ++iX)
+		{
+			AboveDensity[iX] += pAbove[iX];
+			BelowDensity[iX] += pBelow[iX];
+		}
+	}
+	for (int32_t iY = To.y; iY < To.y + To.Hgt; ++iY)
+	{
+		// the row sliding in below replaces the one sliding out above
+		GetPlacementRow(To.x - 1, iY + C4LS_LightSumRows, iRowWdt, row(iY + C4LS_LightSumRows));
+		const int32_t *pOut = row(iY - C4LS_LightSumRows - 1) + 1, *pIn = row(iY - 1) + 1;
+		const int32_t *pOwn = row(iY) + 1, *pBelowIn = row(iY + C4LS_LightSumRows) + 1;
+		for (int32_t iX = 0; iX < To.Wdt; ++iX)
 		{
-			AboveDensity -= GetPlacement(iX, iY - 9);
-			AboveDensity += GetPlacement(iX, iY - 1);
-			BelowDensity -= GetPlacement(iX, iY);
-			BelowDensity += GetPlacement(iX, iY + 8);
-			uint8_t pix = _GetPix(iX, iY);
+			AboveDensity[iX] += pIn[iX] - pOut[iX];
+			BelowDensity[iX] += pBelowIn[iX] - pOwn[iX];
+		}
+		// get density and light/dark amounts for the whole row
+		for (int32_t iX = 0; iX < To.Wdt; ++iX)
+		{
+			const int32_t iOwnDens = (2 * pOwn[iX] + pOwn[iX + 1] + pOwn[iX - 1]) / 4;
+			const int32_t iAboveDens = AboveDensity[iX] / 8, iBelowDens = BelowDensity[iX] / 8;
+			// positive values lighten, negative ones darken
+			Light[iX] = iOwnDens > iAboveDens ? std::min(30, 2 * (iOwnDens - iAboveDens))
+				: (iOwnDens < iAboveDens && iOwnDens < 30) ? -std::min(30, 2 * (iAboveDens - iOwnDens)) : 0;
+			Dark[iX] = iOwnDens > iBelowDens ? std::min(30, 2 * (iOwnDens - iBelowDens)) : 0;
+		}
+		// compose colors
+		const uint8_t *pPix = Surface8->Bits + iY * Surface8->Pitch + To.x;
+		for (int32_t iX = 0; iX < To.Wdt; ++iX)
+		{
+			const uint8_t pix = pPix[iX];
+			AnimClrs[iX] = 0xff000000;
 			// Sky
 			if (!pix)
 			{
-				Surface32->SetPixDw(iX, iY, GetClrByTex(iX, iY));
+				Clrs[iX] = GetClrByTex(To.x + iX, iY);
 				continue;
 			}
-			// get density
-			int iOwnDens = Pix2Place[pix];
-			if (!iOwnDens) continue;
-			iOwnDens *= 2;
-			iOwnDens += GetPlacement(iX + 1, iY) + GetPlacement(iX - 1, iY);
-			iOwnDens /= 4;
-			// Normal color
-			uint32_t dwBackClr = GetClrByTex(iX, iY);
-			// get density of surrounding materials
-			int iCompareDens = AboveDensity / 8;
-			if (iOwnDens > iCompareDens)
-			{
-				// apply light
-				LightenClrBy(dwBackClr, (std::min)(30, 2 * (iOwnDens - iCompareDens)));
-			}
-			else if (iOwnDens < iCompareDens && iOwnDens < 30)
+			if (!pOwn[iX])
 			{
-				DarkenClrBy(dwBackClr, (std::min)(30, 2 * (iCompareDens - iOwnDens)));
-			}
-			iCompareDens = BelowDensity / 8;
-			if (iOwnDens > iCompareDens)
-			{
-				DarkenClrBy(dwBackClr, (std::min)(30, 2 * (iOwnDens - iCompareDens)));
+				Clrs[iX] = 0xff000000;
+				continue;
 			}
-			Surface32->SetPixDw(iX, iY, dwBackClr);
-			if (AnimationSurface) AnimationSurface->SetPixDw(iX, iY, DensityLiquid(Pix2Dens[pix]) ? 255 << 24 : 0);
+			// Normal color
+			uint32_t dwBackClr = GetClrByTex(To.x + iX, iY);
+			if (Light[iX] > 0)
+				LightenClrBy(dwBackClr, Light[iX]);
+			else if (Light[iX] < 0)
+				DarkenClrBy(dwBackClr, -Light[iX]);
+			if (Dark[iX])
+				DarkenClrBy(dwBackClr, Dark[iX]);
+			Clrs[iX] = dwBackClr;
+			if (!DensityLiquid(Pix2Dens[pix])) AnimClrs[iX] = 0;
 		}
+		Surface32->SetPixDwRow(To.x, iY, To.Wdt, Clrs.data());
+		if (AnimationSurface) AnimationSurface->SetPixDwRow(To.x, iY, To.Wdt, AnimClrs.data());
 	}
-	Surface32->Unlock();
-	if (AnimationSurface) AnimationSurface->Unlock();
-	// done
-	return true;
 }
 
 uint32_t C4Landscape::GetClrByTex(int32_t iX, int32_t iY)
@@ -2723,6 +3099,8 @@ void C4Landscape::UpdatePixMaps()
 	for (i = 0; i < 256; i++) Pix2Dens[i] = MatDensity(Pix2Mat[i]);
 	for (i = 0; i < 256; i++) Pix2Place[i] = MatValid(Pix2Mat[i]) ? Game.Material.Map[Pix2Mat[i]].Placement : 0;
 	Pix2Place[0] = 0;
+	// materials of pixels may have changed
+	UpdateSpans(C4Rect(0, 0, Width, Height));
 }
 
 bool C4Landscape::Mat2Pal()
@@ -2763,8 +3141,9 @@ void C4Landscape::PrepareChange(C4Rect BoundingBox, const bool updateMatCnt)
 
 void C4Landscape::FinishChange(C4Rect BoundingBox, const bool updateMatAndPixCnt)
 {
-	// relight
-	Relight(BoundingBox);
+	// relight with the next batch
+	AddRelight(BoundingBox);
+	if (updateMatAndPixCnt) UpdateSpans(BoundingBox);
 	if (updateMatAndPixCnt) UpdateMatCnt(BoundingBox, true);
 	// Restore Solidmasks
 	C4Rect SolidMaskRect = BoundingBox;
@@ -2776,6 +3155,8 @@ void C4Landscape::FinishChange(C4Rect BoundingBox, const bool updateMatAndPixCnt
 	}
 	if (updateMatAndPixCnt) UpdatePixCnt(BoundingBox);
 	C4SolidMask::CheckConsistency();
+	// path finder
+	Game.PathFinder.OnLandscapeChange(BoundingBox);
 }
 
 void C4Landscape::UpdatePixCnt(const C4Rect &Rect, bool fCheck)
@@ -2795,6 +3176,17 @@ void C4Landscape::UpdatePixCnt(const C4Rect &Rect, bool fCheck)
 		}
 }
 
+void C4Landscape::UpdateSpans(C4Rect Rect)
+{
+	if (RowSpans.empty()) return;
+	Rect.Intersect(C4Rect(0, 0, Width, Height));
+	if (!Rect.Hgt || !Rect.Wdt) return;
+	for (int32_t x = Rect.x; x < Rect.x + Rect.Wdt; x++)
+		RebuildSpans(ColSpans[x], Rect.y, Rect.y + Rect.Hgt, Height, Pix2Mat, Pix2Dens, [this, x](int32_t y) { return _GetPix(x, y); });
+	for (int32_t y = Rect.y; y < Rect.y + Rect.Hgt; y++)
+		RebuildSpans(RowSpans[y], Rect.x, Rect.x + Rect.Wdt, Width, Pix2Mat, Pix2Dens, [this, y](int32_t x) { return _GetPix(x, y); });
+}
+
 void C4Landscape::UpdateMatCnt(C4Rect Rect, bool fPlus)
 {
 	Rect.Intersect(C4Rect(0, 0, Width, Height));
@@ -23,6 +23,8 @@
 
 #include <StdSurface8.h>
 
+#include <vector>
+
 const uint8_t GBM        = 128,
               GBM_ColNum = 64,
               IFT        = 0x80,
@@ -39,6 +41,13 @@ const int32_t C4LSC_Undefined = 0,
 
 const int32_t C4LS_MaxRelights = 50;
 
+// run of pixels of one material in a landscape row or column; ends where the next run starts
+struct C4LSSpan
+{
+	int32_t Start;
+	int32_t Mat, Dens;
+};
+
 class C4MapCreatorS2;
 
 class C4Landscape
@@ -74,6 +83,7 @@ protected:
 	int32_t PixCntPitch;
 	uint8_t *PixCnt;
 	C4Rect Relights[C4LS_MaxRelights];
+	std::vector<std::vector<C4LSSpan>> ColSpans, RowSpans; // material runs of every column and row; kept up to date with the landscape
 
 public:
 	void Default();
@@ -106,8 +116,10 @@ public:
 	bool Init(C4Group &hGroup, bool fOverloadCurrent, bool fLoadSky, bool &rfLoaded, bool fSavegame);
 	bool MapToLandscape();
 	bool ApplyDiff(C4Group &hGroup);
+	bool ApplyTiledDiff(C4Group &hGroup); // apply diff from accessed tile entry
 	bool SetMode(int32_t iMode);
 	bool SetPix(int32_t x, int32_t y, uint8_t npix); // set landscape pixel (bounds checked)
+	void AddRelight(const C4Rect &rect); // queue rect for the next DoRelights
 	bool SetPixDw(int32_t x, int32_t y, uint32_t dwPix); // set pixel how it is visible only
 	bool _SetPix(int32_t x, int32_t y, uint8_t npix); // set landsape pixel (bounds not checked)
 	bool _SetPixIfMask(int32_t x, int32_t y, uint8_t npix, uint8_t nMask); // set landscape pixel, if it matches nMask color (no bound-checks)
@@ -181,6 +193,7 @@ public:
 
 	inline int32_t GetPixMat(uint8_t byPix) { return Pix2Mat[byPix]; }
 	bool _PathFree(int32_t x, int32_t y, int32_t x2, int32_t y2); // quickly checks wether there *might* be pixel in the path.
+	bool LinePathFree(int32_t x1, int32_t y1, int32_t x2, int32_t y2, bool fIgnoreVehicle, int32_t *ix, int32_t *iy); // exact path check; see PathFree
 	int32_t GetMatHeight(int32_t x, int32_t y, int32_t iYDir, int32_t iMat, int32_t iMax);
 	int32_t DigFreePix(int32_t tx, int32_t ty);
 	int32_t ShakeFreePix(int32_t tx, int32_t ty);
@@ -210,11 +223,12 @@ protected:
 	void ExecuteScan();
 	int32_t DoScan(int32_t x, int32_t y, int32_t mat, int32_t dir);
 	int32_t ChunkyRandom(int32_t &iOffset, int32_t iRange); // return static random value, according to offset and MapSeed
-	void DrawChunk(int32_t tx, int32_t ty, int32_t wdt, int32_t hgt, int32_t mcol, int32_t iChunkType, int32_t cro);
-	void DrawSmoothOChunk(int32_t tx, int32_t ty, int32_t wdt, int32_t hgt, int32_t mcol, uint8_t flip, int32_t cro);
-	void ChunkOZoom(CSurface8 *sfcMap, int32_t iMapX, int32_t iMapY, int32_t iMapWdt, int32_t iMapHgt, int32_t iTexture, int32_t iOffX = 0, int32_t iOffY = 0);
+	void DrawChunk(int32_t tx, int32_t ty, int32_t wdt, int32_t hgt, int32_t mcol, int32_t iChunkType, int32_t cro, const C4Rect *pClip = nullptr);
+	void DrawSmoothOChunk(int32_t tx, int32_t ty, int32_t wdt, int32_t hgt, int32_t mcol, uint8_t flip, int32_t cro, const C4Rect *pClip = nullptr);
+	void ChunkOZoom(CSurface8 *sfcMap, int32_t iMapX, int32_t iMapY, int32_t iMapWdt, int32_t iMapHgt, int32_t iTexture, int32_t iOffX = 0, int32_t iOffY = 0, const C4Rect *pClip = nullptr);
 	bool GetTexUsage(CSurface8 *sfcMap, int32_t iMapX, int32_t iMapY, int32_t iMapWdt, int32_t iMapHgt, uint32_t *dwpTextureUsage);
 	bool TexOZoom(CSurface8 *sfcMap, int32_t iMapX, int32_t iMapY, int32_t iMapWdt, int32_t iMapHgt, uint32_t *dwpTextureUsage, int32_t iToX = 0, int32_t iToY = 0);
+	void TexOZoomBand(CSurface8 *sfcMap, int32_t iMapX, int32_t iMapY, int32_t iMapWdt, int32_t iMapHgt, const uint32_t *dwpTextureUsage, int32_t iToX, int32_t iToY, const C4Rect &Clip); // may run on worker threads
 	bool MapToSurface(CSurface8 *sfcMap, int32_t iMapX, int32_t iMapY, int32_t iMapWdt, int32_t iMapHgt, int32_t iToX, int32_t iToY, int32_t iToWdt, int32_t iToHgt, int32_t iOffX, int32_t iOffY);
 	bool MapToLandscape(CSurface8 *sfcMap, int32_t iMapX, int32_t iMapY, int32_t iMapWdt, int32_t iMapHgt, int32_t iOffsX = 0, int32_t iOffsY = 0); // zoom map segment to surface (or sector surfaces)
 	bool GetMapColorIndex(const char *szMaterial, const char *szTexture, bool fIFT, uint8_t &rbyCol);
@@ -223,6 +237,8 @@ protected:
 	CSurface8 *CreateMapS2(C4Group &ScenFile); // create map by def file
 	bool Relight(C4Rect To);
 	bool ApplyLighting(C4Rect To);
+	void ApplyLightingStripe(const C4Rect &To); // light rect with locked surfaces; may run on worker threads
+	void GetPlacementRow(int32_t iX, int32_t iY, int32_t iWdt, int32_t *piPlace); // get placements of a pixel row (bounds checked)
 	uint32_t GetClrByTex(int32_t iX, int32_t iY);
 	bool Mat2Pal(); // assign material colors to landscape palette
 
@@ -233,6 +249,8 @@ protected:
 	}
 
 	void UpdatePixCnt(const class C4Rect &Rect, bool fCheck = false);
+	void UpdateSpans(C4Rect Rect); // rebuild material runs of all columns and rows crossing rect
+	int32_t GetDensityRun(int32_t x, int32_t y, int32_t dx, int32_t dy, int32_t iMinDens, int32_t iMaxDens, int32_t iMax); // count pixels from (x, y) with density in range (bounds checked)
 	void UpdateMatCnt(C4Rect Rect, bool fPlus);
 	void PrepareChange(C4Rect BoundingBox, bool updateMatCnt = true);
 	void FinishChange(C4Rect BoundingBox, bool updateMatAndPixCnt = true);
@@ -30,6 +30,16 @@
 #include <C4Texture.h>
 #endif
 
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+const int32_t C4MC_MaxRenderThreads = 8,
+              C4MC_MinRenderBandHgt = 16,
+              C4MC_MinThreadedRenderArea = 256 * 256;
+
+bool AlgoScript(C4MCOverlay *pOvrl, int32_t iX, int32_t iY);
+
 // C4MCCallbackArray
 
 C4MCCallbackArray::C4MCCallbackArray(C4AulFunc *pSFunc, C4MapCreatorS2 *pMapCreator)
@@ -550,6 +560,17 @@ bool C4MCOverlay::RenderPix(int32_t iX, int32_t iY, uint8_t &rPix, C4MCTokenType
 	return DoSet;
 }
 
+bool C4MCOverlay::CanRenderInParallel()
+{
+	// scripts and callbacks must be executed on the main thread
+	if ((Algorithm && Algorithm->Function == &AlgoScript) || pEvaluateFunc || pDrawFunc) return false;
+	// check children
+	for (C4MCNode *pChild = Child0; pChild; pChild = pChild->Next)
+		if (C4MCOverlay *pOvrl = pChild->Overlay())
+			if (!pOvrl->CanRenderInParallel()) return false;
+	return true;
+}
+
 bool C4MCOverlay::PeekPix(int32_t iX, int32_t iY)
 {
 	// start with this one
@@ -645,6 +666,21 @@ bool C4MCMap::RenderTo(uint8_t *pToBuf, int32_t iPitch)
 {
 	// set current render target
 	if (MapCreator) MapCreator->pCurrentMap = this;
+	// Rendering only depends on the overlay tree and the overlay seeds, so without script algorithms and callbacks,
+	// the map can be split into bands that are rendered in parallel, giving the same result.
+	const int32_t iBands = (std::min)({static_cast<int32_t>(std::thread::hardware_concurrency()), C4MC_MaxRenderThreads, Hgt / C4MC_MinRenderBandHgt});
+#ifndef DEBUGREC
+	if (iBands > 1 && Wdt * Hgt >= C4MC_MinThreadedRenderArea && CanRenderInParallel())
+	{
+		std::vector<std::thread> workers;
+		const int32_t iBandHgt = (Hgt + iBands - 1) / iBands;
+		for (int32_t iY = 0; iY < Hgt; iY += iBandHgt)
+			workers.emplace_back([=] { RenderBand(pToBuf + iY * iPitch, iPitch, iY, (std::min)(iBandHgt, Hgt - iY)); });
+		for (auto &worker : workers) worker.join();
+		if (MapCreator) MapCreator->pCurrentMap = nullptr;
+		return true;
+	}
+#endif
 	// draw pixel by pixel
 	for (int32_t iY = 0; iY < Hgt; iY++)
 	{
@@ -671,6 +707,23 @@ bool C4MCMap::RenderTo(uint8_t *pToBuf, int32_t iPitch)
 	return true;
 }
 
+void C4MCMap::RenderBand(uint8_t *pToBuf, int32_t iPitch, int32_t iY, int32_t iHgt)
+{
+	// like RenderTo, but without callbacks
+	for (int32_t iEndY = iY + iHgt; iY < iEndY; iY++)
+	{
+		for (int32_t iX = 0; iX < Wdt; iX++)
+		{
+			// default to sky
+			pToBuf[iX] = 0;
+			// render pixel value
+			RenderPix(iX, iY, pToBuf[iX], MCT_NONE, false, true);
+		}
+		// next line
+		pToBuf += iPitch;
+	}
+}
+
 void C4MCMap::SetSize(int32_t iWdt, int32_t iHgt)
 {
 	// store new size
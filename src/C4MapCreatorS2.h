@@ -284,6 +284,7 @@ public:
 
 	bool CheckMask(int32_t iX, int32_t iY); // check whether algorithms succeeds at iX/iY
 	bool RenderPix(int32_t iX, int32_t iY, uint8_t &rPix, C4MCTokenType eLastOp = MCT_NONE, bool fLastSet = false, bool fDraw = true, C4MCOverlay **ppPixelSetOverlay = nullptr); // render this pixel
+	bool CanRenderInParallel(); // whether this overlay and its children may be rendered by multiple threads at once
 	bool PeekPix(int32_t iX, int32_t iY); // check mask; regard operator chain
 	bool InBounds(int32_t iX, int32_t iY) { return iX >= X && iY >= Y && iX < X + Wdt && iY < Y + Hgt; } // return whether point iX/iY is inside bounds
 
@@ -334,6 +335,11 @@ protected:
 
 public:
 	bool RenderTo(uint8_t *pToBuf, int32_t iPitch); // render to buffer
+
+protected:
+	void RenderBand(uint8_t *pToBuf, int32_t iPitch, int32_t iY, int32_t iHgt); // render rows without callbacks; may run on worker threads
+
+public:
 	void SetSize(int32_t iWdt, int32_t iHgt);
 
 public:
@@ -408,6 +408,7 @@ bool C4Menu::AddItem(C4MenuItem *pNew, const char *szCaption, const char *szComm
 		if (szCommand2) AddDbgRec(RCT_MenuAddC, szCommand2, strlen(szCommand2) + 1);
 	}
 #endif
+	if (pObject) OnItemObject(pObject);
 	// Add it to the list
 	pClientWindow->AddElement(pNew);
 	// first menuitem is portrait, if it does not have text but a facet
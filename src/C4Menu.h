@@ -176,6 +176,7 @@ public:
 	C4MenuItem *GetSelectedItem();
 	C4MenuItem *GetItem(int32_t iIndex);
 	virtual C4Object *GetParentObject() { return nullptr; }
+	virtual void OnItemObject(C4Object *pObj) {} // an item referring to pObj has been added
 	bool MoveSelection(int32_t iBy, bool fAdjustPosition, bool fDoCalls);
 	bool SetSelection(int32_t iSelection, bool fAdjustPosition, bool fDoCalls);
 	bool SetPosition(int32_t iPosition);
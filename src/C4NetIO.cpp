@@ -21,6 +21,7 @@
 #include "C4Constants.h"
 #include "C4Config.h"
 
+#include <algorithm>
 #include <assert.h>
 #include <errno.h>
 #include <fcntl.h>
@@ -55,6 +56,11 @@
 #define IPV6_DROP_MEMBERSHIP IPV6_LEAVE_GROUP
 #endif
 
+// batched datagram i/o
+#ifdef __linux__
+#define C4NETIO_USE_MMSG
+#endif
+
 #ifdef __linux__
 #include <linux/in6.h>
 #include <linux/if_addr.h>
@@ -70,6 +76,12 @@
 // constants definition
 const int C4NetIO::TO_INF = -1;
 
+#ifdef C4NETIO_USE_MMSG
+// datagrams per recvmmsg/sendmmsg call and receive buffer size per datagram
+const unsigned int C4NetIO_MaxBatchCnt = 16;
+const size_t C4NetIO_MaxBatchMsgSize = 65536;
+#endif
+
 // simulate packet loss (loss probability in percent)
 // #define C4NETIO_SIMULATE_PACKETLOSS 10
 
@@ -829,15 +841,56 @@ C4NetIOPacket::C4NetIOPacket(const void *pnData, size_t inSize, bool fCopy, cons
 C4NetIOPacket::C4NetIOPacket(const StdBuf &Buf, const C4NetIO::addr_t &naddr)
 	: StdBuf(Buf), addr(naddr) {}
 
+C4NetIOPacket::C4NetIOPacket(const C4NetIOPacket &Pkt2)
+	: StdBuf(Pkt2, !Pkt2.isShared()), addr(Pkt2.addr), SharedData(Pkt2.SharedData) {}
+
+C4NetIOPacket::C4NetIOPacket(C4NetIOPacket &&Pkt2)
+	: StdBuf(std::move(Pkt2)), addr(Pkt2.addr), SharedData(std::move(Pkt2.SharedData)) {}
+
+C4NetIOPacket &C4NetIOPacket::operator=(const C4NetIOPacket &Pkt2)
+{
+	if (this == &Pkt2) return *this;
+	if (Pkt2.isShared())
+		Ref(Pkt2);
+	else
+		Copy(Pkt2);
+	addr = Pkt2.addr;
+	SharedData = Pkt2.SharedData;
+	return *this;
+}
+
+C4NetIOPacket &C4NetIOPacket::operator=(C4NetIOPacket &&Pkt2)
+{
+	if (this == &Pkt2) return *this;
+	StdBuf::operator=(std::move(Pkt2));
+	addr = Pkt2.addr;
+	SharedData = std::move(Pkt2.SharedData);
+	return *this;
+}
+
 C4NetIOPacket::~C4NetIOPacket()
 {
 	Clear();
 }
 
+void C4NetIOPacket::Share()
+{
+	if (SharedData) return;
+	// move (or copy) data into the shared buffer, then reference it
+	auto pData = std::make_shared<StdBuf>();
+	if (isRef())
+		pData->Copy(*this);
+	else
+		pData->Take(*this);
+	Ref(*pData);
+	SharedData = std::move(pData);
+}
+
 void C4NetIOPacket::Clear()
 {
 	addr = C4NetIO::addr_t();
 	StdBuf::Clear();
+	SharedData.reset();
 }
 
 // *** C4NetIOTCP
@@ -1430,10 +1483,13 @@ int C4NetIOTCP::GetTimeout() // (mt-safe)
 	return TO_INF;
 }
 
-bool C4NetIOTCP::GetStatistic(int *pBroadcastRate) // (mt-safe)
+bool C4NetIOTCP::GetStatistic(int *pBroadcastRate, int *pRecvBatch, int *pSendBatch) // (mt-safe)
 {
 	// no broadcast
 	if (pBroadcastRate) *pBroadcastRate = 0;
+	// no datagrams
+	if (pRecvBatch) *pRecvBatch = 0;
+	if (pSendBatch) *pSendBatch = 0;
 	return true;
 }
 
@@ -1961,6 +2017,15 @@ bool C4NetIOSimpleUDP::Init(uint16_t inPort)
 		return false;
 	}
 
+#if defined(IP_PMTUDISC_PROBE) && defined(IPV6_PMTUDISC_PROBE)
+	// Never let datagrams get fragmented on their way, so probing for
+	// bigger fragment sizes (see C4NetIOUDP::Peer::Probe) gives reliable results.
+	// No error handling - without it, probing is merely too optimistic for IPv4.
+	constexpr int optPMTUDisc{IP_PMTUDISC_PROBE}, optPMTUDisc6{IPV6_PMTUDISC_PROBE};
+	::setsockopt(sock, IPPROTO_IP, IP_MTU_DISCOVER, reinterpret_cast<const char *>(&optPMTUDisc), sizeof(optPMTUDisc));
+	::setsockopt(sock, IPPROTO_IPV6, IPV6_MTU_DISCOVER, reinterpret_cast<const char *>(&optPMTUDisc6), sizeof(optPMTUDisc6));
+#endif
+
 	// bind socket
 	iPort = inPort;
 	const addr_t naddr{addr_t::Any, iPort};
@@ -2141,6 +2206,51 @@ bool C4NetIOSimpleUDP::Execute(int iMaxTime)
 	if (eWR == WR_Cancelled || eWR == WR_Timeout) return true;
 	assert(eWR == WR_Readable);
 
+#ifdef C4NETIO_USE_MMSG
+	// read as many packets as possible per call
+	if (!RecvBatchBuf.getSize()) RecvBatchBuf.New(C4NetIO_MaxBatchCnt * C4NetIO_MaxBatchMsgSize);
+	for (;;)
+	{
+		mmsghdr Msgs[C4NetIO_MaxBatchCnt]; iovec Vecs[C4NetIO_MaxBatchCnt]; addr_t SrcAddrs[C4NetIO_MaxBatchCnt];
+		for (unsigned int i = 0; i < C4NetIO_MaxBatchCnt; i++)
+		{
+			Vecs[i].iov_base = getMBufPtr<char>(RecvBatchBuf, i * C4NetIO_MaxBatchMsgSize);
+			Vecs[i].iov_len = C4NetIO_MaxBatchMsgSize;
+			Msgs[i].msg_hdr = msghdr{};
+			Msgs[i].msg_hdr.msg_name = static_cast<sockaddr *>(&SrcAddrs[i]);
+			Msgs[i].msg_hdr.msg_namelen = sizeof(sockaddr_in6);
+			Msgs[i].msg_hdr.msg_iov = &Vecs[i];
+			Msgs[i].msg_hdr.msg_iovlen = 1;
+		}
+		const int iMsgCnt = ::recvmmsg(sock, Msgs, C4NetIO_MaxBatchCnt, MSG_DONTWAIT, nullptr);
+		if (iMsgCnt == SOCKET_ERROR)
+		{
+			// nothing left?
+			if (HaveWouldBlockError()) return true;
+			// otherwise, let the single packet path handle the error
+			break;
+		}
+		iRecvCalls++; iRecvPackets += iMsgCnt;
+		for (int i = 0; i < iMsgCnt; i++)
+		{
+			const msghdr &Hdr = Msgs[i].msg_hdr;
+			// invalid address?
+			if ((Hdr.msg_namelen != sizeof(sockaddr_in) && Hdr.msg_namelen != sizeof(sockaddr_in6)) || SrcAddrs[i].GetFamily() == addr_t::UnknownFamily)
+			{
+				SetError("recvmmsg returned an invalid address");
+				return false;
+			}
+			// empty or truncated? ignore
+			if (!Msgs[i].msg_len || (Hdr.msg_flags & MSG_TRUNC)) continue;
+			// callback
+			C4NetIOPacket Pkt(Vecs[i].iov_base, Msgs[i].msg_len, false, SrcAddrs[i]);
+			if (pCB) pCB->OnPacket(Pkt, this);
+		}
+		// socket drained?
+		if (iMsgCnt < int(C4NetIO_MaxBatchCnt)) return true;
+	}
+#endif
+
 	// read packets from socket
 	for (;;)
 	{
@@ -2194,6 +2304,7 @@ bool C4NetIOSimpleUDP::Execute(int iMaxTime)
 		// fill in packet information
 		Pkt.SetSize(iMsgSize);
 		Pkt.SetAddr(SrcAddr);
+		iRecvCalls++; iRecvPackets++;
 		// callback
 		if (pCB) pCB->OnPacket(Pkt, this);
 	}
@@ -2208,6 +2319,7 @@ bool C4NetIOSimpleUDP::Send(const C4NetIOPacket &rPacket)
 
 	// send it
 	C4NetIO::addr_t addr = rPacket.getAddr();
+	iSendCalls++; iSendPackets++;
 	if (::sendto(sock, getBufPtr<char>(rPacket), rPacket.getSize(), 0,
 		&addr, addr.GetAddrLen())
 		!= int(rPacket.getSize()) &&
@@ -2222,6 +2334,62 @@ bool C4NetIOSimpleUDP::Send(const C4NetIOPacket &rPacket)
 	return true;
 }
 
+bool C4NetIOSimpleUDP::SendBatch(const C4NetIOPacket *pPackets, size_t iCnt, std::vector<size_t> *pFailed)
+{
+	if (!fInit) { SetError("not yet initialized"); return false; }
+
+	bool fSuccess = true;
+#ifdef C4NETIO_USE_MMSG
+	for (size_t iPos = 0; iPos < iCnt; )
+	{
+		// set up messages
+		const unsigned int iMsgCnt = std::min<size_t>(iCnt - iPos, C4NetIO_MaxBatchCnt);
+		mmsghdr Msgs[C4NetIO_MaxBatchCnt]; iovec Vecs[C4NetIO_MaxBatchCnt]; addr_t Addrs[C4NetIO_MaxBatchCnt];
+		for (unsigned int i = 0; i < iMsgCnt; i++)
+		{
+			Addrs[i] = pPackets[iPos + i].getAddr();
+			Vecs[i].iov_base = const_cast<void *>(pPackets[iPos + i].getData());
+			Vecs[i].iov_len = pPackets[iPos + i].getSize();
+			Msgs[i].msg_hdr = msghdr{};
+			Msgs[i].msg_hdr.msg_name = static_cast<sockaddr *>(&Addrs[i]);
+			Msgs[i].msg_hdr.msg_namelen = Addrs[i].GetAddrLen();
+			Msgs[i].msg_hdr.msg_iov = &Vecs[i];
+			Msgs[i].msg_hdr.msg_iovlen = 1;
+		}
+		// send them
+		int iSent = ::sendmmsg(sock, Msgs, iMsgCnt, 0);
+		iSendCalls++;
+		if (iSent == SOCKET_ERROR)
+		{
+			// the first message failed (the ones before it went out with the last call): skip it
+			// a packet that would block is dropped, like Send does
+			if (!HaveWouldBlockError())
+			{
+				SetError("socket sendmmsg failed", true);
+				if (pFailed) pFailed->push_back(iPos);
+				fSuccess = false;
+			}
+			iSent = 1;
+		}
+		else
+			iSendPackets += iSent;
+		iPos += iSent;
+	}
+#else
+	// no batched i/o: send one by one
+	for (size_t i = 0; i < iCnt; i++)
+		if (!C4NetIOSimpleUDP::Send(pPackets[i]))
+		{
+			if (pFailed) pFailed->push_back(i);
+			fSuccess = false;
+		}
+#endif
+
+	// ok?
+	if (fSuccess) ResetError();
+	return fSuccess;
+}
+
 bool C4NetIOSimpleUDP::Broadcast(const C4NetIOPacket &rPacket)
 {
 	// just set broadcast address and send
@@ -2340,6 +2508,17 @@ void C4NetIOSimpleUDP::SetReUseAddress(bool fAllow)
 	fAllowReUse = fAllow;
 }
 
+void C4NetIOSimpleUDP::GetBatchStatistic(int *pRecvBatch, int *pSendBatch)
+{
+	if (pRecvBatch) *pRecvBatch = iRecvCalls ? iRecvPackets * 100 / iRecvCalls : 0;
+	if (pSendBatch) *pSendBatch = iSendCalls ? iSendPackets * 100 / iSendCalls : 0;
+}
+
+void C4NetIOSimpleUDP::ClearBatchStatistic()
+{
+	iRecvCalls = iRecvPackets = iSendCalls = iSendPackets = 0;
+}
+
 // *** C4NetIOUDP
 
 // * build options / constants / structures
@@ -2348,7 +2527,7 @@ void C4NetIOSimpleUDP::SetReUseAddress(bool fAllow)
 #define C4NETIOUDP_OPT_RECV_CHECK_IMMEDIATE
 
 // Protocol version
-const unsigned int C4NetIOUDP::iVersion = 2;
+const unsigned int C4NetIOUDP::iVersion = 3;
 
 // Standard timeout length
 const unsigned int C4NetIOUDP::iStdTimeout = 1000; // (ms)
@@ -2361,6 +2540,13 @@ const unsigned int C4NetIOUDP::iMaxOPacketBacklog = 10000;
 
 const unsigned int C4NetIOUDP::iUDPHeaderSize = 8 + 24; // (bytes)
 
+// Ethernet MTU minus IPv6 and UDP headers
+const unsigned int C4NetIOUDP::iMaxFragmentSize = 1500 - 40 - 8; // (bytes)
+
+// Fragment sizes probed for, in ascending order (the IPv6 minimum MTU sits in the middle)
+static const unsigned int C4NetIOUDP_ProbeSizes[] = { 1024, 1280 - 40 - 8, 1500 - 40 - 8 };
+static const unsigned int C4NetIOUDP_MaxProbeRetries = 3;
+
 #pragma pack (push, 1)
 
 // We need to adapt C4NetIO::addr_t to put it in our UDP packages.
@@ -2451,12 +2637,14 @@ struct C4NetIOUDP::ConnPacket : public PacketHdr
 	uint32_t ProtocolVer;
 	BinAddr Addr;
 	BinAddr MCAddr;
+	uint16_t MaxFragmentSize; // largest datagram the sender is willing to probe for
 };
 
 struct C4NetIOUDP::ConnOKPacket : public PacketHdr
 {
 	enum { MCM_NoMC, MCM_MC, MCM_MCOK, } MCMode;
 	BinAddr Addr;
+	uint16_t MaxFragmentSize; // see ConnPacket
 };
 
 struct C4NetIOUDP::AddAddrPacket : public PacketHdr
@@ -2469,6 +2657,7 @@ struct C4NetIOUDP::DataPacketHdr : public PacketHdr
 {
 	Packet::nr_t FNr; // start fragment of this series
 	uint32_t Size; // packet size (all fragments)
+	uint16_t FSize; // data size per fragment
 };
 
 struct C4NetIOUDP::CheckPacketHdr : public PacketHdr
@@ -2482,6 +2671,7 @@ struct C4NetIOUDP::ClosePacket : public PacketHdr
 	BinAddr Addr;
 };
 
+// Also used for fragment size probes: sent padded to TestNr bytes, answered unpadded.
 struct C4NetIOUDP::TestPacket : public PacketHdr
 {
 	unsigned int TestNr;
@@ -2799,18 +2989,25 @@ bool C4NetIOUDP::Broadcast(const C4NetIOPacket &rPacket) // (mt-safe)
 	if (pPeer)
 	{
 		CStdLock OutLock(&OutCSec);
-		// send it via multicast: encapsulate packet
-		Packet *pPkt = new Packet(rPacket.Duplicate(), iOPacketCounter);
+		// send it via multicast: encapsulate packet (shares data if possible)
+		Packet *pPkt = new Packet(C4NetIOPacket(rPacket), iOPacketCounter);
 		iOPacketCounter += pPkt->FragmentCnt();
 		// add to list
 		OPackets.AddPacket(pPkt);
 		// send it
 		fSuccess &= BroadcastDirect(*pPkt);
 	}
-	// send to all clients connected via du, too
+	// send to all clients connected via du, too (all fragments at once)
+	std::vector<C4NetIOPacket> Batch;
 	for (pPeer = pPeerList; pPeer; pPeer = pPeer->Next)
 		if (pPeer->Open() && !pPeer->MultiCast() && pPeer->doBroadcast())
-			pPeer->Send(rPacket);
+			pPeer->Send(rPacket, &Batch);
+	std::vector<addr_t> FailedAddrs;
+	SendDirectBatch(Batch, &FailedAddrs);
+	// close the peers that couldn't be sent to, as Peer::Send does
+	for (const addr_t &addr : FailedAddrs)
+		if ((pPeer = GetPeer(addr)) && pPeer->Open())
+			pPeer->Close("failed to send packet");
 	return true;
 }
 
@@ -2842,10 +3039,11 @@ int C4NetIOUDP::GetTimeout() // (mt-safe)
 	return iTiming;
 }
 
-bool C4NetIOUDP::GetStatistic(int *pBroadcastRate) // (mt-safe)
+bool C4NetIOUDP::GetStatistic(int *pBroadcastRate, int *pRecvBatch, int *pSendBatch) // (mt-safe)
 {
 	CStdLock StatLock(&StatCSec);
 	if (pBroadcastRate) *pBroadcastRate = iBroadcastRate;
+	GetBatchStatistic(pRecvBatch, pSendBatch);
 	return true;
 }
 
@@ -2871,6 +3069,7 @@ void C4NetIOUDP::ClearStatistic()
 	// broadcast statistics
 	CStdLock StatLock(&StatCSec);
 	iBroadcastRate = 0;
+	ClearBatchStatistic();
 }
 
 void C4NetIOUDP::OnPacket(const C4NetIOPacket &Packet, C4NetIO *pNetIO)
@@ -2890,8 +3089,8 @@ void C4NetIOUDP::OnPacket(const C4NetIOPacket &Packet, C4NetIO *pNetIO)
 	if (fMultiCast && !fDelayedLoopbackTest)
 		if (Packet.getAddr() == MCLoopbackAddr)
 			return;
-	// loopback test packet? ignore
-	if ((Packet.getStatus() & 0x7F) == IPID_Test) return;
+	// loopback test packet? ignore (unicast ones are fragment size probes)
+	if (Packet.getStatus() == (IPID_Test | 0x80)) return;
 	// address add? process directly
 
 	// find out who's responsible
@@ -2971,17 +3170,16 @@ void C4NetIOUDP::OnAddAddress(const addr_t &FromAddr, const AddAddrPacket &Packe
 C4NetIOUDP::Packet::Packet()
 	: iNr(~0),
 	Data(),
-	pFragmentGot(nullptr) {}
+	iFragmentGotCnt(0),
+	iFragmentDataSize(MaxDataSize) {}
 
-C4NetIOUDP::Packet::Packet(C4NetIOPacket &&rnData, nr_t inNr)
+C4NetIOUDP::Packet::Packet(C4NetIOPacket &&rnData, nr_t inNr, size_t inFragmentDataSize)
 	: iNr(inNr),
-	Data(rnData),
-	pFragmentGot(nullptr) {}
+	Data(std::move(rnData)),
+	iFragmentGotCnt(0),
+	iFragmentDataSize(inFragmentDataSize) {}
 
-C4NetIOUDP::Packet::~Packet()
-{
-	delete[] pFragmentGot; pFragmentGot = nullptr;
-}
+C4NetIOUDP::Packet::~Packet() {}
 
 // implementation
 
@@ -2990,7 +3188,7 @@ const size_t C4NetIOUDP::Packet::MaxDataSize = MaxSize - sizeof(DataPacketHdr);
 
 C4NetIOUDP::Packet::nr_t C4NetIOUDP::Packet::FragmentCnt() const
 {
-	return Data.getSize() ? (Data.getSize() - 1) / MaxDataSize + 1 : 1;
+	return Data.getSize() ? (Data.getSize() - 1) / iFragmentDataSize + 1 : 1;
 }
 
 C4NetIOPacket C4NetIOUDP::Packet::GetFragment(nr_t iFNr, bool fBroadcastFlag) const
@@ -3005,8 +3203,9 @@ C4NetIOPacket C4NetIOUDP::Packet::GetFragment(nr_t iFNr, bool fBroadcastFlag) co
 	pnHdr->Nr = iNr + iFNr;
 	pnHdr->FNr = iNr;
 	pnHdr->Size = Data.getSize();
+	pnHdr->FSize = static_cast<uint16_t>(iFragmentDataSize);
 	// copy data
-	Packet.Write(Data.getPart(iFNr * MaxDataSize, iFragmentSize),
+	Packet.Write(Data.getPart(iFNr * iFragmentDataSize, iFragmentSize),
 		sizeof(DataPacketHdr));
 	// return
 	return C4NetIOPacket(Packet, Data.getAddr());
@@ -3015,15 +3214,12 @@ C4NetIOPacket C4NetIOUDP::Packet::GetFragment(nr_t iFNr, bool fBroadcastFlag) co
 bool C4NetIOUDP::Packet::Complete() const
 {
 	if (Empty()) return false;
-	for (unsigned int i = 0; i < FragmentCnt(); i++)
-		if (!FragmentPresent(i))
-			return false;
-	return true;
+	return FragmentGot.empty() || iFragmentGotCnt == FragmentCnt();
 }
 
 bool C4NetIOUDP::Packet::FragmentPresent(uint32_t iFNr) const
 {
-	return !Empty() && iFNr < FragmentCnt() && (!pFragmentGot || pFragmentGot[iFNr]);
+	return !Empty() && iFNr < FragmentCnt() && (FragmentGot.empty() || (FragmentGot[iFNr / 32] >> (iFNr % 32)) & 1);
 }
 
 bool C4NetIOUDP::Packet::AddFragment(const C4NetIOPacket &Packet, const C4NetIO::addr_t &addr)
@@ -3038,39 +3234,45 @@ bool C4NetIOUDP::Packet::AddFragment(const C4NetIOPacket &Packet, const C4NetIO:
 	if (fFirstFragment)
 	{
 		// init
-		iNr = pHdr->FNr;
+		if (!pHdr->FSize) return false;
+		iNr = pHdr->FNr; iFragmentDataSize = pHdr->FSize;
 		Data.New(pHdr->Size); Data.SetAddr(addr);
 		// fragmented? create fragment list
 		if (FragmentCnt() > 1)
-			memset(pFragmentGot = new bool[FragmentCnt()], false, FragmentCnt());
+			FragmentGot.assign((FragmentCnt() + 31) / 32, 0);
+		iFragmentGotCnt = 0;
 		// check header
-		if (pHdr->Nr < iNr || pHdr->Nr >= iNr + FragmentCnt()) { Data.Clear(); return false; }
+		if (pHdr->Nr < iNr || pHdr->Nr >= iNr + FragmentCnt()) { Data.Clear(); FragmentGot.clear(); return false; }
 	}
 	else
 	{
 		// check header
 		if (pHdr->FNr != iNr) return false;
 		if (pHdr->Size != Data.getSize()) return false;
+		if (pHdr->FSize != iFragmentDataSize) return false;
 		if (pHdr->Nr < iNr || pHdr->Nr >= iNr + FragmentCnt()) return false;
 	}
 	// check packet size
 	nr_t iFNr = pHdr->Nr - iNr;
 	if (iPacketDataSize != FragmentSize(iFNr)) return false;
-	// already got this fragment? (needs check for first packet as FragmentPresent always assumes true if pFragmentGot is nullptr)
+	// already got this fragment? (needs check for first packet as FragmentPresent always assumes true without fragment bitset)
 	StdBuf PacketData = Packet.getPart(sizeof(DataPacketHdr), iPacketDataSize);
 	if (!fFirstFragment && FragmentPresent(iFNr))
 	{
 		// compare
-		if (Data.Compare(PacketData, iFNr * MaxDataSize))
+		if (Data.Compare(PacketData, iFNr * iFragmentDataSize))
 			return false;
 	}
 	else
 	{
 		// otherwise: copy data
-		Data.Write(PacketData, iFNr * MaxDataSize);
+		Data.Write(PacketData, iFNr * iFragmentDataSize);
 		// set flag (if fragmented)
-		if (pFragmentGot)
-			pFragmentGot[iFNr] = true;
+		if (!FragmentGot.empty())
+		{
+			FragmentGot[iFNr / 32] |= 1u << (iFNr % 32);
+			++iFragmentGotCnt;
+		}
 		// shouldn't happen
 		else
 			assert(Complete());
@@ -3082,115 +3284,124 @@ bool C4NetIOUDP::Packet::AddFragment(const C4NetIOPacket &Packet, const C4NetIO:
 size_t C4NetIOUDP::Packet::FragmentSize(nr_t iFNr) const
 {
 	assert(iFNr < FragmentCnt());
-	return (std::min)(MaxDataSize, Data.getSize() - iFNr * MaxDataSize);
+	return (std::min)(iFragmentDataSize, Data.getSize() - iFNr * iFragmentDataSize);
 }
 
 // * C4NetIOUDP::PacketList
 
+const unsigned int C4NetIOUDP::PacketList::iMaxIWindowSize = 1 << 20;
+
 // construction / destruction
 
-C4NetIOUDP::PacketList::PacketList(unsigned int inMaxPacketCnt)
-	: pFront(nullptr),
-	iMaxPacketCnt(inMaxPacketCnt),
+C4NetIOUDP::PacketList::PacketList(unsigned int inMaxPacketCnt, unsigned int inMaxWindowSize)
+	: iBase(0), iEnd(0), iMaxWindowSize(inMaxWindowSize),
 	iPacketCnt(0),
-	pBack(nullptr) {}
+	iMaxPacketCnt(inMaxPacketCnt) {}
 
 C4NetIOUDP::PacketList::~PacketList()
 {
 	Clear();
 }
 
+bool C4NetIOUDP::PacketList::Reserve(unsigned int iSize)
+{
+	if (iSize <= Slots.size()) return true;
+	if (iSize > iMaxWindowSize) return false;
+	// grow to the next power of two, moving the window over
+	size_t iNewSize = std::max<size_t>(Slots.size(), 64);
+	while (iNewSize < iSize) iNewSize *= 2;
+	std::vector<Packet *> NewSlots(iNewSize, nullptr);
+	if (iPacketCnt)
+		for (unsigned int iNr = iBase; iNr != iEnd; iNr++)
+			NewSlots[iNr & (iNewSize - 1)] = Slot(iNr);
+	Slots.swap(NewSlots);
+	return true;
+}
+
 C4NetIOUDP::Packet *C4NetIOUDP::PacketList::GetPacket(unsigned int iNr)
 {
-	CStdShareLock ListLock(&ListCSec);
-	for (Packet *pPkt = pBack; pPkt; pPkt = pPkt->Prev)
-		if (pPkt->GetNr() == iNr)
-			return pPkt;
-		else if (pPkt->GetNr() < iNr)
-			return nullptr;
-	return nullptr;
+	Packet *pPkt = GetPacketFrgm(iNr);
+	return pPkt && pPkt->GetNr() == iNr ? pPkt : nullptr;
 }
 
 C4NetIOUDP::Packet *C4NetIOUDP::PacketList::GetPacketFrgm(unsigned int iNr)
 {
-	CStdShareLock ListLock(&ListCSec);
-	for (Packet *pPkt = pBack; pPkt; pPkt = pPkt->Prev)
-		if (pPkt->GetNr() <= iNr && pPkt->GetNr() + pPkt->FragmentCnt() > iNr)
-			return pPkt;
-		else if (pPkt->GetNr() < iNr)
-			return nullptr;
-	return nullptr;
+	if (!iPacketCnt || iNr < iBase || iNr >= iEnd) return nullptr;
+	return Slot(iNr);
 }
 
 C4NetIOUDP::Packet *C4NetIOUDP::PacketList::GetFirstPacketComplete()
 {
-	CStdShareLock ListLock(&ListCSec);
-	return pFront && pFront->Complete() ? pFront : nullptr;
+	if (!iPacketCnt) return nullptr;
+	Packet *pFront = Slot(iBase);
+	return pFront->Complete() ? pFront : nullptr;
 }
 
 bool C4NetIOUDP::PacketList::FragmentPresent(unsigned int iNr)
 {
-	CStdShareLock ListLock(&ListCSec);
 	Packet *pPkt = GetPacketFrgm(iNr);
 	return pPkt ? pPkt->FragmentPresent(iNr - pPkt->GetNr()) : false;
 }
 
 bool C4NetIOUDP::PacketList::AddPacket(Packet *pPacket)
 {
-	CStdLock ListLock(&ListCSec);
-	// find insert location
-	Packet *pInsertAfter = pBack, *pInsertBefore = nullptr;
-	for (; pInsertAfter; pInsertBefore = pInsertAfter, pInsertAfter = pInsertAfter->Prev)
-		if (pInsertAfter->GetNr() + pInsertAfter->FragmentCnt() <= pPacket->GetNr())
-			break;
-	// check: enough space?
-	if (pInsertBefore && pInsertBefore->GetNr() < pPacket->GetNr() + pPacket->FragmentCnt())
+	const unsigned int iNr = pPacket->GetNr(), iNrEnd = iNr + pPacket->FragmentCnt();
+	// new window
+	const unsigned int iNewBase = iPacketCnt ? (std::min)(iBase, iNr) : iNr,
+		iNewEnd = iPacketCnt ? (std::max)(iEnd, iNrEnd) : iNrEnd;
+	if (!Reserve(iNewEnd - iNewBase))
 		return false;
+	// check: enough space?
+	if (iPacketCnt)
+		for (unsigned int i = (std::max)(iNr, iBase); i < (std::min)(iNrEnd, iEnd); i++)
+			if (Slot(i))
+				return false;
 	// insert
-	(pInsertAfter ? pInsertAfter->Next : pFront) = pPacket;
-	(pInsertBefore ? pInsertBefore->Prev : pBack) = pPacket;
-	pPacket->Next = pInsertBefore;
-	pPacket->Prev = pInsertAfter;
+	for (unsigned int i = iNr; i < iNrEnd; i++)
+		Slot(i) = pPacket;
+	iBase = iNewBase; iEnd = iNewEnd;
 	// count packets, check limit
 	++iPacketCnt;
 	while (iPacketCnt > iMaxPacketCnt)
-		DeletePacket(pFront);
+		DeletePacket(Slot(iBase));
 	// ok
 	return true;
 }
 
 bool C4NetIOUDP::PacketList::DeletePacket(Packet *pPacket)
 {
-	CStdLock ListLock(&ListCSec);
-#ifdef _DEBUG
+	const unsigned int iNr = pPacket->GetNr(), iNrEnd = iNr + pPacket->FragmentCnt();
 	// check: this list?
-	Packet *pPos = pPacket;
-	while (pPos && pPos != pFront) pPos = pPos->Prev;
-	assert(pPos);
-#endif
-	// unlink packet
-	(pPacket->Prev ? pPacket->Prev->Next : pFront) = pPacket->Next;
-	(pPacket->Next ? pPacket->Next->Prev : pBack) = pPacket->Prev;
+	assert(GetPacket(iNr) == pPacket);
+	// free slots
+	for (unsigned int i = iNr; i < iNrEnd; i++)
+		Slot(i) = nullptr;
 	// delete packet
 	delete pPacket;
-	// decrease count
-	--iPacketCnt;
+	// decrease count, shrink window
+	if (!--iPacketCnt)
+		iBase = iEnd = 0;
+	else
+	{
+		if (iNr == iBase)
+			for (iBase = iNrEnd; !Slot(iBase); iBase++) {}
+		if (iNrEnd == iEnd)
+			for (iEnd = iNr; !Slot(iEnd - 1); iEnd--) {}
+	}
 	// ok
 	return true;
 }
 
 void C4NetIOUDP::PacketList::ClearPackets(unsigned int iUntil)
 {
-	CStdLock ListLock(&ListCSec);
-	while (pFront && pFront->GetNr() < iUntil)
-		DeletePacket(pFront);
+	while (iPacketCnt && iBase < iUntil)
+		DeletePacket(Slot(iBase));
 }
 
 void C4NetIOUDP::PacketList::Clear()
 {
-	CStdLock ListLock(&ListCSec);
 	while (iPacketCnt)
-		DeletePacket(pFront);
+		DeletePacket(Slot(iBase));
 }
 
 // * C4NetIOUDP::Peer
@@ -3210,8 +3421,10 @@ C4NetIOUDP::Peer::Peer(const addr_t &naddr, C4NetIOUDP *pnParent)
 	iIPacketCounter(0), iRIPacketCounter(0),
 	iIMCPacketCounter(0), iRIMCPacketCounter(0),
 	OPackets(iMaxOPacketBacklog),
+	IPackets(~0, PacketList::iMaxIWindowSize), IMCPackets(~0, PacketList::iMaxIWindowSize),
 	iMCAckPacketCounter(0),
 	iNextReCheck(0),
+	iFragmentSize(Packet::MaxSize), iPeerMaxFragmentSize(Packet::MaxSize), iProbeSize(0), iProbeRetries(0),
 	iIRate(0), iORate(0), iLoss(0)
 {
 }
@@ -3226,25 +3439,30 @@ bool C4NetIOUDP::Peer::Connect(bool fFailCallback) // (mt-safe)
 {
 	// initiate connection (DoConn will set status CS_Conn)
 	fMultiCast = false; fConnFailCallback = fFailCallback;
+	// start over with the safe fragment size
+	{ CStdLock OutLock(&OutCSec); iFragmentSize = Packet::MaxSize; }
+	iProbeSize = iProbeRetries = 0;
 	return DoConn(false);
 }
 
-bool C4NetIOUDP::Peer::Send(const C4NetIOPacket &rPacket) // (mt-safe)
+bool C4NetIOUDP::Peer::Send(const C4NetIOPacket &rPacket, std::vector<C4NetIOPacket> *pBatch) // (mt-safe)
 {
 	CStdLock OutLock(&OutCSec);
-	// encapsulate packet
-	Packet *pnPacket = new Packet(rPacket.Duplicate(), iOPacketCounter);
-	iOPacketCounter += pnPacket->FragmentCnt();
+	// encapsulate packet (shares data if possible)
+	Packet *pnPacket = new Packet(C4NetIOPacket(rPacket), iOPacketCounter, iFragmentSize - sizeof(DataPacketHdr));
 	pnPacket->GetData().SetAddr(addr);
 	// add it to outgoing packet stack
 	if (!OPackets.AddPacket(pnPacket))
-		return false;
+	{
+		delete pnPacket; return false;
+	}
+	iOPacketCounter += pnPacket->FragmentCnt();
 	// This should be ensured by calling function anyway.
 	// It is not secure to send packets before the connection
 	// is etablished completly.
 	if (eStatus != CS_Works) return true;
 	// send it
-	if (!SendDirect(*pnPacket))
+	if (!SendDirect(*pnPacket, ~0, pBatch))
 	{
 		Close("failed to send packet");
 		return false;
@@ -3283,6 +3501,66 @@ bool C4NetIOUDP::Peer::Check(bool fForceCheck)
 	return true;
 }
 
+void C4NetIOUDP::Peer::Probe() // (mt-safe)
+{
+	// only on working connections
+	if (eStatus != CS_Works) return;
+	// last probe unanswered?
+	if (iProbeSize)
+	{
+		// give up on this size (and all bigger ones)
+		if (++iProbeRetries > C4NetIOUDP_MaxProbeRetries)
+		{
+			iPeerMaxFragmentSize = iFragmentSize;
+			iProbeSize = iProbeRetries = 0;
+			return;
+		}
+	}
+	else
+	{
+		// search next size to try
+		for (unsigned int iSize : C4NetIOUDP_ProbeSizes)
+			if (iSize > iFragmentSize && iSize <= iPeerMaxFragmentSize)
+			{
+				iProbeSize = iSize;
+				break;
+			}
+		if (!iProbeSize) return;
+	}
+	// send a test packet of that size
+	StdBuf Packet; Packet.New(iProbeSize);
+	std::memset(Packet.getMData(), 0, Packet.getSize());
+	TestPacket *pPkt = getMBufPtr<TestPacket>(Packet);
+	pPkt->StatusByte = IPID_Test;
+	pPkt->Nr = iOPacketCounter;
+	pPkt->TestNr = iProbeSize;
+	SendDirect(C4NetIOPacket(Packet, addr));
+}
+
+void C4NetIOUDP::Peer::OnProbe(const C4NetIOPacket &rPacket) // (mt-safe)
+{
+	if (rPacket.getSize() < sizeof(TestPacket)) return;
+	const TestPacket *pPkt = getBufPtr<TestPacket>(rPacket);
+	// probe? answer it
+	if (rPacket.getSize() == pPkt->TestNr && rPacket.getSize() > sizeof(TestPacket))
+	{
+		TestPacket Answer;
+		Answer.StatusByte = IPID_Test;
+		Answer.Nr = iOPacketCounter;
+		Answer.TestNr = pPkt->TestNr;
+		SendDirect(C4NetIOPacket(&Answer, sizeof(Answer), false, addr));
+	}
+	// answer to the current probe?
+	else if (rPacket.getSize() == sizeof(TestPacket) && iProbeSize && pPkt->TestNr == iProbeSize)
+	{
+		// use the new size from now on
+		{ CStdLock OutLock(&OutCSec); iFragmentSize = iProbeSize; }
+		iProbeSize = iProbeRetries = 0;
+		// try the next one right away
+		Probe();
+	}
+}
+
 void C4NetIOUDP::Peer::OnRecv(const C4NetIOPacket &rPacket) // (mt-safe)
 {
 	// statistics
@@ -3333,6 +3611,8 @@ void C4NetIOUDP::Peer::OnRecv(const C4NetIOPacket &rPacket) // (mt-safe)
 			}
 			// save back the address the peer is using
 			PeerAddr = pPkt->Addr;
+			// the peer limits our fragment size as well
+			iPeerMaxFragmentSize = std::clamp<unsigned int>(pPkt->MaxFragmentSize, Packet::MaxSize, iMaxFragmentSize);
 		}
 		// set packet counter
 		if (fBroadcasted)
@@ -3361,6 +3641,7 @@ void C4NetIOUDP::Peer::OnRecv(const C4NetIOPacket &rPacket) // (mt-safe)
 		nPack.StatusByte = IPID_ConnOK; // (always du, no mc experiments here)
 		nPack.Nr = fBroadcasted ? pParent->iOPacketCounter : iOPacketCounter;
 		nPack.Addr = addr;
+		nPack.MaxFragmentSize = iMaxFragmentSize;
 		if (fBroadcasted)
 			nPack.MCMode = ConnOKPacket::MCM_MCOK; // multicast send ok
 		else if (pParent->fMultiCast && addr.GetPort() == pParent->iPort)
@@ -3387,6 +3668,8 @@ void C4NetIOUDP::Peer::OnRecv(const C4NetIOPacket &rPacket) // (mt-safe)
 		const ConnOKPacket *pPkt = getBufPtr<ConnOKPacket>(rPacket);
 		// save port
 		PeerAddr = pPkt->Addr;
+		// save fragment size limit
+		iPeerMaxFragmentSize = std::clamp<unsigned int>(pPkt->MaxFragmentSize, Packet::MaxSize, iMaxFragmentSize);
 		// Needs another Conn/ConnOK-sequence?
 		switch (pPkt->MCMode)
 		{
@@ -3413,6 +3696,11 @@ void C4NetIOUDP::Peer::OnRecv(const C4NetIOPacket &rPacket) // (mt-safe)
 	}
 	break;
 
+	case IPID_Test:
+		// fragment size probe
+		if (!fBroadcasted && eStatus == CS_Works) OnProbe(rPacket);
+		break;
+
 	case IPID_Data:
 	{
 		// get the packet header
@@ -3429,6 +3717,7 @@ void C4NetIOUDP::Peer::OnRecv(const C4NetIOPacket &rPacket) // (mt-safe)
 		if (pPkt->AddFragment(rPacket, addr))
 		{
 			// add the packet to list
+			// (window full: dropped, it's asked for again when the window has moved on)
 			if (fAddPacket) if (!pPacketList->AddPacket(pPkt)) { delete pPkt; break; }
 			// check for complete packets
 			CheckCompleteIPackets();
@@ -3457,7 +3746,8 @@ void C4NetIOUDP::Peer::OnRecv(const C4NetIOPacket &rPacket) // (mt-safe)
 		OutLock.Clear();
 		// read ask list
 		const int *pAskList = getBufPtr<int>(rPacket, sizeof(CheckPacketHdr));
-		// send the packets he asks for
+		// send the packets he asks for (all at once)
+		std::vector<C4NetIOPacket> Batch;
 		unsigned int i;
 		for (i = 0; i < pPkt->AskCount + pPkt->MCAskCount; i++)
 		{
@@ -3465,13 +3755,20 @@ void C4NetIOUDP::Peer::OnRecv(const C4NetIOPacket &rPacket) // (mt-safe)
 			bool fMCPacket = i >= pPkt->AskCount;
 			CStdLock OutLock(fMCPacket ? &pParent->OutCSec : &OutCSec);
 			Packet *pPkt2Send = (fMCPacket ? pParent->OPackets : OPackets).GetPacketFrgm(pAskList[i]);
-			if (!pPkt2Send) { Close("starvation"); break; }
+			if (!pPkt2Send)
+			{
+				// the fragments batched so far are dropped: nothing must be sent after the close packet
+				OutLock.Clear();
+				Close("starvation");
+				return;
+			}
 			// send the fragment
 			if (fMCPacket)
-				pParent->BroadcastDirect(*pPkt2Send, pAskList[i]);
+				pParent->BroadcastDirect(*pPkt2Send, pAskList[i], &Batch);
 			else
-				SendDirect(*pPkt2Send, pAskList[i]);
+				SendDirect(*pPkt2Send, pAskList[i], &Batch);
 		}
+		pParent->SendDirectBatch(Batch);
 	}
 	break;
 
@@ -3537,6 +3834,7 @@ bool C4NetIOUDP::Peer::DoConn(bool fMC) // (mt-safe)
 		Pkt.MCAddr = pParent->C4NetIOSimpleUDP::getMCAddr();
 	else
 		Pkt.MCAddr = C4NetIO::addr_t{};
+	Pkt.MaxFragmentSize = iMaxFragmentSize;
 	return SendDirect(C4NetIOPacket(&Pkt, sizeof(Pkt), false, addr));
 }
 
@@ -3564,27 +3862,37 @@ bool C4NetIOUDP::Peer::DoCheck(int iAskCnt, int iMCAskCnt, unsigned int *pAskLis
 	return SendDirect(C4NetIOPacket(Packet, addr));
 }
 
-bool C4NetIOUDP::Peer::SendDirect(const Packet &rPacket, unsigned int iNr)
+bool C4NetIOUDP::Peer::SendDirect(const Packet &rPacket, unsigned int iNr, std::vector<C4NetIOPacket> *pBatch)
 {
 	// send one fragment only?
-	if (iNr + 1)
+	if (iNr + 1 && !pBatch)
 		return SendDirect(rPacket.GetFragment(iNr - rPacket.GetNr()));
-	// otherwise: send all fragments
-	bool fSuccess = true;
+	// otherwise: send all fragments at once
+	std::vector<C4NetIOPacket> Batch;
+	std::vector<C4NetIOPacket> &rBatch = pBatch ? *pBatch : Batch;
 	for (unsigned int i = 0; i < rPacket.FragmentCnt(); i++)
-		fSuccess &= SendDirect(rPacket.GetFragment(i));
-	return fSuccess;
+		if (!(iNr + 1) || i == iNr - rPacket.GetNr())
+		{
+			rBatch.push_back(rPacket.GetFragment(i));
+			PrepareDirect(rBatch.back());
+		}
+	return pBatch || pParent->SendDirectBatch(Batch);
 }
 
 bool C4NetIOUDP::Peer::SendDirect(C4NetIOPacket &&rPacket) // (mt-safe)
+{
+	PrepareDirect(rPacket);
+	// forward call
+	return pParent->SendDirect(std::move(rPacket));
+}
+
+void C4NetIOUDP::Peer::PrepareDirect(C4NetIOPacket &rPacket) // (mt-safe)
 {
 	// insert correct addr
 	const C4NetIO::addr_t v6Addr{addr.AsIPv6()};
 	if (!(rPacket.getStatus() & 0x80)) rPacket.SetAddr(v6Addr);
 	// count outgoing
 	{ CStdLock StatLock(&StatCSec); iORate += rPacket.getSize() + iUDPHeaderSize; }
-	// forward call
-	return pParent->SendDirect(std::move(rPacket));
 }
 
 void C4NetIOUDP::Peer::OnConn()
@@ -3692,26 +4000,48 @@ void C4NetIOUDP::Peer::OnTimeout()
 
 // * C4NetIOUDP: implementation
 
-bool C4NetIOUDP::BroadcastDirect(const Packet &rPacket, unsigned int iNr) // (mt-safe)
+bool C4NetIOUDP::BroadcastDirect(const Packet &rPacket, unsigned int iNr, std::vector<C4NetIOPacket> *pBatch) // (mt-safe)
 {
 	// only one fragment?
-	if (iNr + 1)
+	if (iNr + 1 && !pBatch)
 		return SendDirect(rPacket.GetFragment(iNr - rPacket.GetNr(), true));
-	// send all fragments
-	bool fSuccess = true;
+	// send all fragments at once
+	std::vector<C4NetIOPacket> Batch;
+	std::vector<C4NetIOPacket> &rBatch = pBatch ? *pBatch : Batch;
 	for (unsigned int iFrgm = 0; iFrgm < rPacket.FragmentCnt(); iFrgm++)
-		fSuccess &= SendDirect(rPacket.GetFragment(iFrgm, true));
-	return fSuccess;
+		if (!(iNr + 1) || iFrgm == iNr - rPacket.GetNr())
+			rBatch.push_back(rPacket.GetFragment(iFrgm, true));
+	return pBatch || SendDirectBatch(Batch);
 }
 
 bool C4NetIOUDP::SendDirect(C4NetIOPacket &&rPacket) // (mt-safe)
 {
-	addr_t toaddr = rPacket.getAddr();
+	if (!PrepareDirect(rPacket)) return true;
+	// send it
+	return C4NetIOSimpleUDP::Send(rPacket);
+}
+
+bool C4NetIOUDP::SendDirectBatch(std::vector<C4NetIOPacket> &Packets, std::vector<addr_t> *pFailedAddrs) // (mt-safe)
+{
+	// prepare, leaving out dropped packets
+	Packets.erase(std::remove_if(Packets.begin(), Packets.end(), [this](C4NetIOPacket &rPacket) { return !PrepareDirect(rPacket); }), Packets.end());
+	if (Packets.empty()) return true;
+	// send them
+	std::vector<size_t> Failed;
+	if (C4NetIOSimpleUDP::SendBatch(Packets.data(), Packets.size(), &Failed)) return true;
+	if (pFailedAddrs)
+		for (size_t i : Failed)
+			pFailedAddrs->push_back(Packets[i].getAddr());
+	return false;
+}
+
+bool C4NetIOUDP::PrepareDirect(C4NetIOPacket &rPacket) // (mt-safe)
+{
 	// packet meant to be broadcasted?
 	if (rPacket.getStatus() & 0x80)
 	{
 		// set addr
-		toaddr = C4NetIOSimpleUDP::getMCAddr();
+		rPacket.SetAddr(C4NetIOSimpleUDP::getMCAddr());
 		// statistics
 		CStdLock StatLock(&StatCSec);
 		iBroadcastRate += rPacket.getSize() + iUDPHeaderSize;
@@ -3719,16 +4049,15 @@ bool C4NetIOUDP::SendDirect(C4NetIOPacket &&rPacket) // (mt-safe)
 
 	// debug
 #ifdef C4NETIO_DEBUG
-	{ C4NetIOPacket Pkt2 = rPacket; Pkt2.SetAddr(toaddr); DebugLogPkt(true, Pkt2); }
+	DebugLogPkt(true, rPacket);
 #endif
 
 #ifdef C4NETIO_SIMULATE_PACKETLOSS
 	if ((rPacket.getStatus() & 0x7F) != IPID_Test)
-		if (SafeRandom(100) < C4NETIO_SIMULATE_PACKETLOSS) return true;
+		if (SafeRandom(100) < C4NETIO_SIMULATE_PACKETLOSS) return false;
 #endif
 
-	// send it
-	return C4NetIOSimpleUDP::Send(C4NetIOPacket(rPacket.getRef(), toaddr));
+	return true;
 }
 
 bool C4NetIOUDP::DoLoopbackTest()
@@ -3879,7 +4208,10 @@ void C4NetIOUDP::DoCheck() // (mt-safe)
 	// peer connection checks
 	for (Peer *pPeer = pPeerList; pPeer; pPeer = pPeer->Next)
 		if (pPeer->Open())
+		{
 			pPeer->Check();
+			pPeer->Probe();
+		}
 	// set time for next check
 	iNextCheck = timeGetTime() + iCheckInterval;
 }
@@ -3964,7 +4296,7 @@ void C4NetIOUDP::DebugLogPkt(bool fOut, const C4NetIOPacket &Pkt)
 		switch (Hdr.StatusByte)
 		{
 		case IPID_Test: { UPACK(TestPacket); O.AppendFormat(" (%d)", P.TestNr); break; }
-		case IPID_Conn: { UPACK(ConnPacket); O.AppendFormat(" (Ver %d, MC: %s)", P.ProtocolVer, P.MCAddr.ToString().getData()); break; }
+		case IPID_Conn: { UPACK(ConnPacket); O.AppendFormat(" (Ver %d, MC: %s, MaxF: %d)", P.ProtocolVer, P.MCAddr.ToString().getData(), P.MaxFragmentSize); break; }
 		case IPID_ConnOK:
 		{
 			UPACK(ConnOKPacket);
@@ -3979,7 +4311,7 @@ void C4NetIOUDP::DebugLogPkt(bool fOut, const C4NetIOPacket &Pkt)
 		}
 		case IPID_Data:
 		{
-			UPACK(DataPacketHdr); O.AppendFormat(" (f: %d s: %d)", P.FNr, P.Size);
+			UPACK(DataPacketHdr); O.AppendFormat(" (f: %d s: %d fs: %d)", P.FNr, P.Size, P.FSize);
 			for (int iPos = sizeof(DataPacketHdr); iPos < std::min<int>(Pkt.getSize(), sizeof(DataPacketHdr) + 16); iPos++)
 				O.AppendFormat(" %02x", *getBufPtr<unsigned char>(Pkt, iPos));
 			break;
@@ -25,7 +25,9 @@
 #include "StdCompiler.h"
 #include "StdScheduler.h"
 
+#include <atomic>
 #include <memory>
+#include <vector>
 
 #ifdef _WIN32
 	#include <winsock2.h>
@@ -266,7 +268,8 @@ public:
 	virtual bool Broadcast(const class C4NetIOPacket &rPacket) = 0;
 
 	// statistics
-	virtual bool GetStatistic(int *pBroadcastRate) = 0;
+	// pRecvBatch/pSendBatch: average datagrams per system call (in hundredths), if supported
+	virtual bool GetStatistic(int *pBroadcastRate, int *pRecvBatch = nullptr, int *pSendBatch = nullptr) = 0;
 	virtual bool GetConnStatistic(const addr_t &addr, int *pIRate, int *pORate, int *pLoss) = 0;
 	virtual void ClearStatistic() = 0;
 
@@ -298,14 +301,23 @@ public:
 	// construct from buffer (takes data, if possible)
 	explicit C4NetIOPacket(const StdBuf &Buf, const C4NetIO::addr_t &naddr = C4NetIO::addr_t());
 
+	// copies data, unless it is shared
+	C4NetIOPacket(const C4NetIOPacket &Pkt2);
+	C4NetIOPacket(C4NetIOPacket &&Pkt2);
+	C4NetIOPacket &operator=(const C4NetIOPacket &Pkt2);
+	C4NetIOPacket &operator=(C4NetIOPacket &&Pkt2);
+
 	~C4NetIOPacket();
 
 protected:
 	// address
 	C4NetIO::addr_t addr;
+	// immutable data shared by all copies (see Share)
+	std::shared_ptr<const StdBuf> SharedData;
 
 public:
 	const C4NetIO::addr_t &getAddr() const { return addr; }
+	bool isShared() const { return !!SharedData; }
 
 	uint8_t getStatus() const { return getSize() ? *getBufPtr<char>(*this) : 0; }
 	StdBuf  getPBuf()   const { return getSize() ? getPart(1, getSize() - 1) : getRef(); }
@@ -317,6 +329,8 @@ public:
 	C4NetIOPacket Duplicate() const { return C4NetIOPacket(StdBuf::Duplicate(), addr); }
 	// change addr
 	void SetAddr(const C4NetIO::addr_t &naddr) { addr = naddr; }
+	// make contents immutable, so copies only reference them
+	void Share();
 
 	// delete contents
 	void Clear();
@@ -371,7 +385,7 @@ public:
 	virtual int GetTimeout();
 
 	// statistics
-	virtual bool GetStatistic(int *pBroadcastRate);
+	virtual bool GetStatistic(int *pBroadcastRate, int *pRecvBatch = nullptr, int *pSendBatch = nullptr);
 	virtual bool GetConnStatistic(const addr_t &addr, int *pIRate, int *pORate, int *pLoss);
 	virtual void ClearStatistic();
 
@@ -524,6 +538,7 @@ public:
 
 	virtual bool Send(const C4NetIOPacket &rPacket);
 	virtual bool Broadcast(const C4NetIOPacket &rPacket);
+	bool SendBatch(const C4NetIOPacket *pPackets, size_t iCnt, std::vector<size_t> *pFailed = nullptr); // send several packets with as few system calls as possible; failures don't stop the others
 
 	virtual void UnBlock();
 #ifdef STDSCHEDULER_USE_EVENTS
@@ -539,7 +554,7 @@ public:
 
 	virtual bool SetBroadcast(const addr_t &addr, bool fSet = true) { assert(false); return false; }
 
-	virtual bool GetStatistic(int *pBroadcastRate) { assert(false); return false; }
+	virtual bool GetStatistic(int *pBroadcastRate, int *pRecvBatch = nullptr, int *pSendBatch = nullptr) { assert(false); return false; }
 
 	virtual bool GetConnStatistic(const addr_t &addr, int *pIRate, int *pORate, int *pLoss)
 	{
@@ -569,6 +584,12 @@ private:
 	// multibind
 	int fAllowReUse;
 
+	// receive buffer for batched reading
+	StdBuf RecvBatchBuf;
+
+	// system call statistics
+	std::atomic<unsigned int> iRecvCalls{0}, iRecvPackets{0}, iSendCalls{0}, iSendPackets{0};
+
 protected:
 	// multicast address
 	const addr_t &getMCAddr() const { return MCAddr; }
@@ -580,6 +601,10 @@ protected:
 	// enable multi-bind (call before Init!)
 	void SetReUseAddress(bool fAllow);
 
+	// datagrams per system call (in hundredths)
+	void GetBatchStatistic(int *pRecvBatch, int *pSendBatch);
+	void ClearBatchStatistic();
+
 private:
 	// socket wait (check for readability)
 	enum WaitResult { WR_Timeout, WR_Readable, WR_Cancelled, WR_Error = -1, };
@@ -623,7 +648,7 @@ public:
 
 	virtual int GetTimeout();
 
-	virtual bool GetStatistic(int *pBroadcastRate);
+	virtual bool GetStatistic(int *pBroadcastRate, int *pRecvBatch = nullptr, int *pSendBatch = nullptr);
 	virtual bool GetConnStatistic(const addr_t &addr, int *pIRate, int *pORate, int *pLoss);
 	virtual void ClearStatistic();
 
@@ -649,7 +674,7 @@ protected:
 	struct DataPacketHdr; struct CheckPacketHdr; struct ClosePacket;
 
 	// constants
-	static const unsigned int iVersion; // = 2;
+	static const unsigned int iVersion; // = 3;
 
 	static const unsigned int iStdTimeout, // = 1000, // (ms)
 		iCheckInterval; // = 1000 // (ms)
@@ -658,6 +683,9 @@ protected:
 
 	static const unsigned int iUDPHeaderSize; // = 8 + 24; // (bytes)
 
+	// largest datagram used for unicast fragments (found by probing)
+	static const unsigned int iMaxFragmentSize; // = 1452 // (bytes)
+
 	// packet class
 	class PacketList;
 	class Packet
@@ -666,7 +694,7 @@ protected:
 
 	public:
 		// constants / structures
-		static const size_t MaxSize; // = 1024;
+		static const size_t MaxSize; // = 512; (default fragment size, always safe)
 		static const size_t MaxDataSize; // = MaxSize - sizeof(Header);
 
 		// types used for packing
@@ -674,14 +702,18 @@ protected:
 
 		// construction / destruction
 		Packet();
-		Packet(C4NetIOPacket &&rnData, nr_t inNr);
+		Packet(C4NetIOPacket &&rnData, nr_t inNr, size_t inFragmentDataSize = MaxDataSize);
 		~Packet();
 
 	protected:
 		// data
 		nr_t iNr;
 		C4NetIOPacket Data;
-		bool *pFragmentGot;
+		// fragments received (bitset, empty if complete from the start)
+		std::vector<uint32_t> FragmentGot;
+		nr_t iFragmentGotCnt;
+		// data bytes per fragment (sent along with every fragment)
+		size_t iFragmentDataSize;
 
 	public:
 		// data access
@@ -699,25 +731,34 @@ protected:
 
 	protected:
 		::size_t FragmentSize(nr_t iFNr) const;
-		// list
-		Packet *Next, *Prev;
 	};
 
 	friend class Packet;
 
+	// Window of packets, as a ring buffer indexed by fragment number.
+	// Not locked: outgoing lists are guarded by OutCSec, incoming lists
+	// are only touched by the network thread.
 	class PacketList
 	{
 	public:
-		PacketList(unsigned int iMaxPacketCnt = ~0);
+		PacketList(unsigned int iMaxPacketCnt = ~0, unsigned int iMaxWindowSize = ~0);
 		~PacketList();
 
+		// maximum window size of incoming lists (fragments), so bogus fragment numbers
+		// can't make them huge. Fragments behind it are dropped and asked for later.
+		// Outgoing lists are limited by the packets they hold.
+		static const unsigned int iMaxIWindowSize; // = 1 << 20
+
 	protected:
-		// packet list
-		Packet *pFront, *pBack;
+		// packet per fragment slot (size is a power of two)
+		std::vector<Packet *> Slots;
+		// window: first and behind-last fragment number
+		unsigned int iBase, iEnd, iMaxWindowSize;
 		// packet counts
 		unsigned int iPacketCnt, iMaxPacketCnt;
-		// critical section
-		CStdCSecEx ListCSec;
+
+		Packet *&Slot(unsigned int iNr) { return Slots[iNr & (Slots.size() - 1)]; }
+		bool Reserve(unsigned int iSize);
 
 	public:
 		Packet *GetPacket(unsigned int iNr);
@@ -790,6 +831,10 @@ protected:
 		unsigned int iTimeout;
 		unsigned int iRetries;
 
+		// fragment size: in use, largest accepted by peer, currently probed
+		unsigned int iFragmentSize, iPeerMaxFragmentSize, iProbeSize;
+		unsigned int iProbeRetries;
+
 		// statistics
 		int iIRate, iORate, iLoss;
 		CStdCSec StatCSec;
@@ -802,10 +847,12 @@ protected:
 		// initiate connection
 		bool Connect(bool fFailCallback);
 
-		// send something to this computer
-		bool Send(const C4NetIOPacket &rPacket);
+		// send something to this computer (only queue the fragments if pBatch is given)
+		bool Send(const C4NetIOPacket &rPacket, std::vector<C4NetIOPacket> *pBatch = nullptr);
 		// check for lost packets
 		bool Check(bool fForceCheck = true);
+		// try the next bigger fragment size
+		void Probe();
 
 		// called if something from this peer was received
 		void OnRecv(const C4NetIOPacket &Packet);
@@ -843,10 +890,12 @@ protected:
 		// * helpers
 		bool DoConn(bool fMC);
 		bool DoCheck(int iAskCnt = 0, int iMCAskCnt = 0, unsigned int *pAskList = nullptr);
+		void OnProbe(const C4NetIOPacket &rPacket);
 
 		// sending
-		bool SendDirect(const Packet &rPacket, unsigned int iNr = ~0);
+		bool SendDirect(const Packet &rPacket, unsigned int iNr = ~0, std::vector<C4NetIOPacket> *pBatch = nullptr);
 		bool SendDirect(C4NetIOPacket &&rPacket);
+		void PrepareDirect(C4NetIOPacket &rPacket);
 
 		// events
 		void OnConn();
@@ -904,7 +953,9 @@ protected:
 	// helpers
 
 	// sending
-	bool BroadcastDirect(const Packet &rPacket, unsigned int iNr = ~0u); // (mt-safe)
+	bool BroadcastDirect(const Packet &rPacket, unsigned int iNr = ~0u, std::vector<C4NetIOPacket> *pBatch = nullptr); // (mt-safe)
+	bool SendDirectBatch(std::vector<C4NetIOPacket> &Packets, std::vector<addr_t> *pFailedAddrs = nullptr); // (mt-safe)
+	bool PrepareDirect(C4NetIOPacket &rPacket); // set target and count; returns false if the packet should be dropped
 
 	// multicast related
 	bool DoLoopbackTest();
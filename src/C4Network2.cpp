@@ -1105,21 +1105,27 @@ void C4Network2::DrawStatus(C4FacetEx &cgo)
 			Stat.AppendFormat(", Data: %s (%d i%d o%d bc%d)",
 				NetIO.getNetIOName(pDataIO), iDataPort,
 				NetIO.getProtIRate(eDataProt), NetIO.getProtORate(eDataProt), NetIO.getProtBCRate(eDataProt));
+		if (eMsgProt == P_UDP || eDataProt == P_UDP)
+			Stat.AppendFormat("|UDP datagrams per call: in %d.%02d, out %d.%02d",
+				NetIO.getUDPRecvBatch() / 100, NetIO.getUDPRecvBatch() % 100,
+				NetIO.getUDPSendBatch() / 100, NetIO.getUDPSendBatch() % 100);
 	}
 	else
 		Stat.Append("|Protocols: none");
 
 	// some control statistics
-	Stat.AppendFormat("|Control: %s, Tick %d, Behind %d, Rate %d, PreSend %d, ACT: %d",
+	Stat.AppendFormat("|Control: %s, Tick %d, Behind %d, Rate %d, PreSend %d, ACT: %d, P%d: %d ms, late: %d ms",
 		Status.getCtrlMode() == CNM_Decentral ? "Decentral" : Status.getCtrlMode() == CNM_Central ? "Central" : "Async",
 		Game.Control.ControlTick, pControl->GetBehind(Game.Control.ControlTick),
-		Game.Control.ControlRate, pControl->getControlPreSend(), pControl->getAvgControlSendTime());
+		Game.Control.ControlRate, pControl->getControlPreSend(), pControl->getAvgControlSendTime(),
+		C4ControlJitterPercentile, pControl->getControlSendTimePercentile(), pControl->getControlArrivalPercentile());
 
 	// Streaming statistics
 	if (fStreaming)
-		Stat.AppendFormat("|Streaming: %zu waiting, %d in, %zu out, %d sent",
+		Stat.AppendFormat("|Streaming: %zu waiting, %d in, %zu compressing, %zu out, %d sent",
 			pStreamedRecord ? pStreamedRecord->GetStreamingBuf().getSize() : 0,
 			pStreamedRecord ? pStreamedRecord->GetStreamingPos() : 0,
+			StreamCompressor.getQueuedSize(),
 			getPendingStreamData(),
 			iCurrentStreamPosition);
 
@@ -2875,6 +2881,154 @@ void C4Network2::AbortLobbyCountdown()
 
 /* Streaming */
 
+// *** C4Network2StreamCompressor
+
+C4Network2StreamCompressor::C4Network2StreamCompressor()
+	: Compressor{}, iQueueHead{0}, iQueueTail{0},
+	fFlush{false}, fFinish{false}, fFinished{false}, fFailed{false}, fStop{false} {}
+
+C4Network2StreamCompressor::~C4Network2StreamCompressor()
+{
+	Clear();
+}
+
+bool C4Network2StreamCompressor::Init(int iLevel)
+{
+	Clear();
+	// initialize compressor
+	Compressor = {};
+	if (deflateInit(&Compressor, BoundBy(iLevel, 0, 9)) != Z_OK)
+		return false;
+	// create queue
+	Queue.New(C4NetStreamingQueueSize);
+	iQueueHead = iQueueTail = 0;
+	fFlush = fFinish = fFinished = fFailed = fStop = false;
+	// start thread
+	Thread = std::thread{&C4Network2StreamCompressor::Execute, this};
+	return true;
+}
+
+void C4Network2StreamCompressor::Clear()
+{
+	if (!isActive()) return;
+	// stop thread
+	fStop = true;
+	Event.Set();
+	Thread.join();
+	// clear
+	deflateEnd(&Compressor);
+	Queue.Clear();
+	Out.Clear();
+}
+
+size_t C4Network2StreamCompressor::Push(const void *pData, size_t iSize)
+{
+	if (!isActive() || fFinish) return 0;
+	// get free space
+	size_t iHead = iQueueHead.load(std::memory_order_relaxed);
+	size_t iFree = C4NetStreamingQueueSize - (iHead - iQueueTail.load(std::memory_order_acquire));
+	size_t iAmount = std::min(iSize, iFree);
+	if (!iAmount) return 0;
+	// copy (might wrap around)
+	size_t iPos = iHead % C4NetStreamingQueueSize;
+	size_t iPart = std::min(iAmount, C4NetStreamingQueueSize - iPos);
+	Queue.Write(pData, iPart, iPos);
+	if (iPart < iAmount)
+		Queue.Write(static_cast<const char *>(pData) + iPart, iAmount - iPart, 0);
+	// publish
+	iQueueHead.store(iHead + iAmount, std::memory_order_release);
+	Event.Set();
+	return iAmount;
+}
+
+void C4Network2StreamCompressor::Flush()
+{
+	fFlush = true;
+	Event.Set();
+}
+
+void C4Network2StreamCompressor::Finish()
+{
+	fFlush = fFinish = true;
+	Event.Set();
+}
+
+size_t C4Network2StreamCompressor::TakeOut(StdBuf &To)
+{
+	size_t iAmount;
+	{
+		CStdLock OutLock(&OutCSec);
+		iAmount = Out.getSize();
+		if (!iAmount) return 0;
+		To.Append(Out);
+		Out.Clear();
+	}
+	// compressor might be waiting for output space
+	Event.Set();
+	return iAmount;
+}
+
+size_t C4Network2StreamCompressor::getOutSize() const
+{
+	CStdLock OutLock(&OutCSec);
+	return Out.getSize();
+}
+
+void C4Network2StreamCompressor::Execute()
+{
+	while (!fStop && !fFinished && !fFailed)
+	{
+		// check finish flag before looking at the queue, so no input gets lost
+		bool fFinishNow = fFinish;
+		bool fInput = iQueueHead.load(std::memory_order_acquire) != iQueueTail.load(std::memory_order_relaxed);
+		// nothing to do? Also wait while the output isn't picked up
+		// (the queue then fills up, and the record buffers the rest)
+		if ((!fInput && !fFinishNow) || (!fFlush && getOutSize() >= size_t(C4NetStreamingMaxBlockSize)))
+		{
+			Event.WaitFor(1000);
+			continue;
+		}
+		if (!Compress(fFinishNow && !fInput))
+			fFailed = true;
+	}
+}
+
+bool C4Network2StreamCompressor::Compress(bool fFinishNow)
+{
+	// get continuous input block
+	size_t iTail = iQueueTail.load(std::memory_order_relaxed);
+	size_t iAvail = iQueueHead.load(std::memory_order_acquire) - iTail;
+	size_t iPos = iTail % C4NetStreamingQueueSize;
+	size_t iAmount = std::min(iAvail, C4NetStreamingQueueSize - iPos);
+	Compressor.next_in = getMBufPtr<uint8_t>(Queue, iPos);
+	Compressor.avail_in = static_cast<uInt>(iAmount);
+	// compress until all input is consumed (or the stream is finished)
+	uint8_t OutBuf[16 * 1024];
+	int ret;
+	do
+	{
+		Compressor.next_out = OutBuf;
+		Compressor.avail_out = sizeof(OutBuf);
+		ret = deflate(&Compressor, fFinishNow ? Z_FINISH : Z_NO_FLUSH);
+		if (ret != Z_OK && ret != Z_STREAM_END && ret != Z_BUF_ERROR)
+			return false;
+		// save output
+		size_t iOutAmount = sizeof(OutBuf) - Compressor.avail_out;
+		if (iOutAmount)
+		{
+			CStdLock OutLock(&OutCSec);
+			Out.Append(OutBuf, iOutAmount);
+		}
+	} while (fFinishNow ? ret != Z_STREAM_END : !Compressor.avail_out);
+	// free queue space
+	iQueueTail.store(iTail + iAmount - Compressor.avail_in, std::memory_order_release);
+	if (ret == Z_STREAM_END)
+		fFinished = true;
+	return true;
+}
+
+// *** C4Network2 streaming
+
 bool C4Network2::StartStreaming(C4Record *pRecord)
 {
 	// Save back
@@ -2883,15 +3037,10 @@ bool C4Network2::StartStreaming(C4Record *pRecord)
 	iLastStreamAttempt = time(nullptr);
 
 	// Initialize compressor
-	StreamCompressor = {};
-	if (deflateInit(&StreamCompressor, 9) != Z_OK)
+	StreamingBuf.Clear();
+	if (!StreamCompressor.Init(Config.Network.StreamCompressionLevel))
 		return false;
 
-	// Create stream buffer
-	StreamingBuf.New(C4NetStreamingMaxBlockSize);
-	StreamCompressor.next_out = reinterpret_cast<uint8_t *>(StreamingBuf.getMData());
-	StreamCompressor.avail_out = C4NetStreamingMaxBlockSize;
-
 	// Initialize HTTP client
 	pStreamer = new C4Network2HTTPClient();
 	if (!pStreamer->Init())
@@ -2925,7 +3074,7 @@ bool C4Network2::StopStreaming()
 	// Clear
 	fStreaming = false;
 	pStreamedRecord = nullptr;
-	deflateEnd(&StreamCompressor);
+	StreamCompressor.Clear();
 	StreamingBuf.Clear();
 	delete pStreamer;
 	pStreamer = nullptr;
@@ -2936,43 +3085,29 @@ bool C4Network2::StopStreaming()
 
 bool C4Network2::StreamIn(bool fFinish)
 {
-	if (!pStreamedRecord) return false;
+	if (!pStreamedRecord || !StreamCompressor.isActive()) return false;
 
-	// Get data from record
+	// Pass data from record to the compressor thread
 	const StdBuf &Data = pStreamedRecord->GetStreamingBuf();
-	if (!fFinish)
-		if (!Data.getSize() || !StreamCompressor.avail_out)
-			return false;
-
-	do
+	if (fFinish)
+		StreamCompressor.Flush();
+	while (Data.getSize())
 	{
-		// Compress
-		StreamCompressor.next_in = const_cast<uint8_t *>(getBufPtr<uint8_t>(Data));
-		StreamCompressor.avail_in = Data.getSize();
-		int ret = deflate(&StreamCompressor, fFinish ? Z_FINISH : Z_NO_FLUSH);
-
-		// Anything consumed?
-		unsigned int iInAmount = Data.getSize() - StreamCompressor.avail_in;
-		if (iInAmount > 0)
+		size_t iInAmount = StreamCompressor.Push(Data.getData(), Data.getSize());
+		if (iInAmount)
 			pStreamedRecord->ClearStreamingBuf(iInAmount);
-
-		// Done?
-		if (!fFinish || ret == Z_STREAM_END)
+		// Queue full? Record keeps the rest, unless there won't be another chance
+		else if (!fFinish || StreamCompressor.isFailed())
 			break;
+		else
+			std::this_thread::yield();
+	}
 
-		// Error while finishing?
-		if (ret != Z_OK)
-			return false;
-
-		// Enlarge buffer, if neccessary
-		size_t iPending = getPendingStreamData();
-		size_t iGrow = StreamingBuf.getSize();
-		StreamingBuf.Grow(iGrow);
-		StreamCompressor.avail_out += iGrow;
-		StreamCompressor.next_out = getMBufPtr<uint8_t>(StreamingBuf, iPending);
-	} while (true);
+	// Flush everything
+	if (fFinish)
+		StreamCompressor.Finish();
 
-	return true;
+	return !Data.getSize();
 }
 
 bool C4Network2::StreamOut()
@@ -2984,16 +3119,13 @@ bool C4Network2::StreamOut()
 	// Streamer done?
 	if (pStreamer->isSuccess())
 	{
-		// Move new data to front of buffer
-		if (getPendingStreamData() != iCurrentStreamAmount)
-			StreamingBuf.Move(iCurrentStreamAmount, getPendingStreamData() - iCurrentStreamAmount);
-
-		// Free buffer space
-		StreamCompressor.next_out -= iCurrentStreamAmount;
-		StreamCompressor.avail_out += iCurrentStreamAmount;
+		// Remove sent data from buffer
+		StreamingBuf.Move(iCurrentStreamAmount, StreamingBuf.getSize() - iCurrentStreamAmount);
+		StreamingBuf.Shrink(iCurrentStreamAmount);
 
 		// Advance stream
 		iCurrentStreamPosition += iCurrentStreamAmount;
+		iCurrentStreamAmount = 0;
 
 		// Get input
 		StreamIn(false);
@@ -3002,6 +3134,13 @@ bool C4Network2::StreamOut()
 	// Clear streamer
 	pStreamer->Clear();
 
+	// Compressor broke down? Nothing more can be sent
+	if (StreamCompressor.isFailed())
+	{
+		StopStreaming();
+		return false;
+	}
+
 	// Record is still running?
 	if (pStreamedRecord)
 	{
@@ -3013,6 +3152,9 @@ bool C4Network2::StreamOut()
 		if (iLastStreamAttempt && iLastStreamAttempt + C4NetStreamingInterval >= time(nullptr))
 			return false;
 	}
+	// Compressor still flushing? The end marker must go with the last data
+	else if (!StreamCompressor.isFinished())
+		return false;
 	// All data finished?
 	else if (!getPendingStreamData())
 	{
@@ -3021,6 +3163,9 @@ bool C4Network2::StreamOut()
 		return false;
 	}
 
+	// Collect compressed data. The compressor continues with the next block while this one uploads.
+	StreamCompressor.TakeOut(StreamingBuf);
+
 	// Set stream address
 	StdStrBuf StreamAddr;
 	StreamAddr.Copy(Game.Parameters.StreamAddress);
@@ -3028,7 +3173,7 @@ bool C4Network2::StreamOut()
 	pStreamer->SetServer(StreamAddr.getData());
 
 	// Send data
-	size_t iStreamAmount = getPendingStreamData();
+	size_t iStreamAmount = StreamingBuf.getSize();
 	iCurrentStreamAmount = iStreamAmount;
 	iLastStreamAttempt = time(nullptr);
 	return pStreamer->Query(StdBuf::MakeRef(StreamingBuf.getData(), iStreamAmount), false);
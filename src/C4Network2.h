@@ -31,6 +31,9 @@
 #include "C4Control.h"
 #include "C4Gui.h"
 
+#include <atomic>
+#include <thread>
+
 // lobby predef - no need to include lobby in header just for the class ptr
 namespace C4GameLobby { class MainDlg; class Countdown; }
 class C4PacketJoinData;
@@ -66,6 +69,50 @@ const unsigned int C4NetMinVotingInterval = 120; // (s)
 const int C4NetStreamingMinBlockSize = 10 * 1024;
 const int C4NetStreamingMaxBlockSize = 20 * 1024;
 const int C4NetStreamingInterval = 30; // (s)
+const size_t C4NetStreamingQueueSize = 256 * 1024; // (power of two)
+
+// compresses the record stream on a worker thread
+// input is passed through a bounded single-producer/single-consumer byte queue,
+// compressed output is collected until the main thread takes it for sending
+class C4Network2StreamCompressor
+{
+public:
+	C4Network2StreamCompressor();
+	~C4Network2StreamCompressor();
+
+protected:
+	z_stream Compressor;
+	std::thread Thread;
+	CStdEvent Event{false};
+
+	// input queue (written by main thread, read by compressor thread)
+	StdBuf Queue;
+	std::atomic<size_t> iQueueHead, iQueueTail;
+	std::atomic<bool> fFlush, fFinish, fFinished, fFailed, fStop;
+
+	// compressed output
+	StdBuf Out;
+	mutable CStdCSec OutCSec;
+
+public:
+	bool Init(int iLevel); // by main thread
+	void Clear(); // by main thread
+
+	size_t Push(const void *pData, size_t iSize); // by main thread - returns amount queued
+	void Flush(); // by main thread - don't wait for output to be taken anymore
+	void Finish(); // by main thread - no more input, flush everything
+	size_t TakeOut(StdBuf &To); // by main thread - appends compressed data, returns amount
+
+	bool isActive() const { return Thread.joinable(); }
+	bool isFinished() const { return fFinished; }
+	bool isFailed() const { return fFailed; }
+	size_t getQueuedSize() const { return iQueueHead - iQueueTail; }
+	size_t getOutSize() const;
+
+protected:
+	void Execute(); // by compressor thread
+	bool Compress(bool fFinishNow); // by compressor thread
+};
 
 enum C4NetGameState
 {
@@ -201,8 +248,8 @@ protected:
 	bool fStreaming;
 	time_t iLastStreamAttempt;
 	C4Record *pStreamedRecord;
-	StdBuf StreamingBuf;
-	z_stream StreamCompressor;
+	StdBuf StreamingBuf; // compressed data taken from the compressor, not yet confirmed by the server
+	C4Network2StreamCompressor StreamCompressor;
 
 	class C4Network2HTTPClient *pStreamer;
 	unsigned int iCurrentStreamAmount, iCurrentStreamPosition;
@@ -307,7 +354,7 @@ public:
 	void AbortLobbyCountdown();
 
 	// streaming
-	size_t getPendingStreamData() const { return StreamingBuf.getSize() - StreamCompressor.avail_out; }
+	size_t getPendingStreamData() const { return StreamingBuf.getSize() + StreamCompressor.getOutSize(); }
 	bool isStreaming() const;
 	bool StartStreaming(C4Record *pRecord);
 	bool FinishStreaming();
@@ -53,7 +53,8 @@ C4Network2IO::C4Network2IO()
 	pAutoAcceptList(nullptr),
 	iLastPing(0), iLastExecute(0), iLastStatistic(0),
 	iTCPIRate(0), iTCPORate(0), iTCPBCRate(0),
-	iUDPIRate(0), iUDPORate(0), iUDPBCRate(0)
+	iUDPIRate(0), iUDPORate(0), iUDPBCRate(0),
+	iUDPRecvBatch(0), iUDPSendBatch(0)
 {
 }
 
@@ -71,6 +72,7 @@ bool C4Network2IO::Init(int16_t iPortTCP, int16_t iPortUDP, int16_t iPortDiscove
 	iLastPing = iLastStatistic = timeGetTime();
 	iTCPIRate = iTCPORate = iTCPBCRate = 0;
 	iUDPIRate = iUDPORate = iUDPBCRate = 0;
+	iUDPRecvBatch = iUDPSendBatch = 0;
 
 	// init event callback
 	C4InteractiveThread &Thread = Application.InteractiveThread;
@@ -399,11 +401,13 @@ void C4Network2IO::EndBroadcast()
 bool C4Network2IO::Broadcast(const C4NetIOPacket &rPkt)
 {
 	bool fSuccess = true;
+	// serialize once, share the data between all connections
+	C4NetIOPacket Pkt(rPkt); Pkt.Share();
 	// There is no broadcasting atm, emulate it
 	CStdLock ConnListLock(&ConnListCSec);
 	for (C4Network2IOConnection *pConn = pConnList; pConn; pConn = pConn->pNext)
 		if (pConn->isOpen() && pConn->isBroadcastTarget())
-			fSuccess &= pConn->Send(rPkt);
+			fSuccess &= pConn->Send(Pkt);
 	assert(fSuccess);
 	return fSuccess;
 }
@@ -1196,9 +1200,9 @@ void C4Network2IO::GenerateStatistics(int iInterval)
 	ConnListLock.Clear();
 
 	// get broadcast statistics
-	int inTCPBCRate = 0, inUDPBCRate = 0;
+	int inTCPBCRate = 0, inUDPBCRate = 0, inUDPRecvBatch = 0, inUDPSendBatch = 0;
 	if (pNetIO_TCP) pNetIO_TCP->GetStatistic(&inTCPBCRate);
-	if (pNetIO_UDP) pNetIO_UDP->GetStatistic(&inUDPBCRate);
+	if (pNetIO_UDP) pNetIO_UDP->GetStatistic(&inUDPBCRate, &inUDPRecvBatch, &inUDPSendBatch);
 
 	// normalize everything
 	iTCPIRateSum = iTCPIRateSum * 1000 / iInterval;
@@ -1215,6 +1219,7 @@ void C4Network2IO::GenerateStatistics(int iInterval)
 	// save back
 	iTCPIRate = iTCPIRateSum; iTCPORate = iTCPORateSum; iTCPBCRate = inTCPBCRate;
 	iUDPIRate = iUDPIRateSum; iUDPORate = iUDPORateSum; iUDPBCRate = inUDPBCRate;
+	iUDPRecvBatch = inUDPRecvBatch; iUDPSendBatch = inUDPSendBatch;
 }
 
 void C4Network2IO::SendConnPackets()
@@ -1262,7 +1267,7 @@ C4Network2IOConnection::C4Network2IOConnection()
 	iPingTime(-1),
 	iLastPing(~0), iLastPong(~0),
 	iOutPacketCounter(0), iInPacketCounter(0),
-	pPacketLog(nullptr),
+	iPacketLogStart(0), iPacketLogCnt(0),
 	pNext(nullptr),
 	iRefCnt(0),
 	fConnSent(false),
@@ -1365,23 +1370,27 @@ void C4Network2IOConnection::OnPacketReceived(uint8_t iPacketType)
 
 void C4Network2IOConnection::ClearPacketLog(uint32_t iUntilID)
 {
-	// Search position of first packet to delete
-	PacketLogEntry *pPos, *pPrev = nullptr;
-	for (pPos = pPacketLog; pPos; pPrev = pPos, pPos = pPos->Next)
-		if (pPos->Number < iUntilID)
-			break;
-	if (pPos)
+	// Remove oldest packets
+	while (iPacketLogCnt && getPacketLogEntry(0).Number < iUntilID)
 	{
-		// Remove packets from list
-		(pPrev ? pPrev->Next : pPacketLog) = nullptr;
-		// Delete everything
-		while (pPos)
-		{
-			PacketLogEntry *pDelete = pPos;
-			pPos = pPos->Next;
-			delete pDelete;
-		}
+		getPacketLogEntry(0).Pkt.Clear();
+		iPacketLogStart = (iPacketLogStart + 1) % PacketLog.size();
+		iPacketLogCnt--;
+	}
+}
+
+C4Network2IOConnection::PacketLogEntry &C4Network2IOConnection::AddPacketLogEntry()
+{
+	if (iPacketLogCnt == PacketLog.size())
+	{
+		// Full? Grow (never drop packets: the post mortem might need them)
+		std::vector<PacketLogEntry> NewLog(std::max<size_t>(PacketLog.size() * 2, 64));
+		for (size_t i = 0; i < iPacketLogCnt; i++)
+			NewLog[i] = std::move(getPacketLogEntry(i));
+		PacketLog.swap(NewLog);
+		iPacketLogStart = 0;
 	}
+	return getPacketLogEntry(iPacketLogCnt++);
 }
 
 bool C4Network2IOConnection::CreatePostMortem(C4PacketPostMortem *pPkt)
@@ -1390,15 +1399,15 @@ bool C4Network2IOConnection::CreatePostMortem(C4PacketPostMortem *pPkt)
 	if (!pPkt) return false;
 	CStdLock PacketLogLock(&PacketLogCSec);
 	// Nothing to do?
-	if (!pPacketLog) return false;
+	if (!iPacketLogCnt) return false;
 	// Already created?
 	if (fPostMortemSent) return false;
 	// Set connection ID and packet counter
 	pPkt->SetConnID(iRemoteID);
 	pPkt->SetPacketCounter(iOutPacketCounter);
-	// Add packets
-	for (PacketLogEntry *pEntry = pPacketLog; pEntry; pEntry = pEntry->Next)
-		pPkt->Add(pEntry->Pkt);
+	// Add packets (newest first)
+	for (size_t i = iPacketLogCnt; i--; )
+		pPkt->Add(getPacketLogEntry(i).Pkt);
 	// Okay
 	fPostMortemSent = true;
 	return true;
@@ -1442,12 +1451,11 @@ bool C4Network2IOConnection::Send(const C4NetIOPacket &rPkt)
 		return pNetClass->Send(Copy);
 	}
 	CStdLock PacketLogLock(&PacketLogCSec);
-	// create log entry
-	PacketLogEntry *pLogEntry = new PacketLogEntry();
+	// create log entry (sharing the data with the net i/o class)
+	PacketLogEntry *pLogEntry = &AddPacketLogEntry();
 	pLogEntry->Number = iOutPacketCounter++;
 	pLogEntry->Pkt = rPkt;
-	pLogEntry->Next = pPacketLog;
-	pPacketLog = pLogEntry;
+	pLogEntry->Pkt.Share();
 	// set address
 	pLogEntry->Pkt.SetAddr(PeerAddr);
 	// closed? No sweat, post mortem will reroute it later.
@@ -1458,6 +1466,15 @@ bool C4Network2IOConnection::Send(const C4NetIOPacket &rPkt)
 		// okay then
 		return true;
 	}
+	// Peer doesn't acknowledge anymore? Give up the connection instead of
+	// growing the log forever. The packet stays logged for the post mortem.
+	if (iPacketLogCnt > C4NetMaxPacketLog)
+	{
+		PacketLogLock.Clear();
+		Application.InteractiveThread.ThreadLogS("Network: %d packets to %s not acknowledged, closing connection", C4NetMaxPacketLog, PeerAddr.ToString().getData());
+		Close();
+		return true;
+	}
 	// send
 	bool fSuccess = pNetClass->Send(pLogEntry->Pkt);
 	if (fSuccess)
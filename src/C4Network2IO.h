@@ -23,6 +23,7 @@
 #include "C4PuncherPacket.h"
 
 #include <atomic>
+#include <vector>
 
 class C4Network2IOConnection;
 
@@ -36,7 +37,8 @@ const int C4NetTimer = 500, // ms
           C4NetPingFreq = 1000, // ms
           C4NetStatisticsFreq = 1000, // ms
           C4NetAcceptTimeout = 10, // s
-          C4NetPingTimeout = 30000; // ms
+          C4NetPingTimeout = 30000, // ms
+          C4NetMaxPacketLog = 16384; // packets not yet acknowledged (per connection) before the connection is closed
 
 // client count
 const int C4NetMaxClients = 256;
@@ -93,6 +95,7 @@ protected:
 	unsigned long iLastStatistic;
 	int iTCPIRate, iTCPORate, iTCPBCRate,
 		iUDPIRate, iUDPORate, iUDPBCRate;
+	int iUDPRecvBatch, iUDPSendBatch; // datagrams per system call (in hundredths)
 
 	// punching
 	C4NetIO::addr_t PuncherAddrIPv4, PuncherAddrIPv6;
@@ -147,6 +150,8 @@ public:
 	int getProtIRate (C4Network2IOProtocol eProt) const { return eProt == P_TCP ? iTCPIRate  : iUDPIRate; }
 	int getProtORate (C4Network2IOProtocol eProt) const { return eProt == P_TCP ? iTCPORate  : iUDPORate; }
 	int getProtBCRate(C4Network2IOProtocol eProt) const { return eProt == P_TCP ? iTCPBCRate : iUDPBCRate; }
+	int getUDPRecvBatch() const { return iUDPRecvBatch; }
+	int getUDPSendBatch() const { return iUDPSendBatch; }
 
 	// reference
 	void SetReference(class C4Network2Reference *pReference);
@@ -243,10 +248,13 @@ protected:
 	{
 		uint32_t Number;
 		C4NetIOPacket Pkt;
-		PacketLogEntry *Next;
 	};
-	PacketLogEntry *pPacketLog;
+	// ring buffer (oldest entry first); the connection is closed once it exceeds C4NetMaxPacketLog entries
+	std::vector<PacketLogEntry> PacketLog;
+	size_t iPacketLogStart, iPacketLogCnt;
 	CStdCSec PacketLogCSec;
+	PacketLogEntry &getPacketLogEntry(size_t i) { return PacketLog[(iPacketLogStart + i) % PacketLog.size()]; }
+	PacketLogEntry &AddPacketLogEntry();
 
 	// list (C4Network2IO)
 	C4Network2IOConnection *pNext;
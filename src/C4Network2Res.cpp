@@ -24,11 +24,15 @@
 #include <C4Components.h>
 #include <C4Game.h>
 
+#include <algorithm>
 #include <fcntl.h>
 #include <sys/types.h>
 #include <sys/stat.h>
 #ifdef _WIN32
 #include <direct.h>
+#include <sys/utime.h>
+#else
+#include <utime.h>
 #endif
 #include <errno.h>
 
@@ -77,7 +81,7 @@ C4Network2ResCore::C4Network2ResCore()
 	fLoadable(false),
 	iFileSize(~0u), iFileCRC(~0u), iContentsCRC(~0u),
 	iChunkSize(C4NetResChunkSize),
-	fHasFileSHA(false) {}
+	fHasFileSHA(false), fHasChunkSHA(false) {}
 
 void C4Network2ResCore::Set(C4Network2ResType enType, int32_t iResID, const char *strFileName, uint32_t inContentsCRC, const char *strAuthor)
 {
@@ -86,17 +90,41 @@ void C4Network2ResCore::Set(C4Network2ResType enType, int32_t iResID, const char
 	fLoadable = false;
 	iFileSize = iFileCRC = ~0; iContentsCRC = inContentsCRC;
 	iChunkSize = C4NetResChunkSize;
+	ClearChunkSHA();
 	FileName.Copy(strFileName);
 	Author.Copy(strAuthor);
 }
 
 void C4Network2ResCore::SetLoadable(uint32_t iSize, uint32_t iCRC)
 {
+	// chunk hashes belong to another version of the file?
+	if (iSize != iFileSize || iCRC != iFileCRC)
+		ClearChunkSHA();
 	fLoadable = true;
 	iFileSize = iSize;
 	iFileCRC = iCRC;
 }
 
+void C4Network2ResCore::SetChunkSHA(StdBuf &&Hashes)
+{
+	assert(Hashes.getSize() == getChunkCnt() * StdSha1::DigestLength);
+	ChunkSHA = std::move(Hashes);
+	fHasChunkSHA = true;
+}
+
+bool C4Network2ResCore::CheckChunkSHA(uint32_t iChunk, const StdBuf &Data) const
+{
+	if (!fHasChunkSHA) return true;
+	if (iChunk >= getChunkCnt()) return false;
+	// calculate hash
+	uint8_t Hash[StdSha1::DigestLength];
+	StdSha1 Sha1;
+	Sha1.Update(Data.getData(), Data.getSize());
+	Sha1.GetHash(Hash);
+	// compare
+	return !memcmp(Hash, ChunkSHA.getPtr(iChunk * StdSha1::DigestLength), StdSha1::DigestLength);
+}
+
 void C4Network2ResCore::Clear()
 {
 	eType = NRT_Null;
@@ -106,6 +134,7 @@ void C4Network2ResCore::Clear()
 	Author.Clear();
 	iFileSize = iFileCRC = iContentsCRC = ~0;
 	fHasFileSHA = false;
+	ClearChunkSHA();
 }
 
 // C4PacketBase virtuals
@@ -122,7 +151,16 @@ void C4Network2ResCore::CompileFunc(StdCompiler *pComp)
 		pComp->Value(mkNamingAdapt(iFileCRC,   "FileCRC",   0U));
 		pComp->Value(mkNamingAdapt(iChunkSize, "ChunkSize", C4NetResChunkSize));
 		if (!iChunkSize) pComp->excCorrupt("zero chunk size");
+		pComp->Value(mkNamingCountAdapt(fHasChunkSHA, "ChunkSHA"));
+		if (fHasChunkSHA)
+		{
+			if (getChunkCnt() > C4NetResMaxChunkSHACnt) pComp->excCorrupt("too many chunk hashes");
+			if (pComp->isCompiler()) ChunkSHA.New(getChunkCnt() * StdSha1::DigestLength);
+			pComp->Value(mkNamingAdapt(mkHexAdapt(ChunkSHA.getMData(), ChunkSHA.getSize()), "ChunkSHA"));
+		}
 	}
+	else if (pComp->isCompiler())
+		ClearChunkSHA();
 	pComp->Value(mkNamingAdapt(iContentsCRC,     "ContentsCRC", 0U));
 	pComp->Value(mkNamingCountAdapt(fHasFileSHA, "FileSHA"));
 	if (fHasFileSHA)
@@ -133,14 +171,72 @@ void C4Network2ResCore::CompileFunc(StdCompiler *pComp)
 
 // *** C4Network2ResLoad
 
-C4Network2ResLoad::C4Network2ResLoad(int32_t inChunk, int32_t inByClient)
-	: iChunk(inChunk), iByClient(inByClient), Timestamp(time(nullptr)), pNext(nullptr) {}
+C4Network2ResLoad::C4Network2ResLoad(int32_t inChunk, int32_t inByClient, uint32_t inTimeout, uint64_t inDelivered)
+	: iChunk(inChunk), iRequestTime(timeGetTime()), iTimeout(inTimeout), iDeliveredAtRequest(inDelivered),
+	iByClient(inByClient), pNext(nullptr) {}
 
 C4Network2ResLoad::~C4Network2ResLoad() {}
 
 bool C4Network2ResLoad::CheckTimeout()
 {
-	return difftime(time(nullptr), Timestamp) >= C4NetResLoadTimeout;
+	return timeGetTime() - iRequestTime >= iTimeout;
+}
+
+// *** C4Network2ResSource
+
+C4Network2ResSource::C4Network2ResSource(int32_t inClientID)
+	: iClientID(inClientID), iDelivered(0),
+	iSRTT(0), iMinRTT(0), iMinRTTTime(0),
+	iBandwidthSample(0), pNext(nullptr)
+{
+	std::fill_n(Bandwidth, C4NetResBandwidthSamples, 0);
+}
+
+uint32_t C4Network2ResSource::getBandwidth() const
+{
+	return *std::max_element(Bandwidth, Bandwidth + C4NetResBandwidthSamples);
+}
+
+int32_t C4Network2ResSource::getLoadWindow(uint32_t iChunkSize) const
+{
+	// nothing measured yet?
+	uint32_t iBandwidth = getBandwidth();
+	if (!iBandwidth || !iMinRTT || !iChunkSize) return C4NetResInitialLoadWindow;
+	// keep twice the bandwidth-delay product in flight, plus the chunk currently being received
+	uint64_t iBDP = uint64_t(iBandwidth) * iMinRTT / 1000;
+	return int32_t(BoundBy<uint64_t>(2 * iBDP / iChunkSize + 1, C4NetResMinLoadWindow, C4NetResMaxLoadWindow));
+}
+
+uint32_t C4Network2ResSource::getLoadTimeout() const
+{
+	if (!iSRTT) return C4NetResLoadTimeout * 1000;
+	return BoundBy<uint32_t>(4 * iSRTT, C4NetResMinLoadTimeout * 1000, C4NetResLoadTimeout * 1000);
+}
+
+void C4Network2ResSource::OnChunk(const C4Network2ResLoad &Load, uint32_t iSize)
+{
+	unsigned long iTime = timeGetTime();
+	uint32_t iRTT = (std::max)(uint32_t(iTime - Load.iRequestTime), 1u);
+	iDelivered += iSize;
+	// round trip times
+	iSRTT = iSRTT ? (7 * iSRTT + iRTT) / 8 : iRTT;
+	if (!iMinRTT || iRTT <= iMinRTT || iTime - iMinRTTTime > uint32_t(C4NetResMinRTTExpiry))
+	{
+		iMinRTT = iRTT;
+		iMinRTTTime = iTime;
+	}
+	// delivery rate: everything that arrived since the request was sent
+	uint64_t iRate = (iDelivered - Load.iDeliveredAtRequest) * 1000 / iRTT;
+	Bandwidth[iBandwidthSample] = uint32_t((std::min)(iRate, uint64_t(UINT32_MAX)));
+	iBandwidthSample = (iBandwidthSample + 1) % C4NetResBandwidthSamples;
+}
+
+void C4Network2ResSource::OnLoadTimeout()
+{
+	// back off
+	for (int32_t i = 0; i < C4NetResBandwidthSamples; i++)
+		Bandwidth[i] /= 2;
+	iSRTT = 0;
 }
 
 // *** C4Network2ResChunkData
@@ -240,7 +336,7 @@ void C4Network2ResChunkData::Clear()
 	}
 }
 
-int32_t C4Network2ResChunkData::GetChunkToRetrieve(const C4Network2ResChunkData &Available, int32_t iLoadingCnt, int32_t *pLoading) const
+int32_t C4Network2ResChunkData::GetChunkToRetrieve(const C4Network2ResChunkData &Available, int32_t iLoadingCnt, const int32_t *pLoading, const int32_t *pSourceCnt) const
 {
 	// (this version is highly calculation-intensitive, yet the most satisfactory
 	//  solution I could find)
@@ -255,9 +351,27 @@ int32_t C4Network2ResChunkData::GetChunkToRetrieve(const C4Network2ResChunkData
 	// invert to get everything that should be retrieved
 	C4Network2ResChunkData ChData2; ChData.GetNegative(ChData2);
 	// select chunk (random)
-	int32_t iRetrieveChunk = SafeRandom(ChData2.getPresentChunkCnt());
+	if (!pSourceCnt)
+		return ChData2.getPresentChunk(SafeRandom(ChData2.getPresentChunkCnt()));
+	// select chunk (rarest first, random among equally rare ones)
+	int32_t iRetrieveChunk = -1, iMinSourceCnt = 0, iMinCnt = 0;
+	for (ChunkRange *pRange = ChData2.pChunkRanges; pRange; pRange = pRange->Next)
+		for (int32_t i = pRange->Start; i < pRange->Start + pRange->Length; i++)
+			if (iRetrieveChunk < 0 || pSourceCnt[i] < iMinSourceCnt)
+			{
+				iRetrieveChunk = i; iMinSourceCnt = pSourceCnt[i]; iMinCnt = 1;
+			}
+			else if (pSourceCnt[i] == iMinSourceCnt && !SafeRandom(++iMinCnt))
+				iRetrieveChunk = i;
 	// return
-	return ChData2.getPresentChunk(iRetrieveChunk);
+	return iRetrieveChunk;
+}
+
+void C4Network2ResChunkData::AddPresentTo(std::vector<int32_t> &Counts) const
+{
+	for (ChunkRange *pRange = pChunkRanges; pRange; pRange = pRange->Next)
+		for (int32_t i = pRange->Start; i < pRange->Start + pRange->Length && i < int32_t(Counts.size()); i++)
+			Counts[i]++;
 }
 
 bool C4Network2ResChunkData::MergeRanges(ChunkRange *pRange)
@@ -347,6 +461,7 @@ C4Network2Res::C4Network2Res(C4Network2ResList *pnParent)
 	iLastReqTime(0),
 	fLoading(false),
 	pCChunks(nullptr), iDiscoverStartTime(0), pLoads(nullptr), iLoadCnt(0),
+	fChunkSourceCntDirty(true),
 	pNext(nullptr),
 	pParent(pnParent)
 {
@@ -394,6 +509,39 @@ bool C4Network2Res::SetByFile(const char *strFilePath, bool fTemp, C4Network2Res
 	return true;
 }
 
+bool C4Network2Res::SetByCache(const C4Network2ResCore &nCore, const char *szCacheFile) // by main thread
+{
+	Clear();
+	CStdLock FileLock(&FileCSec);
+	// must be loadable
+	if (!nCore.isLoadable()) return false;
+	// copy to a temporary file, the cached one must not be changed
+	if (!pParent->FindTempResFileName(nCore.getFileName(), szFile))
+		return false;
+	if (!CopyFile(szCacheFile, szFile, false))
+	{
+		szFile[0] = '\0'; return false;
+	}
+	fTempFile = true;
+	// check
+	uint32_t iCRC32;
+	if (FileSize(szFile) != nCore.getFileSize() || !C4Group_GetFileCRC(szFile, &iCRC32) || iCRC32 != nCore.getFileCRC())
+	{
+		Clear(); return false;
+	}
+	// set core, file is complete and binary compatible
+	Core = nCore;
+	Chunks.SetComplete(Core.getChunkCnt());
+	SCopy(szFile, szStandalone, sizeof(szStandalone) - 1);
+	// set flags
+	fDirty = true;
+	fStandaloneFailed = false;
+	fRemoved = false;
+	iLastReqTime = time(nullptr);
+	fLoading = false;
+	return true;
+}
+
 bool C4Network2Res::SetByGroup(C4Group *pGrp, bool fTemp, C4Network2ResType eType, int32_t iResID, const char *szResName, bool fSilent) // by main thread
 {
 	Clear();
@@ -676,6 +824,10 @@ bool C4Network2Res::GetStandalone(char *pTo, int32_t iMaxL, bool fSetOfficial, b
 	fStandaloneFailed = false;
 	// mark resource as loadable and safe file information
 	Core.SetLoadable(iSize, iCRC32);
+	// hash chunks, so loaders can verify them one by one
+	if (fSetOfficial && !Core.hasChunkSHA())
+		if (!CalculateChunkSHA())
+			if (!fSilent) Log("GetStandalone: could not calculate chunk hashes!");
 	// set up chunk data
 	Chunks.SetComplete(Core.getChunkCnt());
 	// ok
@@ -700,6 +852,33 @@ bool C4Network2Res::CalculateSHA()
 	return true;
 }
 
+bool C4Network2Res::CalculateChunkSHA()
+{
+	// open file
+	int32_t f = open(szStandalone, _O_BINARY | O_RDONLY);
+	if (f == -1) return false;
+	// hash every chunk
+	const uint32_t iChunkCnt = Core.getChunkCnt();
+	if (iChunkCnt > C4NetResMaxChunkSHACnt) { close(f); return false; }
+	StdBuf Hashes; Hashes.New(iChunkCnt * StdSha1::DigestLength);
+	StdBuf Data; Data.New(Core.getChunkSize());
+	for (uint32_t i = 0; i < iChunkCnt; i++)
+	{
+		const int32_t iSize = (std::min)(Core.getFileSize() - i * Core.getChunkSize(), Core.getChunkSize());
+		if (read(f, Data.getMData(), iSize) != iSize)
+		{
+			close(f); return false;
+		}
+		StdSha1 Sha1;
+		Sha1.Update(Data.getData(), iSize);
+		Sha1.GetHash(Hashes.getMPtr(i * StdSha1::DigestLength));
+	}
+	close(f);
+	// save them
+	Core.SetChunkSHA(std::move(Hashes));
+	return true;
+}
+
 C4Network2Res::Ref C4Network2Res::Derive()
 {
 	// Called before the file is changed. Rescues all files and creates a
@@ -889,6 +1068,7 @@ void C4Network2Res::OnStatus(const C4Network2ResChunkData &rChunkData, C4Network
 	}
 	pChunks->ClientID = pBy->getClientID();
 	pChunks->Chunks = rChunkData;
+	fChunkSourceCntDirty = true;
 	// load?
 	if (fLoading) StartLoad(pChunks->ClientID, pChunks->Chunks);
 }
@@ -898,6 +1078,23 @@ void C4Network2Res::OnChunk(const C4Network2ResChunk &rChunk)
 	if (!fLoading) return;
 	// correct ressource?
 	if (rChunk.getResID() != getResID()) return;
+	// verify before anything is written
+	if (!Core.CheckChunkSHA(rChunk.getChunkNr(), rChunk.getData()))
+	{
+		Application.InteractiveThread.ThreadLogS("Network: Res: chunk %u of %s is corrupt, requesting it again", rChunk.getChunkNr(), Core.getFileName());
+		// drop the load wait, so the chunk is requested again right away
+		for (C4Network2ResLoad *pLoad = pLoads, *pNext; pLoad; pLoad = pNext)
+		{
+			pNext = pLoad->Next();
+			if (pLoad->getChunk() == int32_t(rChunk.getChunkNr()))
+			{
+				pParent->OnLoadTimeout(*pLoad);
+				RemoveLoad(pLoad);
+			}
+		}
+		StartNewLoads();
+		return;
+	}
 	// add ressource data
 	CStdLock FileLock(&FileCSec);
 	bool fSuccess = rChunk.AddTo(this, pParent->getIOClass());
@@ -914,11 +1111,14 @@ void C4Network2Res::OnChunk(const C4Network2ResChunk &rChunk)
 		{
 			pNext = pLoad->Next();
 			if (pLoad->getChunk() == rChunk.getChunkNr())
+			{
+				pParent->OnLoadChunk(*pLoad, rChunk.getSize());
 				RemoveLoad(pLoad);
+			}
 		}
 	}
 	// complete?
-	if (Chunks.isComplete())
+	if (Chunks.isComplete() && VerifyLoad())
 		EndLoad();
 	// check: start new loads?
 	else
@@ -938,12 +1138,13 @@ bool C4Network2Res::DoLoad()
 			pNext = pLoad->Next();
 			if (pLoad->CheckTimeout())
 			{
+				pParent->OnLoadTimeout(*pLoad);
 				RemoveLoad(pLoad);
 				iLoadsRemoved++;
 			}
 		}
-		// start new loads
-		if (iLoadsRemoved) StartNewLoads();
+		// start new loads (windows might have grown by chunks of other ressources, too)
+		StartNewLoads();
 	}
 	else
 	{
@@ -1053,21 +1254,14 @@ bool C4Network2Res::StartLoad(int32_t iFromClient, const C4Network2ResChunkData
 	assert(pParent && pParent->getIOClass());
 	// all slots used? ignore
 	if (iLoadCnt + 1 >= C4NetResMaxLoad) return true;
-	int32_t loadsAtClient = 0;
-	// are there already enough loads by this client? ignore
-	for (C4Network2ResLoad *pPos = pLoads; pPos; pPos = pPos->Next())
-	{
-		if (pPos->getByClient() == iFromClient)
-		{
-			if (++loadsAtClient >= C4NetResMaxLoadPerPeerPerFile)
-				return true;
-		}
-	}
+	// is the load window of this client full? ignore
+	if (!pParent->CanStartLoad(iFromClient, Core.getChunkSize())) return true;
 	// find chunk to retrieve
-	int32_t iLoads[C4NetResMaxLoad]; int32_t i = 0;
+	std::vector<int32_t> Loads;
 	for (C4Network2ResLoad *pLoad = pLoads; pLoad; pLoad = pLoad->Next())
-		iLoads[i++] = pLoad->getChunk();
-	int32_t iRetrieveChunk = Chunks.GetChunkToRetrieve(Available, i, iLoads);
+		Loads.push_back(pLoad->getChunk());
+	UpdateChunkSourceCnt();
+	int32_t iRetrieveChunk = Chunks.GetChunkToRetrieve(Available, Loads.size(), Loads.data(), ChunkSourceCnt.data());
 	// nothing? ignore
 	if (iRetrieveChunk < 0 || (uint32_t)iRetrieveChunk >= Core.getChunkCnt())
 		return true;
@@ -1086,7 +1280,7 @@ bool C4Network2Res::StartLoad(int32_t iFromClient, const C4Network2ResChunkData
 		iRetrieveChunk, Core.getID(), Core.getFileName(), szFile, iFromClient);
 #endif
 	// create load class
-	C4Network2ResLoad *pnLoad = new C4Network2ResLoad(iRetrieveChunk, iFromClient);
+	C4Network2ResLoad *pnLoad = pParent->CreateLoad(iRetrieveChunk, iFromClient);
 	// add to list
 	pnLoad->pNext = pLoads;
 	pLoads = pnLoad;
@@ -1106,6 +1300,21 @@ void C4Network2Res::EndLoad()
 	pParent->OnResComplete(this);
 }
 
+bool C4Network2Res::VerifyLoad()
+{
+	// every chunk has been checked on arrival?
+	if (Core.hasChunkSHA()) return true;
+	// otherwise, the whole file has to match
+	uint32_t iCRC32;
+	if (C4Group_GetFileCRC(szFile, &iCRC32) && iCRC32 == Core.getFileCRC())
+		return true;
+	Application.InteractiveThread.ThreadLogS("Network: Res: %s is corrupt, loading it again", Core.getFileName());
+	// start over
+	Chunks.SetIncomplete(Core.getChunkCnt());
+	fDirty = true;
+	return false;
+}
+
 void C4Network2Res::ClearLoad()
 {
 	// remove client chunks and loads
@@ -1113,6 +1322,8 @@ void C4Network2Res::ClearLoad()
 	while (pCChunks) RemoveCChunks(pCChunks);
 	while (pLoads) RemoveLoad(pLoads);
 	iDiscoverStartTime = iLoadCnt = 0;
+	ChunkSourceCnt.clear();
+	fChunkSourceCntDirty = true;
 }
 
 void C4Network2Res::RemoveLoad(C4Network2ResLoad *pLoad)
@@ -1148,6 +1359,25 @@ void C4Network2Res::RemoveCChunks(ClientChunks *pChunks)
 	}
 	// delete
 	delete pChunks;
+	fChunkSourceCntDirty = true;
+}
+
+void C4Network2Res::UpdateChunkSourceCnt()
+{
+	if (!fChunkSourceCntDirty) return;
+	ChunkSourceCnt.assign(Chunks.getChunkCnt(), 0);
+	for (ClientChunks *pChunks = pCChunks; pChunks; pChunks = pChunks->Next)
+		pChunks->Chunks.AddPresentTo(ChunkSourceCnt);
+	fChunkSourceCntDirty = false;
+}
+
+int32_t C4Network2Res::getLoadCnt(int32_t iByClient) const
+{
+	int32_t iCnt = 0;
+	for (C4Network2ResLoad *pLoad = pLoads; pLoad; pLoad = pLoad->Next())
+		if (pLoad->getByClient() == iByClient)
+			iCnt++;
+	return iCnt;
 }
 
 bool C4Network2Res::OptimizeStandalone(bool fSilent)
@@ -1308,6 +1538,169 @@ void C4Network2ResChunk::CompileFunc(StdCompiler *pComp)
 	pComp->Value(mkNamingAdapt(Data, "Data"));
 }
 
+// *** C4Network2ResCache
+
+C4Network2ResCache::C4Network2ResCache()
+	: fStop{false}
+{
+	szPath[0] = '\0';
+}
+
+C4Network2ResCache::~C4Network2ResCache()
+{
+	Clear();
+}
+
+bool C4Network2ResCache::Init() // by main thread
+{
+	Clear();
+	CStdLock CacheLock(&CacheCSec);
+	szPath[0] = '\0';
+	if (Config.Network.ResCacheSize <= 0) return false;
+	// create folder
+	char szCachePath[_MAX_PATH + 1];
+	SCopy(Config.AtUserPath(C4CFN_NetResCache), szCachePath, _MAX_PATH);
+	if (!DirectoryExists(szCachePath) && !CreateDirectory(szCachePath, nullptr))
+	{
+		LogSilentF("Network: could not create ressource cache %s!", szCachePath); return false;
+	}
+	SCopy(szCachePath, szPath, _MAX_PATH);
+	AppendBackslash(szPath);
+	// the limit might have been lowered
+	Shrink(uint64_t(Config.Network.ResCacheSize) * 1024 * 1024);
+	// start worker (not by Add: the thread object would be shared with Clear)
+	Thread = std::thread{&C4Network2ResCache::Execute, this};
+	return true;
+}
+
+bool C4Network2ResCache::Find(const C4Network2ResCore &Core, char *pTarget) // by both
+{
+	CStdLock CacheLock(&CacheCSec);
+	if (!szPath[0] || !Core.isLoadable()) return false;
+	GetFilename(Core, pTarget);
+	if (!FileExists(pTarget) || FileSize(pTarget) != Core.getFileSize()) return false;
+	// mark as recently used
+#ifdef _WIN32
+	_utime(pTarget, nullptr);
+#else
+	utime(pTarget, nullptr);
+#endif
+	return true;
+}
+
+void C4Network2ResCache::Clear() // by main thread
+{
+	// no more jobs
+	{
+		CStdLock CacheLock(&CacheCSec);
+		szPath[0] = '\0';
+	}
+	if (Thread.joinable())
+	{
+		// a copy in progress is finished
+		fStop = true;
+		Event.Set();
+		Thread.join();
+	}
+	fStop = false;
+	CStdLock JobLock(&JobCSec);
+	Jobs.clear();
+}
+
+void C4Network2ResCache::Add(C4Network2Res *pRes) // by network thread
+{
+	// the lock is held while queueing, so Clear can't drop the worker meanwhile
+	CStdLock CacheLock(&CacheCSec);
+	if (!szPath[0] || !pRes->getCore().isLoadable()) return;
+	CStdLock JobLock(&JobCSec);
+	Jobs.push_back({pRes->getCore(), pRes, StdStrBuf(pRes->getFile(), true)});
+	Event.Set();
+}
+
+void C4Network2ResCache::Execute() // by worker thread
+{
+	while (!fStop)
+	{
+		// get next job
+		Job CurrJob;
+		{
+			CStdLock JobLock(&JobCSec);
+			if (!Jobs.empty())
+			{
+				CurrJob = std::move(Jobs.front());
+				Jobs.erase(Jobs.begin());
+			}
+		}
+		if (!CurrJob.File.getLength())
+		{
+			Event.WaitFor(1000);
+			continue;
+		}
+		Store(CurrJob.Core, CurrJob.File.getData());
+	}
+}
+
+bool C4Network2ResCache::Store(const C4Network2ResCore &Core, const char *szFile) // by worker thread
+{
+	const uint64_t iMaxSize = uint64_t(Config.Network.ResCacheSize) * 1024 * 1024;
+	if (Core.getFileSize() > iMaxSize) return false;
+	// already there?
+	char szTarget[_MAX_PATH + 1];
+	{
+		CStdLock CacheLock(&CacheCSec);
+		if (!szPath[0]) return false;
+		GetFilename(Core, szTarget);
+	}
+	if (Find(Core, szTarget)) return true;
+	// copy using a temporary name, so an incomplete file is never found
+	// (the lock isn't held meanwhile, so lookups don't wait for the copy)
+	char szTemp[_MAX_PATH + 1];
+	SCopy(szTarget, szTemp, _MAX_PATH);
+	SAppend(".tmp", szTemp, _MAX_PATH);
+	// the ressource might have changed its file since, so check the copy before it's found by its hash
+	uint32_t iCRC32;
+	if (!CopyFile(szFile, szTemp, false) ||
+		FileSize(szTemp) != Core.getFileSize() || !C4Group_GetFileCRC(szTemp, &iCRC32) || iCRC32 != Core.getFileCRC() ||
+		!RenameFile(szTemp, szTarget))
+	{
+		EraseFile(szTemp);
+		LogSilentF("Network: could not add %s to ressource cache!", Core.getFileName());
+		return false;
+	}
+	// make room
+	CStdLock CacheLock(&CacheCSec);
+	Shrink(iMaxSize);
+	return true;
+}
+
+void C4Network2ResCache::GetFilename(const C4Network2ResCore &Core, char *pTarget)
+{
+	// name by contents, keep the extension for people looking into the folder
+	const char *szExtension = GetExtension(Core.getFileName());
+	if (SLen(szExtension) > 8 || !std::all_of(szExtension, szExtension + SLen(szExtension), [](char c) { return isalnum(static_cast<unsigned char>(c)); }))
+		szExtension = "";
+	snprintf(pTarget, _MAX_PATH, "%s%08x%08x%s%s", szPath, Core.getFileCRC(), Core.getFileSize(), *szExtension ? "." : "", szExtension);
+}
+
+void C4Network2ResCache::Shrink(uint64_t iMaxSize)
+{
+	// collect files
+	struct Entry { StdStrBuf Filename; int iTime; uint64_t iSize; };
+	std::vector<Entry> Entries; uint64_t iTotalSize = 0;
+	for (DirectoryIterator i(szPath); *i; ++i)
+		if (!DirectoryExists(*i))
+		{
+			Entries.push_back({ StdStrBuf(*i, true), FileTime(*i), FileSize(*i) });
+			iTotalSize += Entries.back().iSize;
+		}
+	if (iTotalSize <= iMaxSize) return;
+	// delete least recently used first
+	std::sort(Entries.begin(), Entries.end(), [](const Entry &a, const Entry &b) { return a.iTime < b.iTime; });
+	for (auto it = Entries.begin(); it != Entries.end() && iTotalSize > iMaxSize; ++it)
+		if (EraseFile(it->Filename.getData()))
+			iTotalSize -= it->iSize;
+}
+
 // *** C4Network2ResList
 
 C4Network2ResList::C4Network2ResList()
@@ -1316,11 +1709,20 @@ C4Network2ResList::C4Network2ResList()
 	pFirst(nullptr),
 	ResListCSec(this),
 	iLastDiscover(0), iLastStatus(0),
-	pIO(nullptr) {}
+	pIO(nullptr),
+	pSources(nullptr),
+	iLoadedBytes(0) {}
 
 C4Network2ResList::~C4Network2ResList()
 {
 	Clear();
+	// delete source estimates
+	while (pSources)
+	{
+		C4Network2ResSource *pSource = pSources;
+		pSources = pSource->pNext;
+		delete pSource;
+	}
 }
 
 bool C4Network2ResList::Init(int32_t inClientID, C4Network2IO *pIOClass) // by main thread
@@ -1334,6 +1736,8 @@ bool C4Network2ResList::Init(int32_t inClientID, C4Network2IO *pIOClass) // by m
 	SetLocalID(inClientID);
 	// create network path
 	if (!CreateNetworkFolder()) return false;
+	// cache is optional
+	Cache.Init();
 	// ok
 	return true;
 }
@@ -1460,6 +1864,14 @@ C4Network2Res::Ref C4Network2ResList::AddByCore(const C4Network2ResCore &Core, b
 	// try set by core
 	if (!pRes->SetByCore(Core, true))
 	{
+		// loaded in an earlier session?
+		char szCacheFile[_MAX_PATH + 1];
+		if (Core.isLoadable() && Cache.Find(Core, szCacheFile) && pRes->SetByCache(Core, szCacheFile))
+		{
+			Application.InteractiveThread.ThreadLogS("Network: Found %s in cache. Not loading.", Core.getFileName());
+			Add(pRes);
+			return pRes;
+		}
 		pRes.Clear();
 		// try load (if specified)
 		return fLoad ? AddLoad(Core) : nullptr;
@@ -1627,6 +2039,71 @@ void C4Network2ResList::OnTimer()
 	}
 }
 
+int32_t C4Network2ResList::GetLoadCnt(int32_t iByClient)
+{
+	CStdShareLock ResListLock(&ResListCSec);
+	int32_t iCnt = 0;
+	for (C4Network2Res *pRes = pFirst; pRes; pRes = pRes->pNext)
+		if (pRes->isLoading())
+			iCnt += pRes->getLoadCnt(iByClient);
+	return iCnt;
+}
+
+bool C4Network2ResList::CanStartLoad(int32_t iByClient, uint32_t iChunkSize)
+{
+	int32_t iWindow;
+	{
+		CStdLock SourcesLock(&SourcesCSec);
+		iWindow = getSource(iByClient)->getLoadWindow(iChunkSize);
+	}
+	return GetLoadCnt(iByClient) < iWindow;
+}
+
+C4Network2ResLoad *C4Network2ResList::CreateLoad(int32_t iChunk, int32_t iByClient)
+{
+	CStdLock SourcesLock(&SourcesCSec);
+	C4Network2ResSource *pSource = getSource(iByClient);
+	return new C4Network2ResLoad(iChunk, iByClient, pSource->getLoadTimeout(), pSource->getDelivered());
+}
+
+void C4Network2ResList::OnLoadChunk(const C4Network2ResLoad &Load, uint32_t iSize)
+{
+	{
+		CStdLock SourcesLock(&SourcesCSec);
+		getSource(Load.getByClient())->OnChunk(Load, iSize);
+	}
+	iLoadedBytes += iSize;
+}
+
+void C4Network2ResList::OnLoadTimeout(const C4Network2ResLoad &Load)
+{
+	CStdLock SourcesLock(&SourcesCSec);
+	getSource(Load.getByClient())->OnLoadTimeout();
+}
+
+C4Network2ResSource *C4Network2ResList::getSource(int32_t iClientID)
+{
+	C4Network2ResSource *pSource;
+	for (pSource = pSources; pSource; pSource = pSource->pNext)
+		if (pSource->getClientID() == iClientID)
+			return pSource;
+	// not found? add
+	pSource = new C4Network2ResSource(iClientID);
+	pSource->pNext = pSources;
+	pSources = pSource;
+	return pSource;
+}
+
+uint32_t C4Network2ResList::GetLoadStatistic()
+{
+	return iLoadedBytes;
+}
+
+void C4Network2ResList::ClearLoadStatistic()
+{
+	iLoadedBytes = 0;
+}
+
 void C4Network2ResList::OnShareFree(CStdCSecEx *pCSec)
 {
 	if (pCSec == &ResListCSec)
@@ -1677,6 +2154,8 @@ void C4Network2ResList::OnResComplete(C4Network2Res *pRes)
 {
 	// log (network thread -> ThreadLog)
 	Application.InteractiveThread.ThreadLogS("Network: %s received.", pRes->getCore().getFileName());
+	// keep for later sessions
+	Cache.Add(pRes);
 	// call handler (ctrl might wait for this ressource)
 	Game.Control.Network.OnResComplete(pRes);
 }
@@ -22,18 +22,28 @@
 #include <StdSync.h>
 
 #include <atomic>
+#include <thread>
+#include <vector>
 
 const uint32_t C4NetResChunkSize = 100U * 1024U;
 
 const int32_t C4NetResDiscoverTimeout = 10, // (s)
               C4NetResDiscoverInterval = 1, // (s)
               C4NetResStatusInterval = 1, // (s)
-              C4NetResMaxLoadPerPeerPerFile = 3,
-              C4NetResMaxLoad = 20,
+              C4NetResInitialLoadWindow = 3, // chunk requests per source before anything was measured
+              C4NetResMinLoadWindow = 2,
+              C4NetResMaxLoadWindow = 64,
+              C4NetResMaxLoad = 128, // chunk requests per ressource
               C4NetResLoadTimeout = 60, // (s)
+              C4NetResMinLoadTimeout = 5, // (s)
               C4NetResDeleteTime = 60, // (s)
               C4NetResMaxBigicon = 20; // maximum size, in KB, of bigicon
 
+const int32_t C4NetResBandwidthSamples = 16, // delivery rate samples per source
+              C4NetResMinRTTExpiry = 10000; // (ms)
+
+const uint32_t C4NetResMaxChunkSHACnt = 65536; // chunks of a ressource that can be verified one by one
+
 const int32_t C4NetResIDAnonymous = -2;
 
 enum C4Network2ResType
@@ -78,6 +88,8 @@ protected:
 	uint8_t fHasFileSHA;
 	uint8_t FileSHA[StdSha1::DigestLength];
 	uint32_t iChunkSize;
+	uint8_t fHasChunkSHA;
+	StdBuf ChunkSHA; // one hash per chunk
 
 public:
 	C4Network2ResType getType()        const { return eType; }
@@ -89,6 +101,7 @@ public:
 	uint32_t          getFileCRC()     const { return iFileCRC; }
 	uint32_t          getContentsCRC() const { return iContentsCRC; }
 	bool              hasFileSHA()     const { return !!fHasFileSHA; }
+	bool              hasChunkSHA()    const { return !!fHasChunkSHA; }
 	const char       *getFileName()    const { return FileName.getData(); }
 	uint32_t          getChunkSize()   const { return iChunkSize; }
 	uint32_t          getChunkCnt()    const { return iFileSize && iChunkSize ? (iFileSize - 1) / iChunkSize + 1 : 0; }
@@ -98,6 +111,9 @@ public:
 	void SetDerived(int32_t inDerID) { iDerID = inDerID; }
 	void SetLoadable(uint32_t iSize, uint32_t iCRC);
 	void SetFileSHA(uint8_t *pSHA) { memcpy(FileSHA, pSHA, StdSha1::DigestLength); fHasFileSHA = true; }
+	void SetChunkSHA(StdBuf &&Hashes);
+	void ClearChunkSHA() { ChunkSHA.Clear(); fHasChunkSHA = false; }
+	bool CheckChunkSHA(uint32_t iChunk, const StdBuf &Data) const; // true if there are no chunk hashes
 	void Clear();
 
 	virtual void CompileFunc(StdCompiler *pComp);
@@ -106,15 +122,18 @@ public:
 class C4Network2ResLoad
 {
 	friend class C4Network2Res;
+	friend class C4Network2ResSource;
 
 public:
-	C4Network2ResLoad(int32_t iChunk, int32_t iByClient);
+	C4Network2ResLoad(int32_t iChunk, int32_t iByClient, uint32_t iTimeout, uint64_t iDelivered);
 	~C4Network2ResLoad();
 
 protected:
 	// chunk download data
 	int32_t iChunk;
-	time_t Timestamp;
+	unsigned long iRequestTime; // (ms)
+	uint32_t iTimeout; // (ms)
+	uint64_t iDeliveredAtRequest; // bytes delivered by the source when requesting
 	int32_t iByClient;
 
 	// list (C4Network2Res)
@@ -129,6 +148,37 @@ public:
 	bool CheckTimeout();
 };
 
+// Transfer estimates for a client we load chunks from (shared by all ressources).
+// The number of requests in flight follows the bandwidth-delay product, like BBR.
+class C4Network2ResSource
+{
+	friend class C4Network2ResList;
+
+public:
+	C4Network2ResSource(int32_t iClientID);
+
+protected:
+	int32_t iClientID;
+	uint64_t iDelivered; // bytes received
+	uint32_t iSRTT, iMinRTT; // round trip times: smoothed and minimum (ms)
+	unsigned long iMinRTTTime;
+	uint32_t Bandwidth[C4NetResBandwidthSamples]; // recent delivery rates (bytes/s)
+	int32_t iBandwidthSample;
+
+	// list (C4Network2ResList)
+	C4Network2ResSource *pNext;
+
+public:
+	int32_t getClientID() const { return iClientID; }
+	uint64_t getDelivered() const { return iDelivered; }
+	uint32_t getBandwidth() const; // bottleneck estimate (bytes/s)
+	int32_t getLoadWindow(uint32_t iChunkSize) const;
+	uint32_t getLoadTimeout() const; // (ms)
+
+	void OnChunk(const C4Network2ResLoad &Load, uint32_t iSize);
+	void OnLoadTimeout();
+};
+
 class C4Network2ResChunkData : public C4PacketBase
 {
 public:
@@ -161,7 +211,9 @@ public:
 
 	void Clear();
 
-	int32_t GetChunkToRetrieve(const C4Network2ResChunkData &Available, int32_t iLoadingCnt, int32_t *pLoading) const;
+	// pSourceCnt: sources per chunk, if given the rarest chunks are retrieved first
+	int32_t GetChunkToRetrieve(const C4Network2ResChunkData &Available, int32_t iLoadingCnt, const int32_t *pLoading, const int32_t *pSourceCnt = nullptr) const;
+	void AddPresentTo(std::vector<int32_t> &Counts) const;
 
 protected:
 	// helpers
@@ -229,6 +281,8 @@ protected:
 	time_t iDiscoverStartTime;
 	C4Network2ResLoad *pLoads;
 	int32_t iLoadCnt;
+	std::vector<int32_t> ChunkSourceCnt; // number of clients having each chunk
+	bool fChunkSourceCntDirty;
 
 	// list (C4Network2ResList)
 	C4Network2Res *pNext;
@@ -251,6 +305,7 @@ public:
 	bool SetByFile(const char *strFilePath, bool fTemp, C4Network2ResType eType, int32_t iResID, const char *szResName = nullptr, bool fSilent = false);
 	bool SetByGroup(C4Group *pGrp, bool fTemp, C4Network2ResType eType, int32_t iResID, const char *szResName = nullptr, bool fSilent = false);
 	bool SetByCore(const C4Network2ResCore &nCore, bool fSilent = false, const char *szAsFilename = nullptr, int32_t iRecursion = 0);
+	bool SetByCache(const C4Network2ResCore &nCore, const char *szCacheFile);
 	bool SetLoad(const C4Network2ResCore &nCore);
 
 	bool SetDerived(const char *strName, const char *strFilePath, bool fTemp, C4Network2ResType eType, int32_t iDResID);
@@ -260,6 +315,7 @@ public:
 	bool IsBinaryCompatible();
 	bool GetStandalone(char *pTo, int32_t iMaxL, bool fSetOfficial, bool fAllowUnloadable = false, bool fSilent = false);
 	bool CalculateSHA();
+	bool CalculateChunkSHA();
 
 	C4Network2Res::Ref Derive();
 	bool FinishDerive();
@@ -283,6 +339,7 @@ public:
 	void Clear();
 
 	bool GetClientProgress(int32_t clientID, int32_t& presentChunkCnt, int32_t& chunkCnt);
+	int32_t getLoadCnt(int32_t iByClient) const;
 
 protected:
 	int32_t OpenFileRead(); int32_t OpenFileWrite();
@@ -290,10 +347,12 @@ protected:
 	void StartNewLoads();
 	bool StartLoad(int32_t iFromClient, const C4Network2ResChunkData &Chunks);
 	void EndLoad();
+	bool VerifyLoad();
 	void ClearLoad();
 
 	void RemoveLoad(C4Network2ResLoad *pLoad);
 	void RemoveCChunks(ClientChunks *pChunks);
+	void UpdateChunkSourceCnt();
 
 	bool OptimizeStandalone(bool fSilent);
 };
@@ -312,6 +371,8 @@ protected:
 public:
 	int32_t  getResID()   const { return iResID; }
 	uint32_t getChunkNr() const { return iChunk; }
+	uint32_t getSize()    const { return Data.getSize(); }
+	const StdBuf &getData() const { return Data; }
 
 	bool Set(C4Network2Res *pRes, uint32_t iChunk);
 	bool AddTo(C4Network2Res *pRes, C4Network2IO *pIO) const;
@@ -319,6 +380,48 @@ public:
 	virtual void CompileFunc(StdCompiler *pComp);
 };
 
+// Loaded ressources, kept across sessions in the user path.
+// Files are named by content hash, the least recently used ones are deleted
+// when the configured size is exceeded. Files are copied on a worker thread,
+// so large scenarios don't hold up the network thread. The worker is started
+// and stopped by the main thread only; queued jobs keep their ressource alive.
+class C4Network2ResCache
+{
+public:
+	C4Network2ResCache();
+	~C4Network2ResCache();
+
+	bool Init(); // by main thread - starts the worker
+	void Clear(); // by main thread - stops the worker, pending copies are dropped
+
+protected:
+	char szPath[_MAX_PATH + 1];
+	CStdCSec CacheCSec;
+
+	// copies to be done by the worker
+	struct Job
+	{
+		C4Network2ResCore Core;
+		C4Network2Res::Ref pRes; // keeps the file from being deleted with the ressource
+		StdStrBuf File;
+	};
+	std::vector<Job> Jobs;
+	CStdCSec JobCSec;
+	std::thread Thread;
+	CStdEvent Event{false};
+	std::atomic<bool> fStop;
+
+public:
+	bool Find(const C4Network2ResCore &Core, char *pTarget); // by both
+	void Add(C4Network2Res *pRes); // by network thread - queues the copy
+
+protected:
+	void Execute(); // by worker thread
+	bool Store(const C4Network2ResCore &Core, const char *szFile); // by worker thread
+	void GetFilename(const C4Network2ResCore &Core, char *pTarget);
+	void Shrink(uint64_t iMaxSize);
+};
+
 class C4Network2ResList : protected CStdCSecExCallback // run by network thread
 {
 	friend class C4Network2Res;
@@ -342,6 +445,16 @@ protected:
 	// object used for network i/o
 	C4Network2IO *pIO;
 
+	// ressources loaded in earlier sessions
+	C4Network2ResCache Cache;
+
+	// clients we load from
+	C4Network2ResSource *pSources;
+	CStdCSec SourcesCSec;
+
+	// statistics
+	std::atomic<uint32_t> iLoadedBytes;
+
 public:
 	// initialization
 	bool Init(int32_t iClientID, C4Network2IO *pIOClass); // by main thread
@@ -382,9 +495,21 @@ public:
 
 	int32_t GetClientProgress(int32_t clientID);
 
+	// statistics
+	uint32_t GetLoadStatistic(); // bytes loaded
+	void ClearLoadStatistic();
+
 protected:
 	void OnResComplete(C4Network2Res *pRes);
 
+	// for C4Network2Res: load windows
+	int32_t GetLoadCnt(int32_t iByClient); // over all ressources
+	bool CanStartLoad(int32_t iByClient, uint32_t iChunkSize);
+	C4Network2ResLoad *CreateLoad(int32_t iChunk, int32_t iByClient);
+	void OnLoadChunk(const C4Network2ResLoad &Load, uint32_t iSize);
+	void OnLoadTimeout(const C4Network2ResLoad &Load);
+	C4Network2ResSource *getSource(int32_t iClientID); // creates the entry if necessary
+
 	// misc
 	bool CreateNetworkFolder();
 	bool FindTempResFileName(const char *szFilename, char *pTarget);
@@ -306,6 +306,11 @@ C4Network2Stats::C4Network2Stats() : pSec1Timer(nullptr)
 	statNetO.SetTitle(LoadResStr("IDS_NET_OUTPUT"));
 	statNetO.SetColorDw(0xff0000);
 	graphNetIO.AddGraph(&statNetI); graphNetIO.AddGraph(&statNetO);
+	statResLoad.SetTitle(LoadResStr("IDS_NET_RESLOAD"));
+	statResLoad.SetColorDw(0x00ffff);
+	statControlWait.SetTitle(LoadResStr("IDS_NET_CONTROLWAIT"));
+	statPreSend.SetTitle(LoadResStr("IDS_NET_PRESEND"));
+	statControlLatency.SetTitle(LoadResStr("IDS_NET_CONTROLLATENCY"));
 	statControls.SetTitle(LoadResStr("IDS_NET_CONTROL"));
 	statControls.SetAverageTime(100);
 	statActions.SetTitle(LoadResStr("IDS_NET_APM"));
@@ -333,6 +338,12 @@ void C4Network2Stats::ExecuteSecond()
 	statFPS.RecordValue(C4Graph::ValueType(Game.FPS));
 	statNetI.RecordValue(C4Graph::ValueType(Game.Network.NetIO.getProtIRate(P_TCP) + Game.Network.NetIO.getProtIRate(P_UDP)));
 	statNetO.RecordValue(C4Graph::ValueType(Game.Network.NetIO.getProtORate(P_TCP) + Game.Network.NetIO.getProtORate(P_UDP)));
+	statResLoad.RecordValue(C4Graph::ValueType(Game.Network.ResList.GetLoadStatistic()));
+	Game.Network.ResList.ClearLoadStatistic();
+	statControlWait.RecordValue(C4Graph::ValueType(Game.Control.Network.GetPrepareWaitStatistic()));
+	Game.Control.Network.ClearPrepareWaitStatistic();
+	statPreSend.RecordValue(C4Graph::ValueType(Game.Control.Network.getControlPreSend()));
+	statControlLatency.RecordValue(C4Graph::ValueType(Game.Control.Network.getControlSendTimePercentile()));
 	// pings for all clients
 	C4Network2Client *pClient = nullptr;
 	while (pClient = Game.Network.Clients.GetNextClient(pClient)) if (pClient->getStatPing())
@@ -374,6 +385,10 @@ C4Graph *C4Network2Stats::GetGraphByName(const StdStrBuf &rszName, bool &rfIsTem
 	if (SEqualNoCase(rszName.getData(), "oc")) return &statObjCount;
 	if (SEqualNoCase(rszName.getData(), "fps")) return &statFPS;
 	if (SEqualNoCase(rszName.getData(), "netio")) return &graphNetIO;
+	if (SEqualNoCase(rszName.getData(), "resload")) return &statResLoad;
+	if (SEqualNoCase(rszName.getData(), "ctrlwait")) return &statControlWait;
+	if (SEqualNoCase(rszName.getData(), "presend")) return &statPreSend;
+	if (SEqualNoCase(rszName.getData(), "ctrllatency")) return &statControlLatency;
 	if (SEqualNoCase(rszName.getData(), "pings")) return &statPings;
 	if (SEqualNoCase(rszName.getData(), "control")) return &statControls;
 	if (SEqualNoCase(rszName.getData(), "apm")) return &statActions;
@@ -179,6 +179,15 @@ private:
 	C4TableGraph statNetI, statNetO;
 	C4GraphCollection graphNetIO;
 
+	// ressource download rate
+	C4TableGraph statResLoad;
+
+	// average time waited for control per control tick
+	C4TableGraph statControlWait;
+
+	// control jitter buffer decisions
+	C4TableGraph statPreSend, statControlLatency;
+
 protected:
 	C4GraphCollection statPings; // for all clients
 
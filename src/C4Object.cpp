@@ -34,6 +34,7 @@
 #include <C4Player.h>
 #include <C4ObjectMenu.h>
 
+#include <algorithm>
 #include <limits>
 #include <utility>
 
@@ -71,6 +72,8 @@ void C4Action::GetBridgeData(int32_t &riBridgeTime, bool &rfMoveClonk, bool &rfW
 C4Object::C4Object()
 {
 	Default();
+	HandleSlot = ObjectSlots.Add(this);
+	SyncHotFields();
 }
 
 void C4Object::Default()
@@ -143,6 +146,7 @@ void C4Object::Default()
 	pDrawTransform = nullptr;
 	pEffects = nullptr;
 	FirstRef = nullptr;
+	iMaxReferences = C4ObjMinMaxReferences;
 	pGfxOverlay = nullptr;
 	iLastAttachMovementFrame = -1;
 }
@@ -164,8 +168,9 @@ bool C4Object::Init(C4Def *pDef, C4Object *pCreator,
 	Def = pDef;
 	if (Info) Name = pInfo->Name; else Name.Ref(pDef->Name);
 	Category = Def->Category;
+	SyncHotFields();
 	Def->Count++;
-	if (pCreator) pLayer = pCreator->pLayer;
+	if (pCreator) AddReference(pLayer = pCreator->pLayer);
 
 	// graphics
 	pGraphics = &Def->Graphics;
@@ -233,6 +238,8 @@ C4Object::~C4Object()
 	assert(!Game.Objects.InactiveObjects.ObjectNumber(this));
 	Game.Objects.Sectors.AssertObjectNotInList(this);
 #endif
+
+	ObjectSlots.Remove(HandleSlot);
 }
 
 void C4Object::AssignRemoval(bool fExitContents)
@@ -278,9 +285,11 @@ void C4Object::AssignRemoval(bool fExitContents)
 		// object was inactive: activate first, then delete
 		Game.Objects.InactiveObjects.Remove(this);
 		Status = C4OS_NORMAL;
+		SyncHotFields();
 		Game.Objects.Add(this);
 	}
 	Status = 0;
+	SyncHotFields();
 	// count decrease
 	Def->Count--;
 	// Kill contents
@@ -304,12 +313,13 @@ void C4Object::AssignRemoval(bool fExitContents)
 		pCont->UpdateMass();
 		pCont->SetOCF();
 		Contained = nullptr;
+		SyncHotFields();
 	}
 	// Object info
 	if (Info) Info->Retire();
 	Info = nullptr;
 	// Object system operation
-	while (FirstRef) FirstRef->Set(0);
+	InvalidateHandles();
 	Game.ClearPointers(this);
 	ClearCommands();
 	if (pSolidMaskData) pSolidMaskData->Remove(true, false);
@@ -489,6 +499,25 @@ void C4Object::DrawFace(C4FacetEx &cgo, int32_t cgoX, int32_t cgoY, int32_t iPha
 	}
 }
 
+int32_t C4Object::GetDrawRange()
+{
+	// anything not confined to the object shape can't be culled
+	if (!Def || Def->Line || (Category & C4D_Parallax) || pGfxOverlay || pDrawTransform) return -1;
+	if (BackParticles || FrontParticles || Con > FullCon) return -1;
+	if (Action.Act > ActIdle && Def->ActMap[Action.Act].FacetTargetStretch) return -1;
+	// shape, centered base face and action facet
+	const int32_t iCenterX = Shape.x + Shape.Wdt / 2, iCenterY = Shape.y + Shape.Hgt / 2;
+	int32_t iRange = std::max({ -Shape.x, Shape.x + Shape.Wdt, -Shape.y, Shape.y + Shape.Hgt,
+		std::abs(iCenterX) + Def->Shape.Wdt / 2 + 1, std::abs(iCenterY) + Def->Shape.Hgt / 2 + 1 });
+	if (Action.Act > ActIdle)
+		iRange = std::max({ iRange, -(Shape.x + Action.FacetX), Shape.x + Action.FacetX + Action.Facet.Wdt,
+			-(Shape.y + Action.FacetY), Shape.y + Action.FacetY + Action.Facet.Hgt });
+	// rotation turns around the shape center
+	if (r) iRange *= 3;
+	// energy bar and select mark are drawn above the shape
+	return iRange + 20;
+}
+
 void C4Object::UpdateMass()
 {
 	Mass = std::max<int32_t>((Def->Mass + OwnMass) * Con / FullCon, 1);
@@ -658,6 +687,7 @@ void C4Object::SetOCF()
 	C4RCOCF rc = { dwOCFOld, OCF, false };
 	AddDbgRec(RCT_OCF, &rc, sizeof(rc));
 #endif
+	SyncHotFields();
 }
 
 void C4Object::UpdateOCF()
@@ -749,6 +779,7 @@ void C4Object::UpdateOCF()
 	C4RCOCF rc = { dwOCFOld, OCF, true };
 	AddDbgRec(RCT_OCF, &rc, sizeof(rc));
 #endif
+	SyncHotFields();
 #ifdef _DEBUG
 	DEBUGREC_OFF
 		uint32_t updateOCF = OCF;
@@ -1508,6 +1539,7 @@ bool C4Object::Exit(int32_t iX, int32_t iY, int32_t iR, FIXED iXDir, FIXED iYDir
 	pContainer->SetOCF();
 	// No container
 	Contained = nullptr;
+	SyncHotFields();
 	// Position/motion
 	BoundsCheck(iX, iY);
 	x = iX; y = iY; r = iR;
@@ -1560,10 +1592,12 @@ bool C4Object::Enter(C4Object *pTarget, bool fCalls, bool fCopyMotion, bool *pfR
 	SetOCF();
 	// Set container
 	Contained = pTarget;
+	SyncHotFields();
 	// Enter
 	if (!Contained->Contents.Add(this, C4ObjectList::stContents))
 	{
 		Contained = nullptr;
+		SyncHotFields();
 		return false;
 	}
 	// Assume that the new container controls this object, if it cannot control itself (i.e.: Alive)
@@ -2179,6 +2213,74 @@ void C4Object::ClearPointers(C4Object *pObj)
 	}
 }
 
+static void RemoveReferenceEntry(std::vector<C4Object *> &List, C4Object *pObj)
+{
+	auto it = std::find(List.begin(), List.end(), pObj);
+	if (it == List.end()) return;
+	*it = List.back();
+	List.pop_back();
+}
+
+void C4Object::AddReference(C4Object *pTarget)
+{
+	if (!pTarget || pTarget == this) return;
+	// already known? The own list is the short one usually
+	if (std::find(References.begin(), References.end(), pTarget) != References.end()) return;
+	// too many? Drop the ones that aren't used anymore
+	if (References.size() >= iMaxReferences)
+	{
+		for (C4Object *pRef : References)
+			RemoveReferenceEntry(pRef->Referrers, this);
+		References.clear();
+		iMaxReferences = SIZE_MAX;
+		RegisterReferences();
+		iMaxReferences = std::max(C4ObjMinMaxReferences, References.size() * 2);
+		if (std::find(References.begin(), References.end(), pTarget) != References.end()) return;
+	}
+	// add
+	References.push_back(pTarget);
+	pTarget->Referrers.push_back(this);
+}
+
+void C4Object::RegisterReferences()
+{
+	AddReference(Action.Target);
+	AddReference(Action.Target2);
+	AddReference(pLayer);
+	for (C4Command *pCom = Command; pCom; pCom = pCom->Next)
+	{
+		AddReference(pCom->Target);
+		AddReference(pCom->Target2);
+	}
+	for (C4Effect *pEff = pEffects; pEff; pEff = pEff->pNext)
+		AddReference(pEff->pCommandTarget);
+	if (Menu) Menu->RegisterReferences(this);
+	for (C4GraphicsOverlay *pGfxOvrl = pGfxOverlay; pGfxOvrl; pGfxOvrl = pGfxOvrl->GetNext())
+		AddReference(pGfxOvrl->GetOverlayObject());
+}
+
+void C4Object::ClearReferrers()
+{
+	std::vector<C4Object *> OldReferrers;
+	OldReferrers.swap(Referrers);
+	for (C4Object *pReferrer : OldReferrers)
+	{
+		RemoveReferenceEntry(pReferrer->References, this);
+		pReferrer->ClearPointers(this);
+	}
+}
+
+void C4Object::ClearReferences()
+{
+	for (C4Object *pRef : References)
+		RemoveReferenceEntry(pRef->Referrers, this);
+	References.clear();
+	for (C4Object *pReferrer : Referrers)
+		RemoveReferenceEntry(pReferrer->References, this);
+	Referrers.clear();
+	iMaxReferences = C4ObjMinMaxReferences;
+}
+
 C4Value C4Object::Call(const char *szFunctionCall, C4AulParSet *pPars, bool fPassError)
 {
 	if (!Status || !Def || !szFunctionCall[0]) return C4VNull;
@@ -2875,6 +2977,8 @@ void C4Object::DenumeratePointers()
 	Action.Target = Game.Objects.ObjectPointer(nActionTarget1);
 	Action.Target2 = Game.Objects.ObjectPointer(nActionTarget2);
 	pLayer = Game.Objects.ObjectPointer(nLayer);
+	// status, OCF and category have been loaded as well
+	SyncHotFields();
 
 	// Post-compile object list
 	Contents.DenumerateRead();
@@ -2894,6 +2998,9 @@ void C4Object::DenumeratePointers()
 	if (pGfxOverlay)
 		for (C4GraphicsOverlay *pGfxOvrl = pGfxOverlay; pGfxOvrl; pGfxOvrl = pGfxOvrl->GetNext())
 			pGfxOvrl->DenumeratePointers();
+
+	// back references
+	RegisterReferences();
 }
 
 bool DrawCommandQuery(int32_t controller, C4ScriptHost &scripthost, int32_t *mask, int com)
@@ -3192,7 +3299,8 @@ void C4Object::Clear()
 	}
 	delete pDrawTransform;   pDrawTransform   = nullptr;
 	delete pGfxOverlay;      pGfxOverlay      = nullptr;
-	while (FirstRef) FirstRef->Set(0);
+	InvalidateHandles();
+	ClearReferences();
 }
 
 bool C4Object::ContainedControl(uint8_t byCom)
@@ -4094,8 +4202,8 @@ bool C4Object::SetAction(int32_t iAct, C4Object *pTarget, C4Object *pTarget2, in
 	Action.Phase = Action.PhaseDelay = 0;
 
 	// Set target if specified
-	if (pTarget) Action.Target = pTarget;
-	if (pTarget2) Action.Target2 = pTarget2;
+	if (pTarget) AddReference(Action.Target = pTarget);
+	if (pTarget2) AddReference(Action.Target2 = pTarget2);
 
 	// Set Action Facet
 	UpdateActionFace();
@@ -5928,6 +6036,7 @@ bool C4Object::StatusActivate()
 	// readd to main list
 	Game.Objects.InactiveObjects.Remove(this);
 	Status = C4OS_NORMAL;
+	SyncHotFields();
 	Game.Objects.Add(this);
 	// update some values
 	UpdateGraphics(false);
@@ -5946,6 +6055,7 @@ bool C4Object::StatusDeactivate(bool fClearPointers)
 	// put into inactive list
 	Game.Objects.Remove(this);
 	Status = C4OS_INACTIVE;
+	SyncHotFields();
 	Game.Objects.InactiveObjects.Add(this, C4ObjectList::stMain);
 	// if desired, clear game pointers
 	if (fClearPointers)
@@ -6064,9 +6174,18 @@ void C4Object::UpdateInLiquid()
 	}
 }
 
+void C4Object::InvalidateHandles()
+{
+	// map values are cleared right away, so they're removed from their map
+	// (this must happen first, as they unregister by resolving their handle)
+	while (FirstRef) FirstRef->Set(0);
+	// all other values resolve to nil from now on
+	ObjectSlots.Invalidate(HandleSlot);
+}
+
 void C4Object::AddRef(C4Value *pRef)
 {
-	pRef->NextRef = FirstRef;
+	pRef->SetNextRef(FirstRef);
 	FirstRef = pRef;
 }
 
@@ -6078,10 +6197,10 @@ void C4Object::DelRef(const C4Value *pRef, C4Value *pNextRef)
 	else
 	{
 		C4Value *pVal = FirstRef;
-		while (pVal->NextRef && pVal->NextRef != pRef)
-			pVal = pVal->NextRef;
-		assert(pVal->NextRef);
-		pVal->NextRef = pNextRef;
+		while (pVal->GetNextRef() && pVal->GetNextRef() != pRef)
+			pVal = pVal->GetNextRef();
+		assert(pVal->GetNextRef());
+		pVal->SetNextRef(pNextRef);
 	}
 }
 
@@ -26,9 +26,13 @@
 #include "C4ValueList.h"
 #include "C4Effects.h"
 #include "C4Particles.h"
+#include "C4ObjectPool.h"
 
 #include <array>
 
+// stale entries in an object's reference list are pruned once it grows beyond this (or twice the live count)
+const size_t C4ObjMinMaxReferences = 32;
+
 /* Object status */
 
 #define C4OS_DELETED  0
@@ -112,6 +116,8 @@ class C4Object
 public:
 	C4Object();
 	~C4Object();
+	static void *operator new(size_t iSize) { return ObjectPool.Alloc(iSize); }
+	static void operator delete(void *pObj, size_t iSize) { ObjectPool.Free(pObj, iSize); }
 	int32_t Number; // int32_t, for sync safety on all machines
 	C4ID id;
 	StdStrBuf Name;
@@ -196,7 +202,13 @@ public:
 	int32_t nContained;
 	StdStrBuf nInfo;
 
-	C4Value *FirstRef; // No-Save
+	C4Value *FirstRef; // No-Save - values in maps pointing to this object
+	uint32_t HandleSlot; // No-Save - slot in ObjectSlots
+
+	// objects that might hold pointers to this object and objects this one might point to - No-Save
+	// only referrers need to clear their pointers when this object is removed
+	std::vector<C4Object *> Referrers, References;
+	size_t iMaxReferences; // No-Save - stale references are pruned beyond this
 
 	class C4GraphicsOverlay *pGfxOverlay; // singly linked list of overlay graphics
 
@@ -269,8 +281,22 @@ public:
 	void Draw(C4FacetEx &cgo, int32_t iByPlayer = -1, DrawMode eDrawMode = ODM_Normal);
 	void DrawTopFace(C4FacetEx &cgo, int32_t iByPlayer = -1, DrawMode eDrawMode = ODM_Normal);
 	void DrawFace(C4FacetEx &cgo, int32_t cgoX, int32_t cgoY, int32_t iPhaseX = 0, int32_t iPhaseY = 0);
+	int32_t GetDrawRange(); // max distance of drawn pixels from x/y; -1 if not bounded by the object shape
 	void Execute();
 	void ClearPointers(C4Object *ptr);
+	void AddReference(C4Object *pTarget); // this object might hold a pointer to pTarget from now on
+	void RegisterReferences(); // add references for all object pointers currently held
+	void ClearReferrers(); // clear pointers to this object in all objects that might hold one
+	void ClearReferences(); // unregister from all reference lists
+	C4ObjectHandle GetHandle() const { return ObjectSlots.GetHandle(HandleSlot); }
+	C4ObjectHot &GetHot() const { return ObjectSlots.GetHot(HandleSlot); }
+	// must be called whenever Status, OCF, Category or Contained change
+	void SyncHotFields()
+	{
+		C4ObjectHot &rHot = GetHot();
+		rHot.Status = Status; rHot.OCF = OCF; rHot.Category = Category; rHot.Contained = !!Contained;
+	}
+	void InvalidateHandles(); // all values pointing to this object turn nil
 	bool ExecMovement();
 	bool ExecFire(int32_t iIndex, int32_t iCausedByPlr);
 	void ExecAction();
@@ -373,6 +373,8 @@ C4Object *CreateLine(C4ID idType, int32_t iOwner, C4Object *pFrom, C4Object *pTo
 	pLine->Shape.VtxY[1] = pTo->y + pTo->Shape.Hgt / 4;
 	pLine->Action.Target = pFrom;
 	pLine->Action.Target2 = pTo;
+	pLine->AddReference(pFrom);
+	pLine->AddReference(pTo);
 	return pLine;
 }
 
@@ -421,6 +423,7 @@ bool ObjectComLineConstruction(C4Object *cObj)
 		StartSoundEffect("Connect", false, 100, cObj);
 		if (cline->Action.Target  == tstruct) cline->Action.Target  = linekit;
 		if (cline->Action.Target2 == tstruct) cline->Action.Target2 = linekit;
+		cline->AddReference(linekit);
 		// Message
 		GameMsgObject(FormatString(LoadResStr("IDS_OBJ_DISCONNECT"), cline->GetName(), tstruct->GetName()).getData(), tstruct);
 		return true;
@@ -476,6 +479,7 @@ bool ObjectComLineConstruction(C4Object *cObj)
 		StartSoundEffect("Connect", false, 100, cObj);
 		if (cline->Action.Target == linekit) cline->Action.Target = tstruct;
 		if (cline->Action.Target2 == linekit) cline->Action.Target2 = tstruct;
+		cline->AddReference(tstruct);
 		linekit->Exit();
 		linekit->AssignRemoval();
 
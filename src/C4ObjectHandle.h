@@ -0,0 +1,183 @@
+/*
+ * LegacyClonk
+ *
+ * Copyright (c) 2020, The LegacyClonk Team and contributors
+ *
+ * Distributed under the terms of the ISC license; see accompanying file
+ * "COPYING" for details.
+ *
+ * "Clonk" is a registered trademark of Matthes Bender, used with permission.
+ * See accompanying file "TRADEMARK" for details.
+ *
+ * To redistribute this file separately, substitute the full license texts
+ * for the above references.
+ */
+
+// Generational object handles: a slot index plus the generation of that slot.
+// Removing an object advances the generation once, so all handles created
+// before resolve to nullptr without having to be tracked individually.
+// Slots whose generation would wrap around are retired instead of reused, so
+// a stale handle can never resolve to a later object.
+// The slots also hold a dense mirror of the fields most filters look at, so
+// object lists can reject objects without touching the large C4Object, and
+// the lists an object is in, so lists can find its link without searching.
+
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+#include <vector>
+
+class C4Object;
+class C4ObjectList;
+class C4ObjectLink;
+
+// packed into 32 bits, so it fits into C4V_Data on all platforms
+struct C4ObjectHandle
+{
+	static constexpr uint32_t IndexBits = 20, GenerationMask = (1u << (32 - IndexBits)) - 1;
+
+	uint32_t Index : IndexBits; // slot in ObjectSlots; 0 is never used
+	uint32_t Generation : 32 - IndexBits;
+
+	inline C4Object *Get() const;
+
+	bool operator==(const C4ObjectHandle &other) const { return Index == other.Index && Generation == other.Generation; }
+	bool operator!=(const C4ObjectHandle &other) const { return !(*this == other); }
+};
+
+static_assert(sizeof(C4ObjectHandle) <= sizeof(void *), "C4V_Data compares object handles by pointer");
+
+// hot fields of an object; kept up to date by C4Object::SyncHotFields
+struct C4ObjectHot
+{
+	C4Object *Obj; // nullptr for free slots
+	uint32_t OCF;
+	int32_t Category;
+	int32_t Status;
+	bool Contained;
+	bool DrawAlways; // set by C4GameObjects::PrepareDraw: not confined to the sectors around its position
+	int32_t DrawOrder; // set by C4GameObjects::PrepareDraw: position in Game.Objects, last to first
+};
+
+// membership of an object in a list; kept up to date by C4ObjectList
+struct C4ObjectListRef
+{
+	C4ObjectList *List;
+	C4ObjectLink *Link;
+};
+
+class C4ObjectSlots
+{
+	struct Slot
+	{
+		C4Object *Obj;
+		uint32_t Generation;
+		uint32_t NextFree;
+		bool Invalidated; // generation already advanced for the current object
+	};
+
+	std::vector<Slot> Slots;
+	std::vector<C4ObjectHot> Hot; // same indices as Slots
+	std::vector<std::vector<C4ObjectListRef>> ListRefs; // same indices as Slots; main list first, as objects are added there first
+	// free slots are reused first in, first out, so slots are retired as late as possible
+	uint32_t FirstFree = 0, LastFree = 0;
+
+public:
+	// slot 0 stays empty, so zeroed handles resolve to nullptr
+	C4ObjectSlots() : Slots{{nullptr, 0, 0, false}}, Hot{C4ObjectHot{}}, ListRefs(1) {}
+
+	// by object construction
+	uint32_t Add(C4Object *pObj)
+	{
+		if (FirstFree)
+		{
+			const uint32_t iIndex = FirstFree;
+			if (!(FirstFree = Slots[iIndex].NextFree)) LastFree = 0;
+			Slots[iIndex].Obj = pObj;
+			Slots[iIndex].Invalidated = false;
+			Hot[iIndex] = C4ObjectHot{};
+			Hot[iIndex].Obj = pObj;
+			return iIndex;
+		}
+		Slots.push_back({pObj, 1, 0, false});
+		Hot.push_back(C4ObjectHot{});
+		Hot.back().Obj = pObj;
+		ListRefs.emplace_back();
+		assert(Slots.size() <= (1u << C4ObjectHandle::IndexBits));
+		return static_cast<uint32_t>(Slots.size() - 1);
+	}
+
+	// object removed: all existing handles resolve to nullptr from now on
+	// may be called several times per object, but only advances the generation once
+	void Invalidate(uint32_t iIndex)
+	{
+		Slot &rSlot = Slots[iIndex];
+		if (rSlot.Invalidated) return;
+		rSlot.Invalidated = true;
+		++rSlot.Generation;
+	}
+
+	// by object destruction
+	void Remove(uint32_t iIndex)
+	{
+		Invalidate(iIndex);
+		Slots[iIndex].Obj = nullptr;
+		Hot[iIndex] = C4ObjectHot{};
+		// lists still holding the object can't find it anymore, but they don't access it either
+		ListRefs[iIndex].clear();
+		// the next object would invalidate to a generation that doesn't fit into handles anymore: retire the slot
+		if (Slots[iIndex].Generation >= C4ObjectHandle::GenerationMask) return;
+		Slots[iIndex].NextFree = 0;
+		if (LastFree) Slots[LastFree].NextFree = iIndex; else FirstFree = iIndex;
+		LastFree = iIndex;
+	}
+
+	C4ObjectHandle GetHandle(uint32_t iIndex) const { return {iIndex, Slots[iIndex].Generation}; }
+
+	C4Object *Get(C4ObjectHandle Handle) const
+	{
+		// also used to check whether arbitrary data is a handle, so check the range
+		if (Handle.Index >= Slots.size()) return nullptr;
+		const Slot &rSlot = Slots[Handle.Index];
+		return rSlot.Generation == Handle.Generation ? rSlot.Obj : nullptr;
+	}
+
+	size_t GetSlotCount() const { return Slots.size(); }
+
+	C4ObjectHot &GetHot(uint32_t iIndex) { return Hot[iIndex]; }
+
+	void AddListRef(uint32_t iIndex, C4ObjectList *pList, C4ObjectLink *pLnk) { ListRefs[iIndex].push_back({pList, pLnk}); }
+
+	void RemoveListRef(uint32_t iIndex, C4ObjectList *pList, C4ObjectLink *pLnk)
+	{
+		// match the link, too: the slot might belong to another object by now
+		std::vector<C4ObjectListRef> &rRefs = ListRefs[iIndex];
+		for (auto it = rRefs.begin(); it != rRefs.end(); ++it)
+			if (it->List == pList && it->Link == pLnk) { rRefs.erase(it); return; }
+	}
+
+	void UpdateListRef(uint32_t iIndex, C4ObjectList *pList, C4ObjectLink *pOldLnk, C4ObjectLink *pNewLnk)
+	{
+		for (C4ObjectListRef &rRef : ListRefs[iIndex])
+			if (rRef.List == pList && rRef.Link == pOldLnk) { rRef.Link = pNewLnk; return; }
+	}
+
+	void MoveListRef(uint32_t iIndex, C4ObjectList *pOldList, C4ObjectList *pNewList, C4ObjectLink *pLnk)
+	{
+		for (C4ObjectListRef &rRef : ListRefs[iIndex])
+			if (rRef.List == pOldList && rRef.Link == pLnk) { rRef.List = pNewList; return; }
+	}
+
+	C4ObjectLink *GetListLink(uint32_t iIndex, const C4ObjectList *pList) const
+	{
+		if (iIndex >= ListRefs.size()) return nullptr;
+		for (const C4ObjectListRef &rRef : ListRefs[iIndex])
+			if (rRef.List == pList) return rRef.Link;
+		return nullptr;
+	}
+};
+
+extern C4ObjectSlots ObjectSlots;
+
+inline C4Object *C4ObjectHandle::Get() const { return ObjectSlots.Get(*this); }
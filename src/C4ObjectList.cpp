@@ -23,12 +23,12 @@
 #include <C4Wrappers.h>
 #include <C4Application.h>
 
-C4ObjectList::C4ObjectList() : FirstIter(nullptr)
+C4ObjectList::C4ObjectList() : IterCount(0)
 {
 	Default();
 }
 
-C4ObjectList::C4ObjectList(const C4ObjectList &List) : FirstIter(nullptr)
+C4ObjectList::C4ObjectList(const C4ObjectList &List) : IterCount(0)
 {
 	Default();
 	Copy(List);
@@ -37,6 +37,9 @@ C4ObjectList::C4ObjectList(const C4ObjectList &List) : FirstIter(nullptr)
 C4ObjectList::~C4ObjectList()
 {
 	Clear();
+	// iterators don't outlive their list
+	assert(!IterCount);
+	FreeRemovedLinks();
 }
 
 void C4ObjectList::Clear()
@@ -44,9 +47,12 @@ void C4ObjectList::Clear()
 	C4ObjectLink *cLnk, *nextLnk;
 	for (cLnk = First; cLnk; cLnk = nextLnk)
 	{
-		nextLnk = cLnk->Next; delete cLnk;
+		nextLnk = cLnk->Next;
+		ObjectSlots.RemoveListRef(cLnk->Slot, this, cLnk);
+		DeleteLink(cLnk);
 	}
 	First = Last = nullptr;
+	fOrderValid = true;
 	delete pEnumerated; pEnumerated = nullptr;
 }
 
@@ -129,6 +135,8 @@ bool C4ObjectList::Add(C4Object *nObj, SortType eSort, C4ObjectList *pLstSorted)
 	if (!(nLnk = new C4ObjectLink)) return false;
 	// Set link
 	nLnk->Obj = nObj;
+	nLnk->Slot = nObj->HandleSlot;
+	nLnk->Order = 0;
 
 	// Search insert position (default: end of list)
 	C4ObjectLink *cLnk = nullptr, *cPrev = Last;
@@ -184,32 +192,16 @@ bool C4ObjectList::Add(C4Object *nObj, SortType eSort, C4ObjectList *pLstSorted)
 
 			// As cPrev is the last link in front of the first position where the object could be inserted,
 			// the object should be after this point in the master list (given it's consistent).
-			// If we're about to insert the object at the end of the list, there is obviously nothing to do.
-#ifndef _DEBUG
-			if (cLnk)
-			{
-#endif
-				C4ObjectLink *cLnk2 = cPrev ? pLstSorted->GetLink(cPrev->Obj)->Next : pLstSorted->First;
-				for (; cLnk2; cLnk2 = cLnk2->Next)
-					if (cLnk2->Obj == nObj)
-						// Position found!
-						break;
-					else if (cLnk && cLnk2->Obj == cLnk->Obj)
-					{
-						// So cLnk->Obj is actually in front of nObj. Update insert position
-						cPrev = cLnk;
-						cLnk = cLnk->Next;
-#ifndef _DEBUG
-						// At end of list?
-						if (!cLnk) break;
-#endif
-					}
-
-				// No position found? This shouldn't happen with a consistent main list.
-				assert(cLnk2);
-#ifndef _DEBUG
-			}
-#endif
+			// Skip all following objects that are in front of it there.
+			C4ObjectLink *pMainLnk = pLstSorted->GetLink(nObj), *pMainLnk2;
+			// No position found? This shouldn't happen with a consistent main list.
+			assert(pMainLnk);
+			if (pMainLnk)
+				while (cLnk && (pMainLnk2 = pLstSorted->GetLink(cLnk->Obj)) && pLstSorted->GetLinkOrder(pMainLnk2) < pLstSorted->GetLinkOrder(pMainLnk))
+				{
+					cPrev = cLnk;
+					cLnk = cLnk->Next;
+				}
 		}
 	}
 
@@ -218,6 +210,7 @@ bool C4ObjectList::Add(C4Object *nObj, SortType eSort, C4ObjectList *pLstSorted)
 
 	// Insert new link after predecessor
 	InsertLink(nLnk, cPrev);
+	ObjectSlots.AddListRef(nLnk->Slot, this, nLnk);
 
 #ifdef _DEBUG
 	// Debug: Check sort
@@ -237,24 +230,16 @@ bool C4ObjectList::Add(C4Object *nObj, SortType eSort, C4ObjectList *pLstSorted)
 
 bool C4ObjectList::Remove(C4Object *pObj)
 {
-	C4ObjectLink *cLnk;
-
 	// Find link
-	for (cLnk = First; cLnk; cLnk = cLnk->Next)
-		if (cLnk->Obj == pObj) break;
+	C4ObjectLink *cLnk = GetLink(pObj);
 	if (!cLnk) return false;
 
-	// Fix iterators
-	for (iterator *i = FirstIter; i; i = i->Next)
-	{
-		if (i->pLink == cLnk) i->pLink = cLnk->Next;
-	}
-
 	// Remove link from list
 	RemoveLink(cLnk);
+	ObjectSlots.RemoveListRef(cLnk->Slot, this, cLnk);
 
-	// Deallocate link
-	delete cLnk;
+	// Deallocate link (or keep it for iterators)
+	DeleteLink(cLnk);
 
 	// Remove mass
 	Mass -= pObj->Mass; if (Mass < 0) Mass = 0;
@@ -308,11 +293,9 @@ C4Object *C4ObjectList::GetObject(int Index)
 C4ObjectLink *C4ObjectList::GetLink(C4Object *pObj)
 {
 	if (!pObj) return nullptr;
-	C4ObjectLink *cLnk;
-	for (cLnk = First; cLnk; cLnk = cLnk->Next)
-		if (cLnk->Obj == pObj)
-			return cLnk;
-	return nullptr;
+	C4ObjectLink *cLnk = ObjectSlots.GetListLink(pObj->HandleSlot, this);
+	// the slot might have been reused if pObj is already deleted
+	return cLnk && cLnk->Obj == pObj ? cLnk : nullptr;
 }
 
 int C4ObjectList::ObjectCount(C4ID id, int32_t dwCategory) const
@@ -428,21 +411,13 @@ void C4ObjectList::Enumerate()
 
 long C4ObjectList::ObjectNumber(C4Object *pObj)
 {
-	C4ObjectLink *cLnk;
-	if (!pObj) return 0;
-	for (cLnk = First; cLnk; cLnk = cLnk->Next)
-		if (cLnk->Obj == pObj)
-			return cLnk->Obj->Number;
-	return 0;
+	if (!GetLink(pObj)) return 0;
+	return pObj->Number;
 }
 
 bool C4ObjectList::IsContained(C4Object *pObj)
 {
-	C4ObjectLink *cLnk;
-	for (cLnk = First; cLnk; cLnk = cLnk->Next)
-		if (cLnk->Obj == pObj)
-			return true;
-	return false;
+	return !!GetLink(pObj);
 }
 
 bool C4ObjectList::IsClear() const
@@ -655,6 +630,58 @@ void C4ObjectList::RemoveLink(C4ObjectLink *pLnk)
 	if (pLnk->Next) pLnk->Next->Prev = pLnk->Prev; else Last = pLnk->Prev;
 }
 
+void C4ObjectList::DeleteLink(C4ObjectLink *pLnk)
+{
+	if (!IterCount) { delete pLnk; return; }
+	// iterators might point to the link: keep it, so they can go on to its successor
+	// (which is kept as well if it's removed later on)
+	pLnk->Obj = nullptr;
+	RemovedLinks.push_back(pLnk);
+}
+
+void C4ObjectList::FreeRemovedLinks()
+{
+	for (C4ObjectLink *pLnk : RemovedLinks) delete pLnk;
+	RemovedLinks.clear();
+}
+
+void C4ObjectList::SetLinkOrder(C4ObjectLink *pLnk)
+{
+	if (!fOrderValid) return;
+	// in between the neighbours; appending leaves room for more
+	const uint32_t iPrev = pLnk->Prev ? pLnk->Prev->Order : 0;
+	const uint32_t iNext = pLnk->Next ? pLnk->Next->Order : UINT32_MAX;
+	if (iNext - iPrev < 2) { fOrderValid = false; return; }
+	pLnk->Order = iPrev + (pLnk->Next ? (iNext - iPrev) / 2 : (std::min)((iNext - iPrev) / 2, uint32_t(1) << 16));
+}
+
+void C4ObjectList::UpdateOrder()
+{
+	// spread evenly over the whole range
+	uint32_t iCount = 0;
+	for (C4ObjectLink *cLnk = First; cLnk; cLnk = cLnk->Next) ++iCount;
+	const uint32_t iStep = (std::max)(UINT32_MAX / (iCount + 1), uint32_t(1));
+	uint32_t iOrder = 0;
+	for (C4ObjectLink *cLnk = First; cLnk; cLnk = cLnk->Next)
+		cLnk->Order = (iOrder += iStep);
+	fOrderValid = true;
+}
+
+void C4ObjectList::SwapLinkObjects(C4ObjectLink *pLnk1, C4ObjectLink *pLnk2)
+{
+	ObjectSlots.UpdateListRef(pLnk1->Slot, this, pLnk1, pLnk2);
+	ObjectSlots.UpdateListRef(pLnk2->Slot, this, pLnk2, pLnk1);
+	std::swap(pLnk1->Obj, pLnk2->Obj);
+	std::swap(pLnk1->Slot, pLnk2->Slot);
+}
+
+void C4ObjectList::TransferLink(C4ObjectLink *pLnk, C4ObjectList &rTarget)
+{
+	C4ObjectList::RemoveLink(pLnk);
+	rTarget.C4ObjectList::InsertLink(pLnk, rTarget.Last);
+	ObjectSlots.MoveListRef(pLnk->Slot, this, &rTarget, pLnk);
+}
+
 void C4ObjectList::InsertLink(C4ObjectLink *pLnk, C4ObjectLink *pAfter)
 {
 	// Insert after
@@ -671,6 +698,7 @@ void C4ObjectList::InsertLink(C4ObjectLink *pLnk, C4ObjectLink *pAfter)
 		if (First) First->Prev = pLnk; else Last = pLnk;
 		First = pLnk;
 	}
+	SetLinkOrder(pLnk);
 }
 
 void C4ObjectList::InsertLinkBefore(C4ObjectLink *pLnk, C4ObjectLink *pBefore)
@@ -689,6 +717,7 @@ void C4ObjectList::InsertLinkBefore(C4ObjectLink *pLnk, C4ObjectLink *pBefore)
 		if (Last) Last->Next = pLnk; else First = pLnk;
 		Last = pLnk;
 	}
+	SetLinkOrder(pLnk);
 }
 
 void C4NotifyingObjectList::InsertLinkBefore(C4ObjectLink *pLink, C4ObjectLink *pBefore)
@@ -767,6 +796,7 @@ void C4ObjectList::Default()
 	First = Last = nullptr;
 	Mass = 0;
 	pEnumerated = nullptr;
+	fOrderValid = true;
 }
 
 void C4ObjectList::UpdateTransferZones()
@@ -823,6 +853,7 @@ bool C4ObjectList::OrderObjectBefore(C4Object *pObj1, C4Object *pObj2)
 	// relink into new one
 	if (pLnk1->Prev = pLnk2->Prev) pLnk2->Prev->Next = pLnk1; else First = pLnk1;
 	pLnk1->Next = pLnk2; pLnk2->Prev = pLnk1;
+	SetLinkOrder(pLnk1);
 	// done, success
 	return true;
 }
@@ -846,6 +877,7 @@ bool C4ObjectList::OrderObjectAfter(C4Object *pObj1, C4Object *pObj2)
 	// relink into new one
 	if (pLnk1->Next = pLnk2->Next) pLnk2->Next->Prev = pLnk1; else Last = pLnk1;
 	pLnk1->Prev = pLnk2; pLnk2->Next = pLnk1;
+	SetLinkOrder(pLnk1);
 	// done, success
 	return true;
 }
@@ -865,6 +897,7 @@ bool C4ObjectList::ShiftContents(C4Object *pNewFirst)
 	Last = pNewFirstLnk->Prev;
 	// 3. Uncycle list
 	First->Prev = Last->Next = nullptr;
+	fOrderValid = false;
 	// done, success
 	return true;
 }
@@ -995,45 +1028,48 @@ void C4ObjectList::CheckCategorySort()
 C4ObjectList::iterator::iterator(C4ObjectList &List) :
 	List(List), pLink(List.First)
 {
-	Next = List.AddIter(this);
+	++List.IterCount;
 }
 
 C4ObjectList::iterator::iterator(C4ObjectList &List, C4ObjectLink *pLink) :
 	List(List), pLink(pLink)
 {
-	Next = List.AddIter(this);
+	++List.IterCount;
 }
 
 C4ObjectList::iterator::iterator(const C4ObjectList::iterator &iter) :
-	List(iter.List), pLink(iter.pLink), Next()
+	List(iter.List), pLink(iter.pLink)
 {
-	Next = List.AddIter(this);
+	++List.IterCount;
 }
 
 C4ObjectList::iterator::~iterator()
 {
-	List.RemoveIter(this);
+	if (!--List.IterCount) List.FreeRemovedLinks();
 }
 
 C4ObjectList::iterator &C4ObjectList::iterator::operator++()
 {
+	// a removed link stands for its successor
+	pLink = Live(pLink);
 	pLink = pLink ? pLink->Next : pLink;
 	return *this;
 }
 
 C4Object *C4ObjectList::iterator::operator*()
 {
+	pLink = Live(pLink);
 	return pLink ? pLink->Obj : 0;
 }
 
 bool C4ObjectList::iterator::operator==(const iterator &iter) const
 {
-	return &iter.List == &List && iter.pLink == pLink;
+	return &iter.List == &List && Live(iter.pLink) == Live(pLink);
 }
 
 bool C4ObjectList::iterator::operator!=(const iterator &iter) const
 {
-	return &iter.List != &List || iter.pLink != pLink;
+	return !(*this == iter);
 }
 
 C4ObjectList::iterator &C4ObjectList::iterator::operator=(const iterator &iter)
@@ -1054,23 +1090,3 @@ const C4ObjectList::iterator C4ObjectList::end()
 {
 	return iterator(*this, 0);
 }
-
-C4ObjectList::iterator *C4ObjectList::AddIter(iterator *iter)
-{
-	iterator *r = FirstIter;
-	FirstIter = iter;
-	return r;
-}
-
-void C4ObjectList::RemoveIter(iterator *iter)
-{
-	if (iter == FirstIter)
-		FirstIter = iter->Next;
-	else
-	{
-		iterator *i = FirstIter;
-		while (i->Next && i->Next != iter)
-			i = i->Next;
-		i->Next = iter->Next;
-	}
-}
@@ -20,6 +20,7 @@
 
 #include <C4Id.h>
 #include <C4Def.h>
+#include <C4ObjectPool.h>
 
 class C4Object;
 class C4FacetEx;
@@ -27,8 +28,13 @@ class C4FacetEx;
 class C4ObjectLink
 {
 public:
-	C4Object *Obj;
+	C4Object *Obj; // nullptr for removed links that are kept for iterators
 	C4ObjectLink *Prev, *Next;
+	uint32_t Slot; // HandleSlot of Obj, so the hot fields can be checked without touching the object
+	uint32_t Order; // ascending through the list, so positions can be compared without walking it
+
+	static void *operator new(size_t iSize) { return ObjectLinkPool.Alloc(iSize); }
+	static void operator delete(void *pLnk, size_t iSize) { ObjectLinkPool.Free(pLnk, iSize); }
 };
 
 class C4ObjectListChangeListener
@@ -55,7 +61,9 @@ public:
 
 	enum SortType { stNone = 0, stMain, stContents, stReverse, };
 
-	// An iterator which survives if an object is removed from the list
+	// An iterator which survives if an object is removed from the list:
+	// removed links are kept with their successor while iterators exist,
+	// and skipped on access
 	class iterator
 	{
 	public:
@@ -68,12 +76,14 @@ public:
 
 		iterator &operator=(const iterator &iter);
 
+		C4ObjectLink *GetLink() const { return Live(pLink); }
+
 	private:
 		explicit iterator(C4ObjectList &List);
 		iterator(C4ObjectList &List, C4ObjectLink *pLink);
+		static C4ObjectLink *Live(C4ObjectLink *pLnk) { while (pLnk && !pLnk->Obj) pLnk = pLnk->Next; return pLnk; }
 		C4ObjectList &List;
 		C4ObjectLink *pLink;
-		iterator *Next;
 
 		friend class C4ObjectList;
 	};
@@ -129,6 +139,9 @@ public:
 	C4Object *FindOther(C4ID id, int iOwner = ANY_OWNER);
 
 	C4ObjectLink *GetLink(C4Object *pObj);
+	uint32_t GetLinkOrder(C4ObjectLink *pLnk) { if (!fOrderValid) UpdateOrder(); return pLnk->Order; }
+	void SwapLinkObjects(C4ObjectLink *pLnk1, C4ObjectLink *pLnk2); // exchange the objects of two links of this list
+	void TransferLink(C4ObjectLink *pLnk, C4ObjectList &rTarget); // move link to the end of another list, without notifications
 
 	C4ID GetListID(int32_t dwCategory, int Index);
 
@@ -148,9 +161,13 @@ protected:
 	virtual void InsertLinkBefore(C4ObjectLink *pLink, C4ObjectLink *pBefore);
 	virtual void InsertLink(C4ObjectLink *pLink, C4ObjectLink *pAfter);
 	virtual void RemoveLink(C4ObjectLink *pLnk);
-	iterator *FirstIter;
-	iterator *AddIter(iterator *iter);
-	void RemoveIter(iterator *iter);
+	void SetLinkOrder(C4ObjectLink *pLnk);
+	void UpdateOrder();
+	bool fOrderValid; // if not set, link orders are renumbered on next use
+	int32_t IterCount; // number of iterators into this list
+	std::vector<C4ObjectLink *> RemovedLinks; // unlinked, but still reachable by iterators; freed with the last iterator
+	void DeleteLink(C4ObjectLink *pLnk);
+	void FreeRemovedLinks();
 
 	friend class iterator;
 	friend class C4ObjResort;
@@ -69,6 +69,7 @@ void C4ObjectMenu::LocalInit(C4Object *pObject, bool fUserMenu)
 	Object = pObject;
 	UserMenu = fUserMenu;
 	ParentObject = GetParentObject();
+	if (ParentObject) ParentObject->AddReference(Object);
 	if (pObject) eCallbackType = CB_Object; else eCallbackType = CB_Scenario;
 }
 
@@ -100,6 +101,22 @@ void C4ObjectMenu::ClearPointers(C4Object *pObj)
 	C4Menu::ClearPointers(pObj);
 }
 
+void C4ObjectMenu::RegisterReferences(C4Object *pBy)
+{
+	pBy->AddReference(Object);
+	pBy->AddReference(ParentObject);
+	pBy->AddReference(RefillObject);
+	C4MenuItem *pItem;
+	for (int32_t i = 0; pItem = GetItem(i); ++i)
+		pBy->AddReference(pItem->GetObject());
+}
+
+void C4ObjectMenu::OnItemObject(C4Object *pObj)
+{
+	// the object owning this menu holds the pointer
+	if (ParentObject) ParentObject->AddReference(pObj);
+}
+
 C4Object *C4ObjectMenu::GetParentObject()
 {
 	C4Object *cObj; C4ObjectLink *cLnk;
@@ -112,6 +129,7 @@ C4Object *C4ObjectMenu::GetParentObject()
 void C4ObjectMenu::SetRefillObject(C4Object *pObj)
 {
 	RefillObject = pObj;
+	if (ParentObject) ParentObject->AddReference(RefillObject);
 	NeedRefill = true;
 	Refill();
 }
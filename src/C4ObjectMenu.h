@@ -67,10 +67,12 @@ protected:
 public:
 	void SetRefillObject(C4Object *pObj);
 	void ClearPointers(C4Object *pObj);
+	void RegisterReferences(C4Object *pBy); // register all objects referred to by this menu
 	bool Init(C4FacetExSurface &fctSymbol, const char *szEmpty, C4Object *pObject, int32_t iExtra = C4MN_Extra_None, int32_t iExtraData = 0, int32_t iId = 0, int32_t iStyle = C4MN_Style_Normal, bool fUserMenu = false);
 	void Execute();
 
 	virtual C4Object *GetParentObject();
+	virtual void OnItemObject(C4Object *pObj);
 	bool IsCloseQuerying() const { return !!CloseQuerying; }
 
 protected:
@@ -0,0 +1,81 @@
+/*
+ * LegacyClonk
+ *
+ * Copyright (c) 2020, The LegacyClonk Team and contributors
+ *
+ * Distributed under the terms of the ISC license; see accompanying file
+ * "COPYING" for details.
+ *
+ * "Clonk" is a registered trademark of Matthes Bender, used with permission.
+ * See accompanying file "TRADEMARK" for details.
+ *
+ * To redistribute this file separately, substitute the full license texts
+ * for the above references.
+ */
+
+// Fixed size block allocator for objects and object links.
+// Blocks are carved from large chunks and recycled through a free list, so
+// objects created in a row are close in memory and creating or removing one
+// doesn't go through the heap. Chunks are only released with the pool.
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <vector>
+
+class C4ObjectPool
+{
+	size_t BlockSize, ChunkBlocks;
+	std::vector<std::unique_ptr<unsigned char[]>> Chunks;
+	void *FirstFree = nullptr;
+	size_t UsedCount = 0;
+
+public:
+	C4ObjectPool(size_t iBlockSize, size_t iChunkBlocks)
+		: BlockSize{(iBlockSize + alignof(std::max_align_t) - 1) / alignof(std::max_align_t) * alignof(std::max_align_t)},
+		ChunkBlocks{iChunkBlocks} {}
+	C4ObjectPool(const C4ObjectPool &) = delete;
+	C4ObjectPool &operator=(const C4ObjectPool &) = delete;
+
+	void *Alloc(size_t iSize)
+	{
+		// derived classes might be larger
+		if (iSize > BlockSize) return ::operator new(iSize);
+		if (!FirstFree) AddChunk();
+		void *pBlock = FirstFree;
+		FirstFree = *static_cast<void **>(pBlock);
+		++UsedCount;
+		return pBlock;
+	}
+
+	void Free(void *pBlock, size_t iSize)
+	{
+		if (!pBlock) return;
+		if (iSize > BlockSize) { ::operator delete(pBlock); return; }
+		// the most recently freed block is reused first, as it's most likely still cached
+		*static_cast<void **>(pBlock) = FirstFree;
+		FirstFree = pBlock;
+		--UsedCount;
+	}
+
+	size_t GetUsedCount() const { return UsedCount; }
+	size_t GetChunkCount() const { return Chunks.size(); }
+
+private:
+	void AddChunk()
+	{
+		Chunks.emplace_back(new unsigned char[BlockSize * ChunkBlocks]);
+		unsigned char *pChunk = Chunks.back().get();
+		// link backwards, so blocks are handed out in address order
+		for (size_t i = ChunkBlocks; i--; )
+		{
+			void *pBlock = pChunk + i * BlockSize;
+			*static_cast<void **>(pBlock) = FirstFree;
+			FirstFree = pBlock;
+		}
+	}
+};
+
+extern C4ObjectPool ObjectPool, ObjectLinkPool;
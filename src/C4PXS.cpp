@@ -239,65 +239,67 @@ void C4PXSSystem::Draw(C4FacetEx &cgo)
 	C4Rect VisibleRect(cgo.TargetX, cgo.TargetY, cgo.Wdt, cgo.Hgt);
 	VisibleRect.Enlarge(20);
 
-	// First pass: draw old-style PXS (lines/pixels)
+	// Colors of old-style PXS by material
+	const bool fPXSGfx = Config.Graphics.PXSGfx;
+	MatClrs.resize(Game.Material.Num);
+	for (int32_t iMat = 0; iMat < Game.Material.Num; ++iMat)
+		MatClrs[iMat] = Game.Landscape.GetPal()->GetClr((uint8_t)(Mat2PixColDefault(iMat)));
+
+	// First pass: collect old-style PXS (lines/pixels) and remember new-style PXS
 	int32_t cgox = cgo.X - cgo.TargetX, cgoy = cgo.Y - cgo.TargetY;
+	PixVertices.clear(); LineVertices.clear(); GfxPXS.clear();
 	unsigned int cnt;
 	for (cnt = 0; cnt < PXSMaxChunk; cnt++)
 		if (Chunk[cnt] && iChunkPXS[cnt])
 		{
 			C4PXS *pxp = Chunk[cnt];
-			for (unsigned int cnt2 = 0; cnt2 < PXSChunkSize; cnt2++, pxp++)
-				if (pxp->Mat != MNone && VisibleRect.Contains(fixtoi(pxp->x), fixtoi(pxp->y)))
+			size_t iLeft = iChunkPXS[cnt];
+			for (unsigned int cnt2 = 0; iLeft && cnt2 < PXSChunkSize; cnt2++, pxp++)
+				if (pxp->Mat != MNone)
 				{
-					C4Material *pMat = &Game.Material.Map[pxp->Mat];
-					if (pMat->PXSFace.Surface && Config.Graphics.PXSGfx)
+					--iLeft;
+					if (!VisibleRect.Contains(fixtoi(pxp->x), fixtoi(pxp->y))) continue;
+					if (fPXSGfx && Game.Material.Map[pxp->Mat].PXSFace.Surface)
+					{
+						GfxPXS.push_back(cnt * PXSChunkSize + cnt2);
 						continue;
+					}
 					// old-style: unicolored pixels or lines
-					uint32_t dwMatClr = Game.Landscape.GetPal()->GetClr((uint8_t)(Mat2PixColDefault(pxp->Mat)));
+					uint32_t dwMatClr = MatClrs[pxp->Mat];
 					if (fixtoi(pxp->xdir) || fixtoi(pxp->ydir))
 					{
 						// lines for stuff that goes whooosh!
 						int len = fixtoi(Abs(pxp->xdir) + Abs(pxp->ydir));
 						dwMatClr = uint32_t(std::max<int>(dwMatClr >> 24, 195 - (195 - (dwMatClr >> 24)) / len)) << 24 | (dwMatClr & 0xffffff);
-						Application.DDraw->DrawLineDw(cgo.Surface,
-							fixtof(pxp->x - pxp->xdir) + cgox, fixtof(pxp->y - pxp->ydir) + cgoy,
-							fixtof(pxp->x) + cgox, fixtof(pxp->y) + cgoy,
-							dwMatClr);
+						LineVertices.push_back({ fixtof(pxp->x - pxp->xdir) + cgox, fixtof(pxp->y - pxp->ydir) + cgoy, dwMatClr });
+						LineVertices.push_back({ fixtof(pxp->x) + cgox, fixtof(pxp->y) + cgoy, dwMatClr });
 					}
 					else
 						// single pixels for slow stuff
-						Application.DDraw->DrawPix(cgo.Surface, fixtof(pxp->x) + cgox, fixtof(pxp->y) + cgoy, dwMatClr);
+						PixVertices.push_back({ fixtof(pxp->x) + cgox, fixtof(pxp->y) + cgoy, dwMatClr });
 				}
 		}
-
-	// PXS graphics disabled?
-	if (!Config.Graphics.PXSGfx)
-		return;
+	Application.DDraw->DrawLinesDw(cgo.Surface, LineVertices.data(), LineVertices.size());
+	Application.DDraw->DrawPixelsDw(cgo.Surface, PixVertices.data(), PixVertices.size());
 
 	// Second pass: draw new-style PXS (graphics)
-	for (cnt = 0; cnt < PXSMaxChunk; cnt++)
-		if (Chunk[cnt] && iChunkPXS[cnt])
-		{
-			C4PXS *pxp = Chunk[cnt];
-			for (unsigned int cnt2 = 0; cnt2 < PXSChunkSize; cnt2++, pxp++)
-				if (pxp->Mat != MNone && VisibleRect.Contains(fixtoi(pxp->x), fixtoi(pxp->y)))
-				{
-					C4Material *pMat = &Game.Material.Map[pxp->Mat];
-					if (!pMat->PXSFace.Surface)
-						continue;
-					// new-style: graphics
-					int32_t pnx, pny;
-					pMat->PXSFace.GetPhaseNum(pnx, pny);
-					int32_t fcWdt = pMat->PXSFace.Wdt; int32_t fcWdtH = (std::max)(fcWdt / 3, 1);
-					// calculate draw width and tile to use (random-ish)
-					int32_t z = 1 + ((cnt2 / std::max<int32_t>(pnx * pny, 1)) ^ 341) % pMat->PXSGfxSize;
-					pny = (cnt2 / pnx) % pny; pnx = cnt2 % pnx;
-					// draw
-					Application.DDraw->ActivateBlitModulation((std::min)((fcWdtH - z) * 16, 255) << 24 | 0xffffff);
-					pMat->PXSFace.DrawX(cgo.Surface, fixtoi(pxp->x) + cgox + z * pMat->PXSGfxRt.tx / fcWdt, fixtoi(pxp->y) + cgoy + z * pMat->PXSGfxRt.ty / fcWdt, z, z * pMat->PXSFace.Hgt / fcWdt, pnx, pny);
-					Application.DDraw->DeactivateBlitModulation();
-				}
-		}
+	for (size_t iIndex : GfxPXS)
+	{
+		const unsigned int cnt2 = iIndex % PXSChunkSize;
+		C4PXS *pxp = Chunk[iIndex / PXSChunkSize] + cnt2;
+		C4Material *pMat = &Game.Material.Map[pxp->Mat];
+		// new-style: graphics
+		int32_t pnx, pny;
+		pMat->PXSFace.GetPhaseNum(pnx, pny);
+		int32_t fcWdt = pMat->PXSFace.Wdt; int32_t fcWdtH = (std::max)(fcWdt / 3, 1);
+		// calculate draw width and tile to use (random-ish)
+		int32_t z = 1 + ((cnt2 / std::max<int32_t>(pnx * pny, 1)) ^ 341) % pMat->PXSGfxSize;
+		pny = (cnt2 / pnx) % pny; pnx = cnt2 % pnx;
+		// draw
+		Application.DDraw->ActivateBlitModulation((std::min)((fcWdtH - z) * 16, 255) << 24 | 0xffffff);
+		pMat->PXSFace.DrawX(cgo.Surface, fixtoi(pxp->x) + cgox + z * pMat->PXSGfxRt.tx / fcWdt, fixtoi(pxp->y) + cgoy + z * pMat->PXSGfxRt.ty / fcWdt, z, z * pMat->PXSFace.Hgt / fcWdt, pnx, pny);
+		Application.DDraw->DeactivateBlitModulation();
+	}
 }
 
 void C4PXSSystem::Cast(int32_t mat, int32_t num, int32_t tx, int32_t ty, int32_t level)
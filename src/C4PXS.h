@@ -19,6 +19,9 @@
 #pragma once
 
 #include <C4Material.h>
+#include <StdDDraw2.h>
+
+#include <vector>
 
 class C4PXS
 {
@@ -49,6 +52,10 @@ public:
 protected:
 	C4PXS *Chunk[PXSMaxChunk];
 	size_t iChunkPXS[PXSMaxChunk];
+	// draw buffers, kept to avoid reallocation
+	std::vector<uint32_t> MatClrs; // pixel color by material
+	std::vector<CBltVertex> PixVertices, LineVertices;
+	std::vector<size_t> GfxPXS; // visible PXS drawn with graphics, by index
 
 public:
 	void Delete(C4PXS *pPXS);
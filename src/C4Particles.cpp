@@ -773,8 +773,15 @@ void fxStdDraw(C4Particle *pPrt, C4FacetEx &cgo, C4Object *pTarget)
 			r = (((int32_t)(pPrt->x * 23 + pPrt->y * 12)) % 360) * 100;
 		// draw at pos
 		Application.DDraw->ActivateBlitModulation(pPrt->b);
-		Application.DDraw->StorePrimaryClipper();
-		Application.DDraw->SubPrimaryClipper(cgox, cgoy + pDef->YOff, 100000, 100000);
+		// clip at the landscape top left; changing the clipper flushes batched particles, so only do it if it cuts anything
+		int32_t iClipX1, iClipY1, iClipX2, iClipY2;
+		Application.DDraw->GetPrimaryClipper(iClipX1, iClipY1, iClipX2, iClipY2);
+		const bool fClip = (cgox > iClipX1 || cgoy + pDef->YOff > iClipY1);
+		if (fClip)
+		{
+			Application.DDraw->StorePrimaryClipper();
+			Application.DDraw->SubPrimaryClipper(cgox, cgoy + pDef->YOff, 100000, 100000);
+		}
 		if (pDef->Additive) lpDDraw->SetBlitMode(C4GFXBLIT_ADDITIVE);
 		int32_t iDrawWdt = int32_t(pPrt->a);
 		int32_t iDrawHgt = int32_t(pDef->Aspect * iDrawWdt);
@@ -783,7 +790,7 @@ void fxStdDraw(C4Particle *pPrt, C4FacetEx &cgo, C4Object *pTarget)
 		else
 			pDef->Gfx.DrawX(cgo.Surface, cx - iDrawWdt, cy - iDrawHgt, iDrawWdt * 2, iDrawHgt * 2, iPhase, 0);
 		Application.DDraw->ResetBlitMode();
-		Application.DDraw->RestorePrimaryClipper();
+		if (fClip) Application.DDraw->RestorePrimaryClipper();
 		Application.DDraw->DeactivateBlitModulation();
 }
 
@@ -46,6 +46,9 @@
 
 #include <C4FacetEx.h>
 #include <C4Game.h>
+#include <C4Wrappers.h>
+
+#include <algorithm>
 
 const int32_t C4PF_MaxDepth  = 35,
               C4PF_MaxCrawl  = 800,
@@ -68,7 +71,13 @@ const int32_t C4PF_MaxDepth  = 35,
               C4PF_Crawl_Bottom   = 3,
               C4PF_Crawl_Left     = 4,
 
-              C4PF_Draw_Rate = 10;
+              C4PF_Draw_Rate = 10,
+
+              C4PF_GraphCellSize     = 16,
+              C4PF_GraphRebuildDelay = 100, // frames
+              C4PF_CacheCellSize     = 8,
+              C4PF_CacheSize         = 128,
+              C4PF_ZoneExitRange     = 21; // see C4TransferZone::GetEntryPoint
 
 // C4PathFinderRay
 
@@ -390,12 +399,10 @@ void C4PathFinderRay::SetCompletePath()
 	{
 		// Transfer waypoint
 		if (pRay->UseZone)
-			pPathFinder->SetWaypoint(pRay->X2, pRay->Y2, (intptr_t)pRay->UseZone->Object,
-				pPathFinder->WaypointParameter);
+			pPathFinder->AddWaypoint(pRay->X2, pRay->Y2, (intptr_t)pRay->UseZone->Object);
 		// MoveTo waypoint
 		else
-			pPathFinder->SetWaypoint(pRay->From->X2, pRay->From->Y2, 0,
-				pPathFinder->WaypointParameter);
+			pPathFinder->AddWaypoint(pRay->From->X2, pRay->From->Y2, 0);
 	}
 }
 
@@ -510,6 +517,198 @@ bool C4PathFinderRay::CheckBackRayShorten()
 	return false;
 }
 
+// C4PathFinderGraph
+
+C4PathFinderGraph::C4PathFinderGraph()
+{
+	PointFree = nullptr;
+	Clear();
+}
+
+void C4PathFinderGraph::Clear()
+{
+	Wdt = Hgt = 0;
+	Parent.clear();
+	Changes.clear();
+	ChangeStamp = 0;
+	Stale = false;
+	BuildFrame = 0;
+}
+
+bool C4PathFinderGraph::Prepare(bool(*fnPointFree)(int32_t, int32_t))
+{
+	PointFree = fnPointFree;
+	// (Re)allocate for current landscape
+	const int32_t iWdt = (GBackWdt + C4PF_GraphCellSize - 1) / C4PF_GraphCellSize,
+	              iHgt = (GBackHgt + C4PF_GraphCellSize - 1) / C4PF_GraphCellSize;
+	if (iWdt != Wdt || iHgt != Hgt || Parent.empty())
+	{
+		Wdt = iWdt; Hgt = iHgt;
+		Changes.assign(Wdt * Hgt, 0);
+		ChangeStamp = 0;
+		Build();
+		return true;
+	}
+	// Regain lost precision every now and then
+	if (Stale && Game.FrameCounter - BuildFrame >= C4PF_GraphRebuildDelay)
+		Build();
+	return false;
+}
+
+void C4PathFinderGraph::Build()
+{
+	Parent.resize(Wdt * Hgt + 1);
+	for (int32_t i = 0; i <= Wdt * Hgt; i++) Parent[i] = i;
+	LinkCells(0, 0, Wdt - 1, Hgt - 1);
+	Stale = false;
+	BuildFrame = Game.FrameCounter;
+}
+
+void C4PathFinderGraph::LinkCells(int32_t iCX1, int32_t iCY1, int32_t iCX2, int32_t iCY2)
+{
+	iCX1 = std::max<int32_t>(iCX1, 0); iCY1 = std::max<int32_t>(iCY1, 0);
+	iCX2 = std::min<int32_t>(iCX2, Wdt - 1); iCY2 = std::min<int32_t>(iCY2, Hgt - 1);
+	// Check all free pixel pairs across the right and bottom border of each cell
+	for (int32_t iCY = iCY1; iCY <= iCY2; iCY++)
+		for (int32_t iCX = iCX1; iCX <= iCX2; iCX++)
+		{
+			const int32_t iCell = iCY * Wdt + iCX;
+			const int32_t iX1 = iCX * C4PF_GraphCellSize, iY1 = iCY * C4PF_GraphCellSize,
+			              iX2 = iX1 + C4PF_GraphCellSize - 1, iY2 = iY1 + C4PF_GraphCellSize - 1;
+			for (int32_t iY = iY1; iY <= iY2; iY++)
+				if (PointFree(iX2, iY))
+					for (int32_t iDY = -1; iDY <= +1; iDY++)
+						if (PointFree(iX2 + 1, iY + iDY))
+							Link(iCell, GetCell(iX2 + 1, iY + iDY));
+			for (int32_t iX = iX1; iX <= iX2; iX++)
+				if (PointFree(iX, iY2))
+					for (int32_t iDX = -1; iDX <= +1; iDX++)
+						if (PointFree(iX + iDX, iY2 + 1))
+							Link(iCell, GetCell(iX + iDX, iY2 + 1));
+			// Open borders: the left and top border of the map lead outside, too
+			if (!iCX)
+				for (int32_t iY = iY1; iY <= iY2; iY++)
+					if (PointFree(iX1, iY) && (PointFree(iX1 - 1, iY - 1) || PointFree(iX1 - 1, iY) || PointFree(iX1 - 1, iY + 1)))
+						Link(iCell, Wdt * Hgt);
+			if (!iCY)
+				for (int32_t iX = iX1; iX <= iX2; iX++)
+					if (PointFree(iX, iY1) && (PointFree(iX - 1, iY1 - 1) || PointFree(iX, iY1 - 1) || PointFree(iX + 1, iY1 - 1)))
+						Link(iCell, Wdt * Hgt);
+		}
+}
+
+void C4PathFinderGraph::LinkPix(int32_t iX, int32_t iY)
+{
+	const int32_t iCell = GetCell(iX, iY);
+	for (int32_t iDY = -1; iDY <= +1; iDY++)
+		for (int32_t iDX = -1; iDX <= +1; iDX++)
+			if (PointFree(iX + iDX, iY + iDY))
+			{
+				const int32_t iCell2 = GetCell(iX + iDX, iY + iDY);
+				if (iCell2 != iCell) Link(iCell, iCell2);
+			}
+}
+
+void C4PathFinderGraph::Link(int32_t iCell1, int32_t iCell2)
+{
+	const int32_t iComp1 = GetComponent(iCell1), iComp2 = GetComponent(iCell2);
+	if (iComp1 != iComp2) Parent[std::max(iComp1, iComp2)] = std::min(iComp1, iComp2);
+}
+
+int32_t C4PathFinderGraph::GetComponent(int32_t iCell)
+{
+	while (Parent[iCell] != iCell)
+	{
+		Parent[iCell] = Parent[Parent[iCell]];
+		iCell = Parent[iCell];
+	}
+	return iCell;
+}
+
+int32_t C4PathFinderGraph::GetCell(int32_t iX, int32_t iY) const
+{
+	// Everything beyond the map is one virtual cell: with open borders, paths may lead around the map
+	if (iX < 0 || iY < 0 || iX >= Wdt * C4PF_GraphCellSize || iY >= Hgt * C4PF_GraphCellSize) return Wdt * Hgt;
+	return (iY / C4PF_GraphCellSize) * Wdt + iX / C4PF_GraphCellSize;
+}
+
+bool C4PathFinderGraph::Connected(int32_t iFromX, int32_t iFromY, int32_t iToX, int32_t iToY, const std::vector<C4Rect> *pZones)
+{
+	if (Parent.empty()) return true;
+	const int32_t iTarget = GetComponent(GetCell(iToX, iToY));
+	std::vector<int32_t> Reached{GetComponent(GetCell(iFromX, iFromY))};
+	if (Reached.front() == iTarget) return true;
+	if (!pZones) return false;
+	// Transfer zones connect all cells around them
+	std::vector<bool> ZoneUsed(pZones->size(), false);
+	std::vector<int32_t> ZoneComps;
+	for (bool fChanged = true; fChanged; )
+	{
+		fChanged = false;
+		for (size_t iZone = 0; iZone < pZones->size(); iZone++)
+		{
+			if (ZoneUsed[iZone]) continue;
+			const C4Rect &rZone = (*pZones)[iZone];
+			ZoneComps.clear();
+			bool fReached = false;
+			for (int32_t iCY = std::max<int32_t>(rZone.y / C4PF_GraphCellSize, 0); iCY <= std::min<int32_t>((rZone.y + rZone.Hgt - 1) / C4PF_GraphCellSize, Hgt - 1); iCY++)
+				for (int32_t iCX = std::max<int32_t>(rZone.x / C4PF_GraphCellSize, 0); iCX <= std::min<int32_t>((rZone.x + rZone.Wdt - 1) / C4PF_GraphCellSize, Wdt - 1); iCX++)
+				{
+					const int32_t iComp = GetComponent(iCY * Wdt + iCX);
+					ZoneComps.push_back(iComp);
+					if (std::find(Reached.begin(), Reached.end(), iComp) != Reached.end()) fReached = true;
+				}
+			if (!fReached) continue;
+			// Zone reached: everything around it is reachable
+			ZoneUsed[iZone] = true;
+			fChanged = true;
+			for (int32_t iComp : ZoneComps)
+			{
+				if (iComp == iTarget) return true;
+				if (std::find(Reached.begin(), Reached.end(), iComp) == Reached.end()) Reached.push_back(iComp);
+			}
+		}
+	}
+	return false;
+}
+
+void C4PathFinderGraph::OnChange(int32_t iX, int32_t iY, bool fFreed)
+{
+	if (Parent.empty() || GetCell(iX, iY) == Wdt * Hgt) return;
+	Changes[GetCell(iX, iY)] = ++ChangeStamp;
+	// New connections must be known right away, lost ones just cost precision
+	if (fFreed)
+		LinkPix(iX, iY);
+	else
+		Stale = true;
+}
+
+void C4PathFinderGraph::OnChange(const C4Rect &rRect)
+{
+	if (Parent.empty()) return;
+	const int32_t iCX1 = std::max<int32_t>(rRect.x / C4PF_GraphCellSize, 0), iCY1 = std::max<int32_t>(rRect.y / C4PF_GraphCellSize, 0),
+	              iCX2 = std::min<int32_t>((rRect.x + rRect.Wdt - 1) / C4PF_GraphCellSize, Wdt - 1), iCY2 = std::min<int32_t>((rRect.y + rRect.Hgt - 1) / C4PF_GraphCellSize, Hgt - 1);
+	++ChangeStamp;
+	for (int32_t iCY = iCY1; iCY <= iCY2; iCY++)
+		for (int32_t iCX = iCX1; iCX <= iCX2; iCX++)
+			Changes[iCY * Wdt + iCX] = ChangeStamp;
+	// Include the borders to the left and top neighbours
+	LinkCells(iCX1 - 1, iCY1 - 1, iCX2, iCY2);
+	Stale = true;
+}
+
+bool C4PathFinderGraph::ChangedSince(const C4Rect &rRect, uint32_t iStamp)
+{
+	if (Parent.empty()) return true;
+	const int32_t iCX1 = std::max<int32_t>(rRect.x / C4PF_GraphCellSize, 0), iCY1 = std::max<int32_t>(rRect.y / C4PF_GraphCellSize, 0),
+	              iCX2 = std::min<int32_t>((rRect.x + rRect.Wdt - 1) / C4PF_GraphCellSize, Wdt - 1), iCY2 = std::min<int32_t>((rRect.y + rRect.Hgt - 1) / C4PF_GraphCellSize, Hgt - 1);
+	for (int32_t iCY = iCY1; iCY <= iCY2; iCY++)
+		for (int32_t iCX = iCX1; iCX <= iCX2; iCX++)
+			if (Changes[iCY * Wdt + iCX] > iStamp)
+				return true;
+	return false;
+}
+
 // C4PathFinder
 
 C4PathFinder::C4PathFinder()
@@ -532,15 +731,114 @@ void C4PathFinder::Default()
 	TransferZones = nullptr;
 	TransferZonesEnabled = true;
 	Level = 1;
+	Synchronize();
 }
 
 void C4PathFinder::Clear()
+{
+	ClearRays();
+	Synchronize();
+}
+
+void C4PathFinder::ClearRays()
 {
 	C4PathFinderRay *pRay, *pNext;
 	for (pRay = FirstRay; pRay; pRay = pNext) { pNext = pRay->Next; delete pRay; }
 	FirstRay = nullptr;
 }
 
+void C4PathFinder::Synchronize()
+{
+	// Cached results must not depend on the history of this client
+	Cache.clear();
+	FoundWaypoints.clear();
+	Graph.Clear();
+	ZoneRects.clear();
+	ZoneRevision = UINT32_MAX;
+}
+
+void C4PathFinder::UpdateZones()
+{
+	if (!TransferZones || TransferZones->GetRevision() == ZoneRevision) return;
+	ZoneRevision = TransferZones->GetRevision();
+	ZoneRects.clear();
+	for (C4TransferZone *pZone = TransferZones->First; pZone; pZone = pZone->Next)
+	{
+		C4Rect rcZone(pZone->X, pZone->Y, pZone->Wdt, pZone->Hgt);
+		rcZone.Enlarge(C4PF_ZoneExitRange);
+		ZoneRects.push_back(rcZone);
+	}
+	// Cached paths might use changed zones
+	Cache.clear();
+}
+
+C4PathFinder::CachedPath &C4PathFinder::GetCachedPath(int32_t iFromX, int32_t iFromY, int32_t iToX, int32_t iToY)
+{
+	if (Cache.empty()) Cache.resize(C4PF_CacheSize);
+	const uint32_t iHash = (static_cast<uint32_t>(iFromX / C4PF_CacheCellSize) * 73856093u)
+		^ (static_cast<uint32_t>(iFromY / C4PF_CacheCellSize) * 19349663u)
+		^ (static_cast<uint32_t>(iToX / C4PF_CacheCellSize) * 83492791u)
+		^ (static_cast<uint32_t>(iToY / C4PF_CacheCellSize) * 2654435761u)
+		^ static_cast<uint32_t>(Level);
+	return Cache[iHash % C4PF_CacheSize];
+}
+
+bool C4PathFinder::UseCachedPath(CachedPath &rPath, int32_t iFromX, int32_t iFromY, int32_t iToX, int32_t iToY)
+{
+	// Same search?
+	if (!rPath.Used || rPath.Level != Level || rPath.TransferZonesEnabled != TransferZonesEnabled) return false;
+	if (rPath.FromX != iFromX / C4PF_CacheCellSize || rPath.FromY != iFromY / C4PF_CacheCellSize) return false;
+	if (rPath.ToX != iToX / C4PF_CacheCellSize || rPath.ToY != iToY / C4PF_CacheCellSize) return false;
+	// Landscape changed in the searched area
+	if (Graph.ChangedSince(rPath.Bounds, rPath.Stamp)) { rPath.Used = false; return false; }
+	// Start and target may differ by a few pixels: check the first and the last leg
+	if (rPath.Waypoints.empty())
+	{
+		if (!PathFree(iFromX, iFromY, iToX, iToY)) return false;
+	}
+	else
+	{
+		const CachedWaypoint &rFirst = rPath.Waypoints.back(), &rLast = rPath.Waypoints.front();
+		if (!PathFree(iFromX, iFromY, rFirst.X, rFirst.Y)) return false;
+		if (!rLast.Transfer && !PathFree(rLast.X, rLast.Y, iToX, iToY)) return false;
+	}
+	// Set waypoints
+	for (const CachedWaypoint &rWaypoint : rPath.Waypoints)
+		SetWaypoint(rWaypoint.X, rWaypoint.Y, rWaypoint.Transfer, WaypointParameter);
+	return true;
+}
+
+void C4PathFinder::CachePath(CachedPath &rPath, int32_t iFromX, int32_t iFromY, int32_t iToX, int32_t iToY)
+{
+	rPath.Used = true;
+	rPath.TransferZonesEnabled = TransferZonesEnabled;
+	rPath.Level = Level;
+	rPath.FromX = iFromX / C4PF_CacheCellSize; rPath.FromY = iFromY / C4PF_CacheCellSize;
+	rPath.ToX = iToX / C4PF_CacheCellSize; rPath.ToY = iToY / C4PF_CacheCellSize;
+	rPath.Stamp = Graph.GetChangeStamp();
+	// Area the result depends on
+	rPath.Bounds = C4Rect(iFromX, iFromY, 1, 1);
+	rPath.Bounds.Add(C4Rect(iToX, iToY, 1, 1));
+	rPath.Waypoints = FoundWaypoints;
+	for (const CachedWaypoint &rWaypoint : FoundWaypoints)
+		rPath.Bounds.Add(C4Rect(rWaypoint.X, rWaypoint.Y, 1, 1));
+	rPath.Bounds.Enlarge(1);
+}
+
+bool C4PathFinder::PathFree(int32_t iX, int32_t iY, int32_t iToX, int32_t iToY)
+{
+	// Same check as a launching ray
+	C4PathFinderRay Ray;
+	Ray.pPathFinder = this;
+	return Ray.PathFree(iX, iY, iToX, iToY);
+}
+
+void C4PathFinder::AddWaypoint(int32_t iX, int32_t iY, intptr_t iTransfer)
+{
+	FoundWaypoints.push_back({iX, iY, iTransfer});
+	SetWaypoint(iX, iY, iTransfer, WaypointParameter);
+}
+
 void C4PathFinder::Init(bool(*fnPointFree)(int32_t, int32_t), C4TransferZones *pTransferZones)
 {
 	// Set data
@@ -601,7 +899,7 @@ bool C4PathFinder::Execute()
 bool C4PathFinder::Find(int32_t iFromX, int32_t iFromY, int32_t iToX, int32_t iToY, bool(*fnSetWaypoint)(int32_t, int32_t, intptr_t, intptr_t), intptr_t iWaypointParameter)
 {
 	// Prepare
-	Clear();
+	ClearRays();
 
 	// Parameter safety
 	if (!fnSetWaypoint) return false;
@@ -611,13 +909,29 @@ bool C4PathFinder::Find(int32_t iFromX, int32_t iFromY, int32_t iToX, int32_t iT
 	// Start & target coordinates must be free
 	if (!PointFree(iFromX, iFromY) || !PointFree(iToX, iToY)) return false;
 
+	// Transfer zones or the whole landscape changed: cached results are void
+	UpdateZones();
+	if (Graph.Prepare(PointFree)) Cache.clear();
+
+	// Same search done before
+	CachedPath &rCached = GetCachedPath(iFromX, iFromY, iToX, iToY);
+	if (UseCachedPath(rCached, iFromX, iFromY, iToX, iToY)) return true;
+
+	// Target not reachable at all
+	if (!Graph.Connected(iFromX, iFromY, iToX, iToY, (TransferZonesEnabled && TransferZones) ? &ZoneRects : nullptr)) return false;
+
 	// Add the first two rays
 	if (!AddRay(iFromX, iFromY, iToX, iToY, 0, C4PF_Direction_Left, nullptr)) return false;
 	if (!AddRay(iFromX, iFromY, iToX, iToY, 0, C4PF_Direction_Right, nullptr)) return false;
 
 	// Run
+	FoundWaypoints.clear();
 	Run();
 
+	// Remember found paths; failures aren't cached, as a start a few pixels off might succeed
+	// (and unreachable targets are rejected by the graph cheaply anyway)
+	if (Success) CachePath(rCached, iFromX, iFromY, iToX, iToY);
+
 	// Success
 	return Success;
 }
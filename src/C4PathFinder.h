@@ -18,8 +18,11 @@
 
 #pragma once
 
+#include <C4Shape.h>
 #include <C4TransferZone.h>
 
+#include <vector>
+
 class C4PathFinderRay
 {
 	friend class C4PathFinder;
@@ -59,6 +62,41 @@ protected:
 	bool PathFree(int32_t &rX, int32_t &rY, int32_t iToX, int32_t iToY, C4TransferZone **ppZone = nullptr);
 };
 
+// Coarse connectivity of the free landscape: cells are linked if free pixels touch across
+// their border. This overestimates connectivity, so a target in another component can
+// never be reached and is rejected without crawling.
+class C4PathFinderGraph
+{
+public:
+	C4PathFinderGraph();
+
+protected:
+	bool(*PointFree)(int32_t, int32_t);
+	int32_t Wdt, Hgt; // in cells
+	std::vector<int32_t> Parent; // union-find forest over cells, plus one for everything beyond the map
+	std::vector<uint32_t> Changes; // stamp of the last passability change per cell
+	uint32_t ChangeStamp;
+	bool Stale; // connections might have been lost since the last build
+	int32_t BuildFrame;
+
+public:
+	void Clear();
+	bool Prepare(bool(*fnPointFree)(int32_t, int32_t));
+	bool Connected(int32_t iFromX, int32_t iFromY, int32_t iToX, int32_t iToY, const std::vector<C4Rect> *pZones);
+	void OnChange(int32_t iX, int32_t iY, bool fFreed);
+	void OnChange(const C4Rect &rRect);
+	bool ChangedSince(const C4Rect &rRect, uint32_t iStamp);
+	uint32_t GetChangeStamp() const { return ChangeStamp; }
+
+protected:
+	void Build();
+	void Link(int32_t iCell1, int32_t iCell2);
+	void LinkCells(int32_t iCX1, int32_t iCY1, int32_t iCX2, int32_t iCY2);
+	void LinkPix(int32_t iX, int32_t iY);
+	int32_t GetComponent(int32_t iCell);
+	int32_t GetCell(int32_t iX, int32_t iY) const;
+};
+
 class C4PathFinder
 {
 	friend class C4PathFinderRay;
@@ -79,6 +117,28 @@ protected:
 	bool TransferZonesEnabled;
 	int Level;
 
+	// cache of found paths
+	struct CachedWaypoint
+	{
+		int32_t X, Y;
+		intptr_t Transfer;
+	};
+	struct CachedPath
+	{
+		bool Used, TransferZonesEnabled;
+		int Level;
+		int32_t FromX, FromY, ToX, ToY; // in cache cells
+		uint32_t Stamp;
+		C4Rect Bounds;
+		std::vector<CachedWaypoint> Waypoints; // in order of SetWaypoint calls
+	};
+	std::vector<CachedPath> Cache;
+	std::vector<CachedWaypoint> FoundWaypoints;
+
+	C4PathFinderGraph Graph;
+	std::vector<C4Rect> ZoneRects; // transfer zones, enlarged by exit point range
+	uint32_t ZoneRevision;
+
 public:
 	void Draw(C4FacetEx &cgo);
 	void Clear();
@@ -87,8 +147,18 @@ public:
 	bool Find(int32_t iFromX, int32_t iFromY, int32_t iToX, int32_t iToY, bool(*fnSetWaypoint)(int32_t, int32_t, intptr_t, intptr_t), intptr_t iWaypointParameter);
 	void EnableTransferZones(bool fEnabled);
 	void SetLevel(int iLevel);
+	void Synchronize();
+	void OnLandscapeChange(int32_t iX, int32_t iY, bool fFreed) { Graph.OnChange(iX, iY, fFreed); }
+	void OnLandscapeChange(const C4Rect &rRect) { Graph.OnChange(rRect); }
 
 protected:
+	void ClearRays();
+	void UpdateZones();
+	CachedPath &GetCachedPath(int32_t iFromX, int32_t iFromY, int32_t iToX, int32_t iToY);
+	bool UseCachedPath(CachedPath &rPath, int32_t iFromX, int32_t iFromY, int32_t iToX, int32_t iToY);
+	void CachePath(CachedPath &rPath, int32_t iFromX, int32_t iFromY, int32_t iToX, int32_t iToY);
+	void AddWaypoint(int32_t iX, int32_t iY, intptr_t iTransfer);
+	bool PathFree(int32_t iX, int32_t iY, int32_t iToX, int32_t iToY);
 	void Run();
 	bool AddRay(int32_t iFromX, int32_t iFromY, int32_t iToX, int32_t iToY, int32_t iDepth, int32_t iDirection, C4PathFinderRay *pFrom, C4TransferZone *pUseZone = nullptr);
 	bool SplitRay(C4PathFinderRay *pRay, int32_t iAtX, int32_t iAtY);
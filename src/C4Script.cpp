@@ -1108,6 +1108,8 @@ static bool FnSetActionTargets(C4AulContext *cthr, C4Object *pTarget1, C4Object
 	// set targets
 	pObj->Action.Target = pTarget1;
 	pObj->Action.Target2 = pTarget2;
+	pObj->AddReference(pTarget1);
+	pObj->AddReference(pTarget2);
 	return true;
 }
 
@@ -4573,6 +4575,7 @@ static bool FnSetGraphics(C4AulContext *pCtx, C4String *pGfxName, C4Object *pObj
 		case C4GraphicsOverlay::MODE_Object:
 			if (pOverlayObject && !pOverlayObject->Status) pOverlayObject = nullptr;
 			pOverlay->SetAsObject(pOverlayObject, dwBlitMode);
+			pObj->AddReference(pOverlayObject);
 			break;
 
 		case C4GraphicsOverlay::MODE_ExtraGraphics:
@@ -5470,11 +5473,11 @@ static bool FnSetObjectLayer(C4AulContext *ctx, C4Object *pNewLayer, C4Object *p
 	// local call/safety
 	if (!pObj) if (!(pObj = ctx->Obj)) return false;
 	// set layer object
-	pObj->pLayer = pNewLayer;
+	pObj->AddReference(pObj->pLayer = pNewLayer);
 	// set for all contents as well
 	for (C4ObjectLink *pLnk = pObj->Contents.First; pLnk; pLnk = pLnk->Next)
 		if ((pObj = pLnk->Obj) && pObj->Status)
-			pObj->pLayer = pNewLayer;
+			pObj->AddReference(pObj->pLayer = pNewLayer);
 	// success
 	return true;
 }
@@ -6574,6 +6577,8 @@ public:
 
 	C4Value Exec(C4AulContext *pContext, C4Value pPars[], bool fPassErrors = false)
 	{
+		// objects stay typed, as untyped values are never guessed to be objects
+		if (RType == C4V_Any && pPars->GetType() == C4V_C4Object) return *pPars;
 		return C4Value(pPars->GetData(), RType);
 	}
 
@@ -146,6 +146,7 @@ bool C4Surface::ReadPNG(CStdStream &hGroup)
 		if (!pTexRef->Lock()) continue;
 		// At the edges, not the whole texture is used
 		int maxY = (std::min)(iTexSize, Hgt - tY * iTexSize), maxX = (std::min)(iTexSize, Wdt - tX * iTexSize);
+		pTexRef->AddDirty(0, 0, maxX, maxY);
 		for (int iY = 0; iY < maxY; ++iY)
 		{
 			// The global, not texture-relative position
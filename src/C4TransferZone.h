@@ -23,6 +23,7 @@ class C4TransferZones;
 class C4TransferZone
 {
 	friend class C4TransferZones;
+	friend class C4PathFinder;
 
 public:
 	C4TransferZone();
@@ -53,6 +54,9 @@ public:
 protected:
 	int32_t RemoveNullZones();
 	C4TransferZone *First;
+	uint32_t Revision; // changed with every zone change
+
+	friend class C4PathFinder;
 
 public:
 	void Default();
@@ -65,4 +69,5 @@ public:
 	C4TransferZone *Find(int32_t iX, int32_t iY);
 	bool Add(int32_t iX, int32_t iY, int32_t iWdt, int32_t iHgt, C4Object *pObj);
 	bool Set(int32_t iX, int32_t iY, int32_t iWdt, int32_t iHgt, C4Object *pObj);
+	uint32_t GetRevision() const { return Revision; }
 };
@@ -34,14 +34,37 @@ const C4Value C4VNull = C4Value();
 const C4Value C4VTrue = C4VBool(true);
 const C4Value C4VFalse = C4VBool(false);
 
+C4Value::C4Value(C4Object *pObj) : Type(pObj ? C4V_C4Object : C4V_Any)
+{
+#ifdef C4ENGINE
+	Data = pObj ? pObj->GetHandle() : C4ObjectHandle{};
+#else
+	Data = C4ObjectHandle{};
+#endif
+	AddDataRef();
+}
+
+void C4Value::SetObject(C4Object *Obj)
+{
+	C4V_Data d;
+#ifdef C4ENGINE
+	d = Obj ? Obj->GetHandle() : C4ObjectHandle{};
+#else
+	d = C4ObjectHandle{};
+#endif
+	Set(d, C4V_C4Object);
+}
+
 C4Value::~C4Value()
 {
 	// resolve all C4Values referencing this Value
-	while (FirstRef)
-		FirstRef->Set(*this);
+	while (C4Value *pRef = GetFirstRef())
+		pRef->Set(*this);
 
 	// delete contents
 	DelDataRef(Data, Type, GetNextRef(), GetBaseContainer());
+
+	if (LinkIndex) ValueLinks.Remove(LinkIndex);
 }
 
 StdStrBuf C4Value::toString() const
@@ -85,19 +108,23 @@ void C4Value::AddDataRef()
 	case C4V_Array: case C4V_Map: Data.Container = Data.Container->IncRef(); break;
 	case C4V_String: Data.Str->IncRef(); break;
 	case C4V_C4Object:
-		Data.Obj->AddRef(this);
+	{
+		C4Object *pObj = Data.Obj.Get();
+		// only values in maps are tracked by the object - all others resolve their handle
+		if (pObj && GetOwningMap()) pObj->AddRef(this);
 #ifdef _DEBUG
 		// check if the object actually exists
-		if (!Game.Objects.ObjectNumber(Data.Obj))
+		if (!pObj)
 		{
-			LogF("Warning: using wild object ptr %p!", Data.Obj);
+			LogF("Warning: using handle of removed object (%u:%u)!", unsigned(Data.Obj.Index), unsigned(Data.Obj.Generation));
 		}
-		else if (!Data.Obj->Status)
+		else if (!pObj->Status)
 		{
-			LogF("Warning: using ptr on deleted object %p (%s)!", Data.Obj, Data.Obj->GetName());
+			LogF("Warning: using ptr on deleted object %p (%s)!", pObj, pObj->GetName());
 		}
 #endif
 		break;
+	}
 #endif
 	default: break;
 	}
@@ -109,12 +136,18 @@ void C4Value::DelDataRef(C4V_Data Data, C4V_Type Type, C4Value *pNextRef, C4Valu
 	switch (Type)
 	{
 	case C4V_pC4Value:
-		// Save because AddDataRef does not set this flag
-		HasBaseContainer = false;
 		Data.Ref->DelRef(this, pNextRef, pBaseContainer);
+		// no reference anymore: drop the list link, so the links record can be freed
+		if (this->Type != C4V_pC4Value) SetNextRef(nullptr);
 		break;
 #ifdef C4ENGINE
-	case C4V_C4Object: Data.Obj->DelRef(this, pNextRef); break;
+	case C4V_C4Object:
+		// the object clears all map values before invalidating its handles
+		if (GetOwningMap())
+			if (C4Object *pObj = Data.Obj.Get())
+				pObj->DelRef(this, pNextRef);
+		if (this->Type != C4V_C4Object) SetNextRef(nullptr);
+		break;
 	case C4V_Array: case C4V_Map: Data.Container->DecRef(); break;
 	case C4V_String: Data.Str->DecRef(); break;
 #endif
@@ -124,14 +157,22 @@ void C4Value::DelDataRef(C4V_Data Data, C4V_Type Type, C4Value *pNextRef, C4Valu
 
 void C4Value::Set(C4V_Data nData, C4V_Type nType)
 {
+#ifdef C4ENGINE
+	// removed object: nil
+	if (nType == C4V_C4Object && !nData.Obj.Get())
+	{
+		nData = C4ObjectHandle{};
+		nType = C4V_Any;
+	}
+#endif
+
 	// Do not add this to the same linked list twice.
 	if (Data == nData && Type == nType) return;
 
 	C4V_Data oData = Data;
 	C4V_Type oType = Type;
-	C4Value *oNextRef = NextRef;
-	auto *oBaseContainer = BaseContainer;
-	auto oHasBaseContainer = HasBaseContainer;
+	C4Value *oNextRef = GetNextRef();
+	C4ValueContainer *oBaseContainer = GetBaseContainer();
 
 	// change
 	Data = nData;
@@ -143,7 +184,7 @@ void C4Value::Set(C4V_Data nData, C4V_Type nType)
 	AddDataRef();
 
 	// clean up
-	DelDataRef(oData, oType, oHasBaseContainer ? nullptr : oNextRef, oHasBaseContainer ? oBaseContainer : nullptr);
+	DelDataRef(oData, oType, oNextRef, oBaseContainer);
 }
 
 void C4Value::Set0()
@@ -158,14 +199,15 @@ void C4Value::Set0()
 	CheckRemoveFromMap();
 
 	// clean up (save even if Data was 0 before)
-	DelDataRef(oData, oType, HasBaseContainer ? nullptr : NextRef, HasBaseContainer ? BaseContainer : nullptr);
+	DelDataRef(oData, oType, GetNextRef(), GetBaseContainer());
 }
 
 void C4Value::CheckRemoveFromMap()
 {
-	if (Type == C4V_Any && OwningMap)
+	if (Type != C4V_Any) return;
+	if (C4ValueHash *pMap = GetOwningMap())
 	{
-		OwningMap->removeValue(this);
+		pMap->removeValue(this);
 	}
 }
 
@@ -174,15 +216,16 @@ void C4Value::Move(C4Value *nValue)
 	nValue->Set(*this);
 
 	// change references
-	for (C4Value *pVal = FirstRef; pVal; pVal = pVal->GetNextRef())
+	C4Value *pFirstRef = GetFirstRef();
+	for (C4Value *pVal = pFirstRef; pVal; pVal = pVal->GetNextRef())
 		pVal->Data.Ref = nValue;
 
 	// copy ref list
-	assert(!nValue->FirstRef);
-	nValue->FirstRef = FirstRef;
+	assert(!nValue->GetFirstRef());
+	nValue->SetFirstRef(pFirstRef);
 
 	// delete usself
-	FirstRef = nullptr;
+	SetFirstRef(nullptr);
 	Set(0);
 }
 
@@ -197,7 +240,7 @@ void C4Value::GetContainerElement(C4Value *index, C4Value &target, C4AulContext
 		{
 			if (index->ConvertTo(C4V_String) && index->_getStr())
 			{
-				auto var = Ref.Data.Obj->LocalNamed.GetItem(index->_getStr()->Data.getData());
+				auto var = Ref._getObj()->LocalNamed.GetItem(index->_getStr()->Data.getData());
 				if (var) target.SetRef(var);
 				else target.Set0();
 			}
@@ -220,15 +263,14 @@ void C4Value::GetContainerElement(C4Value *index, C4Value &target, C4AulContext
 		{
 			index->Deref();
 			// Is target the first ref?
-			if (!Ref.Data.Container->hasIndex(*index) || !(*Ref.Data.Container)[*index].FirstRef)
+			if (!Ref.Data.Container->hasIndex(*index) || !(*Ref.Data.Container)[*index].GetFirstRef())
 			{
 				Ref.Data.Container = Ref.Data.Container->IncElementRef();
 				target.SetRef(&(*Ref.Data.Container)[*index]);
 				if (target.Type == C4V_pC4Value)
 				{
-					assert(!target.NextRef);
-					target.BaseContainer = Ref.Data.Container;
-					target.HasBaseContainer = true;
+					assert(!target.GetNextRef());
+					target.SetBaseContainer(Ref.Data.Container);
 				}
 				// else target apparently owned the last reference to the array
 			}
@@ -260,6 +302,7 @@ const C4Value &C4Value::GetRefVal() const
 	const C4Value *pVal = this;
 	while (pVal->Type == C4V_pC4Value)
 		pVal = pVal->Data.Ref;
+	pVal->CheckObject();
 	return *pVal;
 }
 
@@ -268,44 +311,66 @@ C4Value &C4Value::GetRefVal()
 	C4Value *pVal = this;
 	while (pVal->Type == C4V_pC4Value)
 		pVal = pVal->Data.Ref;
+	pVal->CheckObject();
 	return *pVal;
 }
 
 void C4Value::AddRef(C4Value *pRef)
 {
-	pRef->NextRef = FirstRef;
-	FirstRef = pRef;
+	pRef->SetNextRef(GetFirstRef());
+	SetFirstRef(pRef);
 }
 
 void C4Value::DelRef(const C4Value *pRef, C4Value *pNextRef, C4ValueContainer *pBaseContainer)
 {
-	if (pRef == FirstRef)
-		FirstRef = pNextRef;
+	if (pRef == GetFirstRef())
+		SetFirstRef(pNextRef);
 	else
 	{
-		C4Value *pVal = FirstRef;
-		while (pVal->NextRef != pRef)
+		C4Value *pVal = GetFirstRef();
+		while (pVal->GetNextRef() != pRef)
 		{
 			// assert that pRef really was in the list
-			assert(pVal->NextRef && !pVal->HasBaseContainer);
-			pVal = pVal->NextRef;
+			assert(pVal->GetNextRef());
+			pVal = pVal->GetNextRef();
 		}
-		pVal->NextRef = pNextRef;
 		if (pBaseContainer)
-		{
-			pVal->HasBaseContainer = true;
-			pVal->BaseContainer = pBaseContainer;
-		}
+			pVal->SetBaseContainer(pBaseContainer);
+		else
+			pVal->SetNextRef(pNextRef);
 	}
 	// Was pRef the last ref to an array element?
 #ifdef C4ENGINE
-	if (pBaseContainer && !FirstRef)
+	if (pBaseContainer && !GetFirstRef())
 	{
 		pBaseContainer->DecElementRef();
 	}
 #endif
 }
 
+void C4Value::SetFirstRef(C4Value *pRef)
+{
+	if (!pRef && !LinkIndex) return;
+	GrabLinks().FirstRef = pRef;
+	CheckLinks();
+}
+
+void C4Value::SetNextRef(C4Value *pRef)
+{
+	if (!pRef && !LinkIndex) return;
+	C4ValueLinks &rLinks = GrabLinks();
+	rLinks.NextRef = pRef;
+	rLinks.HasBaseContainer = false;
+	CheckLinks();
+}
+
+void C4Value::SetBaseContainer(C4ValueContainer *pContainer)
+{
+	C4ValueLinks &rLinks = GrabLinks();
+	rLinks.BaseContainer = pContainer;
+	rLinks.HasBaseContainer = true;
+}
+
 C4V_Type C4Value::GuessType()
 {
 	// guaranteed by the caller
@@ -318,21 +383,15 @@ C4V_Type C4Value::GuessType()
 		return Type = C4V_C4ID;
 
 #ifdef C4ENGINE
-	// object?
-	if (Game.Objects.ObjectNumber(Data.Obj))
-	{
-		Type = C4V_C4Object;
-		// With the type now known, the destructor will clean up the reference
-		// which only works if the reference is added first
-		AddDataRef();
-		return Type;
-	}
+	// no object: values holding objects are always typed, and plain integers
+	// must not be taken for handles that happen to resolve
 
 	// string?
 	if (Game.ScriptEngine.Strings.FindString(Data.Str))
 	{
 		Type = C4V_String;
-		// see above
+		// With the type now known, the destructor will clean up the reference
+		// which only works if the reference is added first
 		AddDataRef();
 		return Type;
 	}
@@ -620,6 +679,7 @@ StdStrBuf C4Value::GetDataString() const
 		return GetRefVal().GetDataString() + "*";
 
 	// ouput by type info
+	CheckObject();
 	switch (GetType())
 	{
 	case C4V_Any:
@@ -633,16 +693,14 @@ StdStrBuf C4Value::GetDataString() const
 #ifdef C4ENGINE
 	case C4V_C4Object:
 	{
-		// obj exists?
-		if (!Game.Objects.ObjectNumber(Data.Obj) && !Game.Objects.InactiveObjects.ObjectNumber(Data.Obj))
-			return FormatString("%ld", Data.Int);
-		else if (Data.Obj)
-			if (Data.Obj->Status == C4OS_NORMAL)
-				return FormatString("%s #%d", Data.Obj->GetName(), (int)Data.Obj->Number);
-			else
-				return FormatString("{%s #%d}", Data.Obj->GetName(), (int)Data.Obj->Number);
+		// obj exists? (removed objects are nil already)
+		C4Object *pObj = _getObj();
+		if (!pObj)
+			return StdStrBuf("nil");
+		else if (pObj->Status == C4OS_NORMAL)
+			return FormatString("%s #%d", pObj->GetName(), (int)pObj->Number);
 		else
-			return StdStrBuf("0"); // (impossible)
+			return FormatString("{%s #%d}", pObj->GetName(), (int)pObj->Number);
 	}
 	case C4V_String:
 		return (Data.Str && Data.Str->Data.getData()) ? FormatString("\"%s\"", Data.Str->Data.getData()) : StdStrBuf("(nullstring)");
@@ -745,6 +803,7 @@ void C4Value::CompileFunc(StdCompiler *pComp)
 	if (!fCompiler)
 	{
 		// Get type
+		CheckObject();
 		if (Type == C4V_Any && Data) GuessType();
 		char cC4VID = GetC4VID(Type);
 		// Object reference is saved enumerated
@@ -849,6 +908,8 @@ void C4Value::CompileFunc(StdCompiler *pComp)
 
 bool C4Value::Equals(const C4Value &other, C4AulScriptStrict strict) const
 {
+	CheckObject();
+	other.CheckObject();
 	switch (strict)
 	{
 		case C4AulScriptStrict::NONSTRICT: case C4AulScriptStrict::STRICT1:
@@ -863,8 +924,9 @@ bool C4Value::Equals(const C4Value &other, C4AulScriptStrict strict) const
 					return true;
 				case C4V_Int:
 				case C4V_C4ID:
-				case C4V_C4Object:
 					return Data.Int == other.Data.Int;
+				case C4V_C4Object:
+					return Data.Obj == other.Data.Obj;
 				case C4V_Bool:
 					return _getBool() == other._getBool();
 				case C4V_String:
@@ -882,6 +944,8 @@ bool C4Value::Equals(const C4Value &other, C4AulScriptStrict strict) const
 
 bool C4Value::operator==(const C4Value &Value2) const
 {
+	CheckObject();
+	Value2.CheckObject();
 	switch (Type)
 	{
 	case C4V_Any:
@@ -931,7 +995,7 @@ bool C4Value::operator==(const C4Value &Value2) const
 			return false;
 		}
 	case C4V_C4Object:
-		return Data == Value2.Data && Type == Value2.Type;
+		return Type == Value2.Type && Data.Obj == Value2.Data.Obj;
 	case C4V_String:
 		return Type == Value2.Type && Data.Str->Data == Value2.Data.Str->Data;
 	case C4V_Array:
@@ -18,8 +18,11 @@
 
 #include "C4Id.h"
 #include "C4AulScriptStrict.h"
+#include "C4ObjectHandle.h"
 
+#include <cstring>
 #include <string>
+#include <vector>
 
 // class declarations
 class C4Value;
@@ -61,17 +64,19 @@ C4V_Type GetC4VFromID(char C4VID);
 union C4V_Data
 {
 	long Int;
-	C4Object *Obj;
+	C4ObjectHandle Obj;
 	C4String *Str;
 	C4Value *Ref;
 	C4ValueContainer *Container;
 	C4ValueArray *Array;
 	C4ValueHash *Map;
-	// cheat a little - assume that all members have the same length
+	// pointers are the largest member; object handles are stored with the rest zeroed,
+	// so testing and comparing the whole union works for all members
 	operator void *() { return Ref; }
 	operator const void *() const { return Ref; }
-	bool operator==(C4V_Data b) { return Ref == b.Ref; }
+	bool operator==(C4V_Data b) { return !std::memcmp(this, &b, sizeof(C4V_Data)); }
 	C4V_Data &operator=(C4Value *p) { Ref = p; return *this; }
+	C4V_Data &operator=(C4ObjectHandle h) { Ref = nullptr; Obj = h; return *this; }
 };
 // converter function, used in converter table
 struct C4VCnvFn
@@ -82,47 +87,100 @@ struct C4VCnvFn
 
 template <typename T> struct C4ValueConv;
 
+// reference bookkeeping of a value
+// Only few values are referenced, are references or live in a map, so this is kept
+// out of C4Value to keep the interpreter stack and value lists compact.
+struct C4ValueLinks
+{
+	union
+	{
+		C4Value *NextRef;
+		C4ValueContainer *BaseContainer;
+	};
+	C4Value *FirstRef;
+	C4ValueHash *OwningMap;
+	bool HasBaseContainer;
+	uint32_t NextFree;
+
+	bool isEmpty() const { return !NextRef && !FirstRef && !OwningMap; }
+};
+
+class C4ValueLinkTable
+{
+	std::vector<C4ValueLinks> Links;
+	uint32_t FirstFree = 0;
+	size_t iUsed = 0;
+
+public:
+	// record 0 stays empty, so values without links just use index 0
+	C4ValueLinkTable() : Links(1) {}
+
+	uint32_t Add()
+	{
+		++iUsed;
+		if (FirstFree)
+		{
+			const uint32_t iIndex = FirstFree;
+			FirstFree = Links[iIndex].NextFree;
+			Links[iIndex] = {};
+			return iIndex;
+		}
+		Links.emplace_back();
+		return static_cast<uint32_t>(Links.size() - 1);
+	}
+
+	void Remove(uint32_t iIndex)
+	{
+		--iUsed;
+		Links[iIndex].NextFree = FirstFree;
+		FirstFree = iIndex;
+	}
+
+	C4ValueLinks &operator[](uint32_t iIndex) { return Links[iIndex]; }
+
+	size_t GetUsedCount() const { return iUsed; }
+};
+
+extern C4ValueLinkTable ValueLinks;
+
 class C4Value
 {
 public:
-	C4Value() : Type(C4V_Any), NextRef(nullptr), FirstRef(nullptr) { Data.Ref = 0; }
+	C4Value() : Type(C4V_Any) { Data.Ref = 0; }
 
-	C4Value(const C4Value &nValue) : Data(nValue.Data), Type(nValue.Type), NextRef(nullptr), FirstRef(nullptr)
+	C4Value(const C4Value &nValue) : Data(nValue.Data), Type(nValue.Type)
 	{
 		AddDataRef();
 	}
 
-	C4Value(C4V_Data nData, C4V_Type nType) : Data(nData), Type(nData || nType == C4V_Int || nType == C4V_Bool ? nType : C4V_Any), NextRef(nullptr), FirstRef(nullptr)
+	C4Value(C4V_Data nData, C4V_Type nType) : Data(nData), Type(nData || nType == C4V_Int || nType == C4V_Bool ? nType : C4V_Any)
 	{
 		AddDataRef();
 	}
 
-	C4Value(int32_t nData, C4V_Type nType) : Type(nData || nType == C4V_Int || nType == C4V_Bool ? nType : C4V_Any), NextRef(nullptr), FirstRef(nullptr)
+	C4Value(int32_t nData, C4V_Type nType) : Type(nData || nType == C4V_Int || nType == C4V_Bool ? nType : C4V_Any)
 	{
 		Data.Int = nData; AddDataRef();
 	}
 
-	explicit C4Value(C4Object *pObj) : Type(pObj ? C4V_C4Object : C4V_Any), NextRef(nullptr), FirstRef(nullptr)
-	{
-		Data.Obj = pObj; AddDataRef();
-	}
+	explicit C4Value(C4Object *pObj);
 
-	explicit C4Value(C4String *pStr) : Type(pStr ? C4V_String : C4V_Any), NextRef(nullptr), FirstRef(nullptr)
+	explicit C4Value(C4String *pStr) : Type(pStr ? C4V_String : C4V_Any)
 	{
 		Data.Str = pStr; AddDataRef();
 	}
 
-	explicit C4Value(C4ValueArray *pArray) : Type(pArray ? C4V_Array : C4V_Any), NextRef(nullptr), FirstRef(nullptr)
+	explicit C4Value(C4ValueArray *pArray) : Type(pArray ? C4V_Array : C4V_Any)
 	{
 		Data.Array = pArray; AddDataRef();
 	}
 
-	explicit C4Value(C4ValueHash *pMap) : Type(pMap ? C4V_Map : C4V_Any), NextRef(nullptr), FirstRef(nullptr)
+	explicit C4Value(C4ValueHash *pMap) : Type(pMap ? C4V_Map : C4V_Any)
 	{
 		Data.Map = pMap; AddDataRef();
 	}
 
-	explicit C4Value(C4Value *pVal) : Type(pVal ? C4V_pC4Value : C4V_Any), NextRef(nullptr), FirstRef(nullptr)
+	explicit C4Value(C4Value *pVal) : Type(pVal ? C4V_pC4Value : C4V_Any)
 	{
 		Data.Ref = pVal; AddDataRef();
 	}
@@ -130,7 +188,7 @@ public:
 	static C4Value *OfMap(C4ValueHash *map)
 	{
 		auto ret = new C4Value;
-		ret->OwningMap = map;
+		ret->GrabLinks().OwningMap = map;
 		return ret;
 	}
 
@@ -146,7 +204,7 @@ public:
 	int32_t getIntOrID() { Deref(); if (Type == C4V_Int || Type == C4V_Bool || Type == C4V_C4ID) return Data.Int; else return 0; }
 	bool getBool()           { return ConvertTo(C4V_Bool)     ? !!Data     : 0; }
 	unsigned long getC4ID()  { return ConvertTo(C4V_C4ID)     ? Data.Int   : 0; }
-	C4Object *getObj()       { return ConvertTo(C4V_C4Object) ? Data.Obj   : nullptr; }
+	C4Object *getObj()       { return ConvertTo(C4V_C4Object) ? Data.Obj.Get() : nullptr; }
 	C4String *getStr()       { return ConvertTo(C4V_String)   ? Data.Str   : nullptr; }
 	C4ValueArray *getArray() { return ConvertTo(C4V_Array)    ? Data.Array : nullptr; }
 	C4ValueHash *getMap()    { return ConvertTo(C4V_Map)      ? Data.Map   : nullptr; }
@@ -156,12 +214,12 @@ public:
 	int32_t _getInt()         const { return Data.Int; }
 	bool _getBool()           const { return !!Data.Int; }
 	C4ID _getC4ID()           const { return Data.Int; }
-	C4Object *_getObj()       const { return Data.Obj; }
+	C4Object *_getObj()       const { return Data.Obj.Get(); }
 	C4String *_getStr()       const { return Data.Str; }
 	C4ValueArray *_getArray() const { return Data.Array; }
 	C4ValueHash *_getMap()    const { return Data.Map; }
 	C4Value *_getRef()              { return Data.Ref; }
-	long _getRaw()            const { return Data.Int; }
+	long _getRaw()            const { CheckObject(); return Data.Int; }
 
 	// Template versions
 	template <typename T> inline T Get() { return C4ValueConv<T>::FromC4V(*this); }
@@ -176,7 +234,7 @@ public:
 
 	void SetC4ID(C4ID id) { C4V_Data d; d.Int = id; Set(d, C4V_C4ID); }
 
-	void SetObject(C4Object *Obj) { C4V_Data d; d.Obj = Obj; Set(d, C4V_C4Object); }
+	void SetObject(C4Object *Obj);
 
 	void SetString(C4String *Str) { C4V_Data d; d.Str = Str; Set(d, C4V_String); }
 
@@ -232,6 +290,7 @@ public:
 
 	inline bool ConvertTo(C4V_Type vtToType, bool fStrict = true) // convert to dest type
 	{
+		CheckObject();
 		C4VCnvFn Fn = C4ScriptCnvMap[Type][vtToType];
 		if (Fn.Function)
 			return (*Fn.Function)(this, vtToType, fStrict);
@@ -244,25 +303,28 @@ public:
 	void CompileFunc(StdCompiler *pComp);
 
 protected:
-	// data
-	C4V_Data Data;
-
-	// reference-list
-	union
-	{
-		C4Value *NextRef;
-		C4ValueContainer *BaseContainer;
-	};
-	C4Value *FirstRef;
+	// data (mutable, because values of removed objects turn nil on access)
+	mutable C4V_Data Data;
 
-	C4ValueHash *OwningMap = nullptr;
+	// reference bookkeeping (index into ValueLinks; 0 = none)
+	uint32_t LinkIndex = 0;
 
 	// data type
-	C4V_Type Type : 8;
-	bool HasBaseContainer = false;
+	mutable C4V_Type Type : 8;
+
+	C4ValueLinks *GetLinks() const { return LinkIndex ? &ValueLinks[LinkIndex] : nullptr; }
+	// the returned record is only valid until the next record is allocated
+	C4ValueLinks &GrabLinks() { if (!LinkIndex) LinkIndex = ValueLinks.Add(); return ValueLinks[LinkIndex]; }
+	void CheckLinks() { if (LinkIndex && ValueLinks[LinkIndex].isEmpty()) { ValueLinks.Remove(LinkIndex); LinkIndex = 0; } }
 
-	C4Value *GetNextRef() { if (HasBaseContainer) return 0; else return NextRef; }
-	C4ValueContainer *GetBaseContainer() { if (HasBaseContainer) return BaseContainer; else return nullptr; }
+	C4Value *GetFirstRef() const { return LinkIndex ? ValueLinks[LinkIndex].FirstRef : nullptr; }
+	C4Value *GetNextRef() const { C4ValueLinks *pLinks = GetLinks(); return pLinks && !pLinks->HasBaseContainer ? pLinks->NextRef : nullptr; }
+	C4ValueContainer *GetBaseContainer() const { C4ValueLinks *pLinks = GetLinks(); return pLinks && pLinks->HasBaseContainer ? pLinks->BaseContainer : nullptr; }
+	C4ValueHash *GetOwningMap() const { return LinkIndex ? ValueLinks[LinkIndex].OwningMap : nullptr; }
+
+	void SetFirstRef(C4Value *pRef);
+	void SetNextRef(C4Value *pRef);
+	void SetBaseContainer(C4ValueContainer *pContainer);
 
 	void Set(long nData, C4V_Type nType = C4V_Any) { C4V_Data d; d.Int = nData; Set(d, nType); }
 	void Set(C4V_Data nData, C4V_Type nType);
@@ -275,6 +337,10 @@ protected:
 
 	void CheckRemoveFromMap();
 
+	// object values resolve lazily: once the object has been removed, the value is nil
+	// (values owned by maps are cleared by the object right away, so they're removed from the map)
+	void CheckObject() const { if (Type == C4V_C4Object && !Data.Obj.Get()) { Data = C4ObjectHandle{}; Type = C4V_Any; } }
+
 	// guess type from data (if type == c4v_any)
 	C4V_Type GuessType();
 
@@ -1055,7 +1055,7 @@ void C4Viewport::Draw(C4FacetEx &cgo, bool fDrawOverlay)
 
 	// draw objects
 	C4ST_STARTNEW(ObjStat, "C4Viewport::Draw: Objects")
-	Game.Objects.Draw(cgo, Player);
+	DrawnObjects = Game.Objects.DrawCulled(cgo, Player, CulledObjects);
 	C4ST_STOP(ObjStat)
 
 	// draw global particles
@@ -1265,6 +1265,7 @@ void C4Viewport::Default()
 	Next = nullptr;
 	PlayerLock = true;
 	ResetMenuPositions = false;
+	DrawnObjects = CulledObjects = 0;
 	SetRegions = nullptr;
 	Regions.Default();
 	dViewX = dViewY = -31337;
@@ -99,12 +99,15 @@ public:
 	C4Viewport *GetNext() { return Next; }
 	int32_t GetPlayer() { return Player; }
 	void CenterPosition();
+	int32_t GetDrawnObjectCount() { return DrawnObjects; } // objects drawn in the last frame
+	int32_t GetCulledObjectCount() { return CulledObjects; } // objects skipped by sector culling in the last frame
 
 protected:
 	int32_t Player;
 	bool PlayerLock;
 	int32_t OutX, OutY;
 	bool ResetMenuPositions;
+	int32_t DrawnObjects, CulledObjects;
 	C4RegionList *SetRegions;
 	C4Viewport *Next;
 	CStdGLCtx *pCtx; // rendering context for OpenGL
@@ -22,6 +22,7 @@
 #include <C4Console.h>
 #include <C4FullScreen.h>
 #include <C4Log.h>
+#include <C4Object.h>
 
 #ifdef WITH_DEVELOPER_MODE
 #include <gtk/gtkmain.h>
@@ -31,6 +32,11 @@
 #include <objbase.h>
 #endif
 
+// before the game, so they outlive all objects and values
+C4ObjectPool ObjectPool(sizeof(C4Object), 64);
+C4ObjectPool ObjectLinkPool(sizeof(C4ObjectLink), 1024);
+C4ObjectSlots ObjectSlots;
+C4ValueLinkTable ValueLinks;
 C4Application Application;
 C4Console Console;
 C4FullScreen FullScreen;
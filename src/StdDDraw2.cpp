@@ -35,6 +35,9 @@ CStdDDraw *lpDDraw = nullptr;
 CStdPalette *lpDDrawPal = nullptr;
 int iGfxEngine = -1;
 
+// flush batches beyond this size, so they don't grow unbounded between scene ends
+const size_t C4GFX_MaxBatchVertices = 0x10000;
+
 void CBltTransform::SetRotate(int iAngle, float fOffX, float fOffY) // set by angle and rotation offset
 {
 	// iAngle is in 1/100-degrees (cycling from 0 to 36000)
@@ -85,6 +88,16 @@ void CBltTransform::TransformPoint(float &rX, float &rY)
 	rX = fX; // apply temp
 }
 
+CBltBatchVertex *CBltBatch::Add(const CBltBatchState &rState, size_t iCount)
+{
+	// continue the last command if the state didn't change
+	if (Commands.empty() || !(Commands.back().State == rState))
+		Commands.push_back({rState, Vertices.size(), 0});
+	Commands.back().iVertexCount += iCount;
+	Vertices.resize(Vertices.size() + iCount);
+	return &Vertices[Vertices.size() - iCount];
+}
+
 CPattern &CPattern::operator=(const CPattern &nPattern)
 {
 	pClrs        = nPattern.pClrs;
@@ -519,6 +532,7 @@ void CStdDDraw::Default()
 	DefRamp.Default();
 	lpPrimary = lpBack = nullptr;
 	fUseClrModMap = false;
+	Batch.Clear();
 }
 
 void CStdDDraw::Clear()
@@ -527,6 +541,7 @@ void CStdDDraw::Clear()
 	DisableGamma();
 	Active = BlitModulated = fUseClrModMap = false;
 	dwBlitMode = 0;
+	Batch.Clear();
 }
 
 bool CStdDDraw::WipeSurface(CSurface *sfcSurface)
@@ -708,8 +723,6 @@ bool CStdDDraw::Blit(CSurface *sfcSource, float fx, float fy, float fwdt, float
 	float scaleX2 = scaleX * (iTexSize + DDrawCfg.fTexIndent * 2);
 	float scaleY2 = scaleY * (iTexSize + DDrawCfg.fTexIndent * 2);
 	// blit from all these textures
-	SetTexture();
-
 	int chunkSize = iTexSize;
 	if (fUseClrModMap)
 	{
@@ -792,12 +805,70 @@ bool CStdDDraw::Blit(CSurface *sfcSource, float fx, float fy, float fwdt, float
 			}
 		}
 	}
-	// reset texture
-	ResetTexture();
 	// success
 	return true;
 }
 
+void CStdDDraw::PerformBlt(CBltData &rBltData, CTexRef *pTex, uint32_t dwModClr, bool fMod2, bool fExact)
+{
+	// changes of this frame not uploaded yet?
+	pTex->UploadPending();
+	// global modulation map
+	bool fAnyModNotBlack = !!dwModClr, fModClr = (dwModClr != 0xffffff), fAlphaAdd = !!(dwModClr >> 24);
+	if (fUseClrModMap && dwModClr)
+	{
+		fAnyModNotBlack = fModClr = false;
+		for (int i = 0; i < rBltData.byNumVertices; ++i)
+		{
+			float x = rBltData.vtVtx[i].ftx, y = rBltData.vtVtx[i].fty;
+			if (rBltData.pTransform) rBltData.pTransform->TransformPoint(x, y);
+			uint32_t &rdwClr = rBltData.vtVtx[i].dwModClr;
+			rdwClr = pClrModMap->GetModAt(static_cast<int>(x), static_cast<int>(y));
+			if (rdwClr >> 24) fAlphaAdd = true;
+			ModulateClr(rdwClr, dwModClr);
+			if (rdwClr) fAnyModNotBlack = true;
+			if (rdwClr != 0xffffff) fModClr = true;
+		}
+	}
+	else
+		for (int i = 0; i < rBltData.byNumVertices; ++i)
+			rBltData.vtVtx[i].dwModClr = dwModClr;
+	// reset MOD2 for completely black modulations
+	if (fMod2 && !fAnyModNotBlack) fMod2 = false;
+	// compose state
+	CBltBatchState State = { pTex, BBP_Triangles, 0, Saturation };
+	if (dwBlitMode & C4GFXBLIT_ADDITIVE) State.dwFlags |= CBltBatchState::Additive;
+	if (fMod2) State.dwFlags |= CBltBatchState::Mod2;
+	if (fModClr) State.dwFlags |= CBltBatchState::ModClr;
+	if (fAlphaAdd) State.dwFlags |= CBltBatchState::AlphaAdd;
+	if (fUseClrModMap && fModClr && !DDrawCfg.NoBoxFades) State.dwFlags |= CBltBatchState::Smooth;
+	if (!fExact && !DDrawCfg.PointFiltering) State.dwFlags |= CBltBatchState::Linear;
+	// transform polygon; texture positions are mapped from untransformed positions
+	CBltBatchVertex vtPoly[8];
+	const float *const pTexMat = rBltData.TexPos.mat;
+	for (int i = 0; i < rBltData.byNumVertices; ++i)
+	{
+		const CBltVertex &rVtx = rBltData.vtVtx[i];
+		CBltBatchVertex &rPoly = vtPoly[i];
+		const float fQ = pTexMat[6] * rVtx.ftx + pTexMat[7] * rVtx.fty + pTexMat[8];
+		rPoly.ftu = (pTexMat[0] * rVtx.ftx + pTexMat[1] * rVtx.fty + pTexMat[2]) / fQ;
+		rPoly.ftv = (pTexMat[3] * rVtx.ftx + pTexMat[4] * rVtx.fty + pTexMat[5]) / fQ;
+		rPoly.ftx = rVtx.ftx; rPoly.fty = rVtx.fty;
+		if (rBltData.pTransform) rBltData.pTransform->TransformPoint(rPoly.ftx, rPoly.fty);
+		// unmodulated: white without alpha, as expected by the saturation shaders
+		rPoly.dwClr = fModClr ? rVtx.dwModClr : 0x00ffffff;
+	}
+	// add as triangle fan
+	if (rBltData.byNumVertices < 3) return;
+	CBltBatchVertex *pVtx = AddToBatch(State, (rBltData.byNumVertices - 2) * 3);
+	for (int i = 1; i + 1 < rBltData.byNumVertices; ++i)
+	{
+		*pVtx++ = vtPoly[0];
+		*pVtx++ = vtPoly[i];
+		*pVtx++ = vtPoly[i + 1];
+	}
+}
+
 bool CStdDDraw::Blit8(CSurface *sfcSource, int fx, int fy, int fwdt, int fhgt,
 	CSurface *sfcTarget, int tx, int ty, int twdt, int thgt,
 	bool fSrcColKey, CBltTransform *pTransform)
@@ -1112,6 +1183,117 @@ void CStdDDraw::DrawPix(CSurface *sfcDest, float tx, float ty, uint32_t dwClr)
 	DrawPixInt(sfcDest, tx, ty, dwClr);
 }
 
+void CStdDDraw::DrawPixInt(CSurface *sfcDest, float tx, float ty, uint32_t dwClr)
+{
+	if (!PrepareRendering(sfcDest)) return;
+	const CBltBatchState State = { nullptr, BBP_Points, (dwBlitMode & C4GFXBLIT_ADDITIVE) ? uint32_t{CBltBatchState::Additive} : 0u, 255 };
+	// points and lines are blended by inverted alpha
+	*AddToBatch(State, 1) = { tx + 0.5f, ty + 0.5f, 0.0f, 0.0f, InvertRGBAAlpha(dwClr) };
+}
+
+void CStdDDraw::DrawLineDw(CSurface *sfcTarget, float x1, float y1, float x2, float y2, uint32_t dwClr)
+{
+	// apply color modulation
+	ClrByCurrentBlitMod(dwClr);
+	// prepare rendering to target
+	if (!PrepareRendering(sfcTarget)) return;
+	// global clr modulation map
+	uint32_t dwClr1 = dwClr;
+	if (fUseClrModMap)
+	{
+		ModulateClr(dwClr1, pClrModMap->GetModAt(static_cast<int>(x1), static_cast<int>(y1)));
+		ModulateClr(dwClr, pClrModMap->GetModAt(static_cast<int>(x2), static_cast<int>(y2)));
+	}
+	const CBltBatchState State = { nullptr, BBP_Lines, (dwBlitMode & C4GFXBLIT_ADDITIVE) ? uint32_t{CBltBatchState::Additive} : 0u, 255 };
+	CBltBatchVertex *pVtx = AddToBatch(State, 2);
+	pVtx[0] = { x1 + 0.5f, y1 + 0.5f, 0.0f, 0.0f, InvertRGBAAlpha(dwClr1) };
+	pVtx[1] = { x2 + 0.5f, y2 + 0.5f, 0.0f, 0.0f, InvertRGBAAlpha(dwClr) };
+}
+
+void CStdDDraw::DrawQuadDw(CSurface *sfcTarget, int *ipVtx, uint32_t dwClr1, uint32_t dwClr2, uint32_t dwClr3, uint32_t dwClr4)
+{
+	// prepare rendering to target
+	if (!PrepareRendering(sfcTarget)) return;
+	// apply global modulation
+	ClrByCurrentBlitMod(dwClr1);
+	ClrByCurrentBlitMod(dwClr2);
+	ClrByCurrentBlitMod(dwClr3);
+	ClrByCurrentBlitMod(dwClr4);
+	// apply modulation map
+	if (fUseClrModMap)
+	{
+		ModulateClr(dwClr1, pClrModMap->GetModAt(ipVtx[0], ipVtx[1]));
+		ModulateClr(dwClr2, pClrModMap->GetModAt(ipVtx[2], ipVtx[3]));
+		ModulateClr(dwClr3, pClrModMap->GetModAt(ipVtx[4], ipVtx[5]));
+		ModulateClr(dwClr4, pClrModMap->GetModAt(ipVtx[6], ipVtx[7]));
+	}
+	CBltBatchState State = { nullptr, BBP_Triangles, 0, 255 };
+	if (dwBlitMode & C4GFXBLIT_ADDITIVE) State.dwFlags |= CBltBatchState::Additive;
+	// no clr fading supported
+	if (DDrawCfg.NoBoxFades)
+		NormalizeColors(dwClr1, dwClr2, dwClr3, dwClr4);
+	else if (dwClr1 != dwClr2 || dwClr1 != dwClr3 || dwClr1 != dwClr4)
+		State.dwFlags |= CBltBatchState::Smooth;
+	// draw two triangles
+	const float fOff = DDrawCfg.fBlitOff;
+	const CBltBatchVertex vtQuad[4] =
+	{
+		{ ipVtx[0] + fOff, ipVtx[1] + fOff, 0.0f, 0.0f, dwClr1 },
+		{ ipVtx[2] + fOff, ipVtx[3] + fOff, 0.0f, 0.0f, dwClr2 },
+		{ ipVtx[4] + fOff, ipVtx[5] + fOff, 0.0f, 0.0f, dwClr3 },
+		{ ipVtx[6] + fOff, ipVtx[7] + fOff, 0.0f, 0.0f, dwClr4 }
+	};
+	CBltBatchVertex *pVtx = AddToBatch(State, 6);
+	pVtx[0] = vtQuad[0]; pVtx[1] = vtQuad[1]; pVtx[2] = vtQuad[2];
+	pVtx[3] = vtQuad[0]; pVtx[4] = vtQuad[2]; pVtx[5] = vtQuad[3];
+}
+
+void CStdDDraw::DrawPixelsDw(CSurface *sfcDest, const CBltVertex *pVertices, size_t iCount)
+{
+	if (!iCount || !PrepareRendering(sfcDest)) return;
+	const CBltBatchState State = { nullptr, BBP_Points, (dwBlitMode & C4GFXBLIT_ADDITIVE) ? uint32_t{CBltBatchState::Additive} : 0u, 255 };
+	CBltBatchVertex *pVtx = AddToBatch(State, iCount);
+	for (size_t i = 0; i < iCount; ++i)
+	{
+		const CBltVertex &rVtx = pVertices[i];
+		uint32_t dwClr = rVtx.dwModClr;
+		ClrByCurrentBlitMod(dwClr);
+		if (fUseClrModMap) ModulateClr(dwClr, pClrModMap->GetModAt(static_cast<int>(rVtx.ftx), static_cast<int>(rVtx.fty)));
+		pVtx[i] = { rVtx.ftx + 0.5f, rVtx.fty + 0.5f, 0.0f, 0.0f, InvertRGBAAlpha(dwClr) };
+	}
+}
+
+void CStdDDraw::DrawLinesDw(CSurface *sfcTarget, const CBltVertex *pVertices, size_t iCount)
+{
+	iCount &= ~size_t(1);
+	if (!iCount || !PrepareRendering(sfcTarget)) return;
+	const CBltBatchState State = { nullptr, BBP_Lines, (dwBlitMode & C4GFXBLIT_ADDITIVE) ? uint32_t{CBltBatchState::Additive} : 0u, 255 };
+	CBltBatchVertex *pVtx = AddToBatch(State, iCount);
+	for (size_t i = 0; i < iCount; ++i)
+	{
+		const CBltVertex &rVtx = pVertices[i];
+		uint32_t dwClr = rVtx.dwModClr;
+		ClrByCurrentBlitMod(dwClr);
+		if (fUseClrModMap) ModulateClr(dwClr, pClrModMap->GetModAt(static_cast<int>(rVtx.ftx), static_cast<int>(rVtx.fty)));
+		pVtx[i] = { rVtx.ftx + 0.5f, rVtx.fty + 0.5f, 0.0f, 0.0f, InvertRGBAAlpha(dwClr) };
+	}
+}
+
+CBltBatchVertex *CStdDDraw::AddToBatch(const CBltBatchState &rState, size_t iCount)
+{
+	if (Batch.GetVertexCount() + iCount > C4GFX_MaxBatchVertices) FlushBatch();
+	return Batch.Add(rState, iCount);
+}
+
+void CStdDDraw::FlushBatch()
+{
+	if (Batch.IsEmpty()) return;
+	CBltBatchVertex *pVertices = Batch.GetVertices();
+	for (const CBltBatchCommand &rCommand : Batch.GetCommands())
+		PerformBatch(rCommand, pVertices + rCommand.iFirstVertex);
+	Batch.Clear();
+}
+
 void CStdDDraw::DrawBox(CSurface *sfcDest, int iX1, int iY1, int iX2, int iY2, uint8_t byCol)
 {
 	// get color
@@ -24,6 +24,8 @@
 #include <StdFont.h>
 #include <StdBuf.h>
 
+#include <vector>
+
 // texref-predef
 class CStdDDraw;
 class CTexRef;
@@ -156,6 +158,63 @@ struct CBltData
 	bool ClipBy(float fX, float fY, float fMax);
 };
 
+// batched vertex: target position, texture position and color
+struct CBltBatchVertex
+{
+	float ftx, fty; // target position
+	float ftu, ftv; // texture position; unused for untextured primitives
+	uint32_t dwClr; // color
+};
+
+enum CBltBatchPrimitive { BBP_Points = 0, BBP_Lines, BBP_Triangles };
+
+// render state shared by all vertices of a batch command
+struct CBltBatchState
+{
+	enum
+	{
+		Additive = 1, // additive blending
+		Mod2 = 2, // mod2-modulation of textures
+		ModClr = 4, // modulate textures by vertex colors
+		AlphaAdd = 8, // modulation changes texture alpha
+		Smooth = 16, // interpolate vertex colors
+		Linear = 32, // linear texture filtering
+	};
+
+	CTexRef *pTex; // nullptr for untextured primitives
+	CBltBatchPrimitive ePrimitive;
+	uint32_t dwFlags;
+	unsigned char Saturation; // textured primitives only
+
+	bool operator==(const CBltBatchState &rState) const
+	{
+		return pTex == rState.pTex && ePrimitive == rState.ePrimitive && dwFlags == rState.dwFlags && Saturation == rState.Saturation;
+	}
+};
+
+// a range of batched vertices drawn with the same state
+struct CBltBatchCommand
+{
+	CBltBatchState State;
+	size_t iFirstVertex, iVertexCount;
+};
+
+// primitives not yet sent to the device; consecutive primitives of the same state share one command
+class CBltBatch
+{
+private:
+	std::vector<CBltBatchVertex> Vertices;
+	std::vector<CBltBatchCommand> Commands;
+
+public:
+	CBltBatchVertex *Add(const CBltBatchState &rState, size_t iCount); // get room for vertices; valid until the next Add
+	void Clear() { Vertices.clear(); Commands.clear(); }
+	bool IsEmpty() const { return Commands.empty(); }
+	size_t GetVertexCount() const { return Vertices.size(); }
+	const std::vector<CBltBatchCommand> &GetCommands() const { return Commands; }
+	CBltBatchVertex *GetVertices() { return Vertices.data(); }
+};
+
 // gamma ramp control
 class CGammaControl
 {
@@ -210,6 +269,7 @@ protected:
 	CClrModAddMap *pClrModMap; // map to be used for global color modulation (invalid if !fUseClrModMap)
 	bool fUseClrModMap; // if set, pClrModMap will be checked for color modulations
 	unsigned char Saturation; // if < 255, an extra filter is used to reduce the saturation
+	CBltBatch Batch; // primitives waiting for FlushBatch
 
 public:
 	// General
@@ -256,7 +316,7 @@ public:
 	bool Blit(CSurface *sfcSource, float fx, float fy, float fwdt, float fhgt,
 		CSurface *sfcTarget, float tx, float ty, float twdt, float thgt,
 		bool fSrcColKey = false, CBltTransform *pTransform = nullptr, bool noScalingCorrection = false);
-	virtual void PerformBlt(CBltData &rBltData, CTexRef *pTex, uint32_t dwModClr, bool fMod2, bool fExact) = 0;
+	void PerformBlt(CBltData &rBltData, CTexRef *pTex, uint32_t dwModClr, bool fMod2, bool fExact); // add to batch
 	bool Blit8(CSurface *sfcSource, int fx, int fy, int fwdt, int fhgt, // force 8bit-blit (inline)
 		CSurface *sfcTarget, int tx, int ty, int twdt, int thgt,
 		bool fSrcColKey = false, CBltTransform *pTransform = nullptr);
@@ -289,8 +349,13 @@ public:
 		DrawLineDw(sfcTarget, (float)x1, (float)y1, (float)x2, (float)y2, Pal.GetClr(byCol));
 	}
 
-	virtual void DrawLineDw(CSurface *sfcTarget, float x1, float y1, float x2, float y2, uint32_t dwClr) = 0;
-	virtual void DrawQuadDw(CSurface *sfcTarget, int *ipVtx, uint32_t dwClr1, uint32_t dwClr2, uint32_t dwClr3, uint32_t dwClr4) = 0;
+	void DrawLineDw(CSurface *sfcTarget, float x1, float y1, float x2, float y2, uint32_t dwClr);
+	void DrawQuadDw(CSurface *sfcTarget, int *ipVtx, uint32_t dwClr1, uint32_t dwClr2, uint32_t dwClr3, uint32_t dwClr4);
+	void DrawPixelsDw(CSurface *sfcDest, const CBltVertex *pVertices, size_t iCount); // many pixels at once; dwModClr is the pixel color
+	void DrawLinesDw(CSurface *sfcTarget, const CBltVertex *pVertices, size_t iCount); // lines between vertex pairs; dwModClr is the line color
+
+	// batching
+	void FlushBatch(); // send all batched primitives to the device; needed before anything that changes device state
 
 	// gamma
 	void SetGamma(uint32_t dwClr1, uint32_t dwClr2, uint32_t dwClr3); // set gamma ramp
@@ -326,7 +391,9 @@ public:
 
 protected:
 	bool StringOut(const char *szText, CSurface *sfcDest, int iTx, int iTy, uint32_t dwFCol, uint8_t byForm, bool fDoMarkup, CMarkup &Markup, CStdFont *pFont, float fZoom);
-	virtual void DrawPixInt(CSurface *sfcDest, float tx, float ty, uint32_t dwCol) = 0; // without ClrModMap
+	void DrawPixInt(CSurface *sfcDest, float tx, float ty, uint32_t dwCol); // without ClrModMap
+	CBltBatchVertex *AddToBatch(const CBltBatchState &rState, size_t iCount); // flushes if the batch is full
+	virtual void PerformBatch(const CBltBatchCommand &rCommand, CBltBatchVertex *pVertices) = 0; // draw one batch command; vertices may be modified
 	bool CreatePrimaryClipper();
 	virtual bool CreatePrimarySurfaces() = 0;
 	bool Error(const char *szMsg);
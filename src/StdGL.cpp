@@ -90,6 +90,7 @@ bool CStdGL::PageFlip(RECT *, RECT *, CStdWindow *)
 void CStdGL::FillBG(const uint32_t dwClr)
 {
 	if (!pCurrCtx && !MainCtx.Select()) return;
+	FlushBatch();
 	glClearColor(
 		GetBValue(dwClr) / 255.0f,
 		GetGValue(dwClr) / 255.0f,
@@ -103,6 +104,9 @@ bool CStdGL::UpdateClipper()
 	int iX, iY, iWdt, iHgt;
 	// no render target or clip all? do nothing
 	if (!CalculateClipper(&iX, &iY, &iWdt, &iHgt)) return true;
+	// batched primitives were clipped by the old viewport
+	if (iX != ClipRect.x || iY != ClipRect.y || iWdt != ClipRect.Wdt || iHgt != ClipRect.Hgt) FlushBatch();
+	ClipRect = { iX, iY, iWdt, iHgt };
 	const auto scale = pApp->GetScale();
 	glLineWidth(scale);
 	glPointSize(scale);
@@ -134,6 +138,7 @@ bool CStdGL::PrepareRendering(CSurface *const sfcToSurface)
 		// target is a render-target?
 		if (!sfcToSurface->IsRenderTarget()) return false;
 		// set target
+		FlushBatch();
 		RenderTarget = sfcToSurface;
 		// new target has different size; needs other clipping rect
 		UpdateClipper();
@@ -142,161 +147,143 @@ bool CStdGL::PrepareRendering(CSurface *const sfcToSurface)
 	return true;
 }
 
-void CStdGL::PerformBlt(CBltData &rBltData, CTexRef *const pTex,
-	const uint32_t dwModClr, bool fMod2, const bool fExact)
+void CStdGL::PerformBatch(const CBltBatchCommand &rCommand, CBltBatchVertex *const pVertices)
 {
-	// global modulation map
+	const CBltBatchState &rState = rCommand.State;
+	const bool fAdditive = !!(rState.dwFlags & CBltBatchState::Additive);
+	const bool fModClr = !!(rState.dwFlags & CBltBatchState::ModClr);
+	const bool fMod2 = !!(rState.dwFlags & CBltBatchState::Mod2);
+	const bool fLinear = rState.pTex && (pApp->GetScale() != 1.f || (rState.dwFlags & CBltBatchState::Linear));
 	uint32_t dwModMask = 0;
-	bool fAnyModNotBlack;
-	bool fModClr = false;
-	if (fUseClrModMap && dwModClr)
+	if (rState.pTex)
 	{
-		fAnyModNotBlack = false;
-		for (int i = 0; i < rBltData.byNumVertices; ++i)
+		glEnable(GL_TEXTURE_2D);
+		glBlendFunc(GL_ONE_MINUS_SRC_ALPHA, fAdditive ? GL_ONE : GL_SRC_ALPHA);
+		if (shader)
 		{
-			float x = rBltData.vtVtx[i].ftx;
-			float y = rBltData.vtVtx[i].fty;
-			if (rBltData.pTransform)
+			glEnable(GL_FRAGMENT_SHADER_ATI);
+			if (rState.Saturation < 255)
+			{
+				glBindFragmentShaderATI(fMod2 ? shader + 3 : shader + 2);
+				const GLfloat value[4] =
+					{ rState.Saturation / 255.0f, rState.Saturation / 255.0f, rState.Saturation / 255.0f, 1.0f };
+				glSetFragmentShaderConstantATI(GL_CON_1_ATI, value);
+			}
+			else
 			{
-				rBltData.pTransform->TransformPoint(x, y);
+				glBindFragmentShaderATI(fMod2 ? shader + 1 : shader);
 			}
-			rBltData.vtVtx[i].dwModClr = pClrModMap->GetModAt(static_cast<int>(x), static_cast<int>(y));
-			if (rBltData.vtVtx[i].dwModClr >> 24) dwModMask = 0xff000000;
-			ModulateClr(rBltData.vtVtx[i].dwModClr, dwModClr);
-			if (rBltData.vtVtx[i].dwModClr) fAnyModNotBlack = true;
-			if (rBltData.vtVtx[i].dwModClr != 0xffffff) fModClr = true;
 		}
-	}
-	else
-	{
-		fAnyModNotBlack = !!dwModClr;
-		for (int i = 0; i < rBltData.byNumVertices; ++i)
-			rBltData.vtVtx[i].dwModClr = dwModClr;
-		if (dwModClr != 0xffffff) fModClr = true;
-	}
-	// reset MOD2 for completely black modulations
-	if (fMod2 && !fAnyModNotBlack) fMod2 = 0;
-	if (shader)
-	{
-		glEnable(GL_FRAGMENT_SHADER_ATI);
-		if (!fModClr) glColor4f(1.0f, 1.0f, 1.0f, 0.0f);
-		dwModMask = 0;
-		if (Saturation < 255)
+		else if (shaders[0])
 		{
-			glBindFragmentShaderATI(fMod2 ? shader + 3 : shader + 2);
-			const GLfloat value[4] =
-				{ Saturation / 255.0f, Saturation / 255.0f, Saturation / 255.0f, 1.0f };
-			glSetFragmentShaderConstantATI(GL_CON_1_ATI, value);
+			glEnable(GL_FRAGMENT_PROGRAM_ARB);
+			if (rState.Saturation < 255)
+			{
+				glBindProgramARB(GL_FRAGMENT_PROGRAM_ARB, shaders[fMod2 ? 3 : 2]);
+				const GLfloat value[4] =
+					{ rState.Saturation / 255.0f, rState.Saturation / 255.0f, rState.Saturation / 255.0f, 1.0f };
+				glProgramLocalParameter4fvARB(GL_FRAGMENT_PROGRAM_ARB, 0, value);
+			}
+			else
+			{
+				glBindProgramARB(GL_FRAGMENT_PROGRAM_ARB, shaders[fMod2 ? 1 : 0]);
+			}
 		}
-		else
+		// modulated blit
+		else if (fModClr)
 		{
-			glBindFragmentShaderATI(fMod2 ? shader + 1 : shader);
+			if (fMod2 || ((rState.dwFlags & CBltBatchState::AlphaAdd) && !DDrawCfg.NoAlphaAdd))
+			{
+				glTexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_COMBINE);
+				glTexEnvi(GL_TEXTURE_ENV, GL_COMBINE_RGB,      fMod2 ? GL_ADD_SIGNED : GL_MODULATE);
+				glTexEnvf(GL_TEXTURE_ENV, GL_RGB_SCALE,        fMod2 ? 2.0f : 1.0f);
+				glTexEnvi(GL_TEXTURE_ENV, GL_COMBINE_ALPHA,    GL_ADD);
+				glTexEnvi(GL_TEXTURE_ENV, GL_SOURCE0_RGB,      GL_TEXTURE);
+				glTexEnvi(GL_TEXTURE_ENV, GL_SOURCE1_RGB,      GL_PRIMARY_COLOR);
+				glTexEnvi(GL_TEXTURE_ENV, GL_SOURCE0_ALPHA,    GL_TEXTURE);
+				glTexEnvi(GL_TEXTURE_ENV, GL_SOURCE1_ALPHA,    GL_PRIMARY_COLOR);
+				glTexEnvi(GL_TEXTURE_ENV, GL_OPERAND0_RGB,     GL_SRC_COLOR);
+				glTexEnvi(GL_TEXTURE_ENV, GL_OPERAND1_RGB,     GL_SRC_COLOR);
+				glTexEnvi(GL_TEXTURE_ENV, GL_OPERAND0_ALPHA,   GL_SRC_ALPHA);
+				glTexEnvi(GL_TEXTURE_ENV, GL_OPERAND1_ALPHA,   GL_SRC_ALPHA);
+			}
+			else
+			{
+				glTexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_MODULATE);
+				glTexEnvf(GL_TEXTURE_ENV, GL_RGB_SCALE,        1.0f);
+				dwModMask = 0xff000000;
+			}
 		}
-	}
-	else if (shaders[0])
-	{
-		glEnable(GL_FRAGMENT_PROGRAM_ARB);
-		if (!fModClr) glColor4f(1.0f, 1.0f, 1.0f, 0.0f);
-		dwModMask = 0;
-		if (Saturation < 255)
+		else
 		{
-			glBindProgramARB(GL_FRAGMENT_PROGRAM_ARB, shaders[fMod2 ? 3 : 2]);
-			const GLfloat value[4] =
-				{ Saturation / 255.0f, Saturation / 255.0f, Saturation / 255.0f, 1.0f };
-			glProgramLocalParameter4fvARB(GL_FRAGMENT_PROGRAM_ARB, 0, value);
+			glTexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_REPLACE);
+			glTexEnvf(GL_TEXTURE_ENV, GL_RGB_SCALE, 1.0f);
 		}
-		else
+		glBindTexture(GL_TEXTURE_2D, rState.pTex->texName);
+		if (fLinear)
 		{
-			glBindProgramARB(GL_FRAGMENT_PROGRAM_ARB, shaders[fMod2 ? 1 : 0]);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
 		}
+		// texture positions are precalculated
+		glMatrixMode(GL_TEXTURE);
+		glLoadIdentity();
+		glMatrixMode(GL_MODELVIEW);
 	}
-	// modulated blit
-	else if (fModClr)
+	else
 	{
-		if (fMod2 || ((dwModClr >> 24 || dwModMask) && !DDrawCfg.NoAlphaAdd))
+		glDisable(GL_TEXTURE_2D);
+		// use a different blendfunc for points and lines, because GL_POINT_SMOOTH and GL_LINE_SMOOTH expect this one
+		if (rState.ePrimitive == BBP_Triangles)
+			glBlendFunc(GL_ONE_MINUS_SRC_ALPHA, fAdditive ? GL_ONE : GL_SRC_ALPHA);
+		else
+			glBlendFunc(GL_SRC_ALPHA, fAdditive ? GL_ONE : GL_ONE_MINUS_SRC_ALPHA);
+	}
+	glShadeModel((rState.dwFlags & CBltBatchState::Smooth) ? GL_SMOOTH : GL_FLAT);
+	// convert colors to RGBA byte order in place
+	for (size_t i = 0; i < rCommand.iVertexCount; ++i)
+	{
+		const uint32_t dwClr = pVertices[i].dwClr | dwModMask;
+		GLubyte *const pClr = reinterpret_cast<GLubyte *>(&pVertices[i].dwClr);
+		pClr[0] = static_cast<GLubyte>(dwClr >> 16);
+		pClr[1] = static_cast<GLubyte>(dwClr >> 8);
+		pClr[2] = static_cast<GLubyte>(dwClr);
+		pClr[3] = static_cast<GLubyte>(dwClr >> 24);
+	}
+	// draw all vertices at once
+	glEnableClientState(GL_VERTEX_ARRAY);
+	glEnableClientState(GL_COLOR_ARRAY);
+	glVertexPointer(2, GL_FLOAT, sizeof(CBltBatchVertex), &pVertices->ftx);
+	glColorPointer(4, GL_UNSIGNED_BYTE, sizeof(CBltBatchVertex), &pVertices->dwClr);
+	if (rState.pTex)
+	{
+		glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+		glTexCoordPointer(2, GL_FLOAT, sizeof(CBltBatchVertex), &pVertices->ftu);
+	}
+	static const GLenum Modes[] = { GL_POINTS, GL_LINES, GL_TRIANGLES };
+	glDrawArrays(Modes[rState.ePrimitive], 0, static_cast<GLsizei>(rCommand.iVertexCount));
+	glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+	glDisableClientState(GL_COLOR_ARRAY);
+	glDisableClientState(GL_VERTEX_ARRAY);
+	// reset states
+	if (rState.pTex)
+	{
+		if (shader)
 		{
-			glTexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_COMBINE);
-			glTexEnvi(GL_TEXTURE_ENV, GL_COMBINE_RGB,      fMod2 ? GL_ADD_SIGNED : GL_MODULATE);
-			glTexEnvf(GL_TEXTURE_ENV, GL_RGB_SCALE,        fMod2 ? 2.0f : 1.0f);
-			glTexEnvi(GL_TEXTURE_ENV, GL_COMBINE_ALPHA,    GL_ADD);
-			glTexEnvi(GL_TEXTURE_ENV, GL_SOURCE0_RGB,      GL_TEXTURE);
-			glTexEnvi(GL_TEXTURE_ENV, GL_SOURCE1_RGB,      GL_PRIMARY_COLOR);
-			glTexEnvi(GL_TEXTURE_ENV, GL_SOURCE0_ALPHA,    GL_TEXTURE);
-			glTexEnvi(GL_TEXTURE_ENV, GL_SOURCE1_ALPHA,    GL_PRIMARY_COLOR);
-			glTexEnvi(GL_TEXTURE_ENV, GL_OPERAND0_RGB,     GL_SRC_COLOR);
-			glTexEnvi(GL_TEXTURE_ENV, GL_OPERAND1_RGB,     GL_SRC_COLOR);
-			glTexEnvi(GL_TEXTURE_ENV, GL_OPERAND0_ALPHA,   GL_SRC_ALPHA);
-			glTexEnvi(GL_TEXTURE_ENV, GL_OPERAND1_ALPHA,   GL_SRC_ALPHA);
-			dwModMask = 0;
+			glDisable(GL_FRAGMENT_SHADER_ATI);
 		}
-		else
+		else if (shaders[0])
 		{
-			glTexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_MODULATE);
-			glTexEnvf(GL_TEXTURE_ENV, GL_RGB_SCALE,        1.0f);
-			dwModMask = 0xff000000;
+			glDisable(GL_FRAGMENT_PROGRAM_ARB);
 		}
+		if (fLinear)
+		{
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+		}
+		glDisable(GL_TEXTURE_2D);
 	}
-	else
-	{
-		glTexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_REPLACE);
-		glTexEnvf(GL_TEXTURE_ENV, GL_RGB_SCALE, 1.0f);
-	}
-	// set texture+modes
-	glShadeModel((fUseClrModMap && fModClr && !DDrawCfg.NoBoxFades) ? GL_SMOOTH : GL_FLAT);
-	glBindTexture(GL_TEXTURE_2D, pTex->texName);
-	if (pApp->GetScale() != 1.f || (!fExact && !DDrawCfg.PointFiltering))
-	{
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-	}
-
-	glMatrixMode(GL_TEXTURE);
-	float matrix[16];
-	matrix[0] = rBltData.TexPos.mat[0];  matrix[ 1] = rBltData.TexPos.mat[3];  matrix[ 2] = 0; matrix[ 3] = rBltData.TexPos.mat[6];
-	matrix[4] = rBltData.TexPos.mat[1];  matrix[ 5] = rBltData.TexPos.mat[4];  matrix[ 6] = 0; matrix[ 7] = rBltData.TexPos.mat[7];
-	matrix[8] = 0;                       matrix[ 9] = 0;                       matrix[10] = 1; matrix[11] = 0;
-	matrix[12] = rBltData.TexPos.mat[2]; matrix[13] = rBltData.TexPos.mat[5];  matrix[14] = 0; matrix[15] = rBltData.TexPos.mat[8];
-	glLoadMatrixf(matrix);
-
-	glMatrixMode(GL_MODELVIEW);
-	if (rBltData.pTransform)
-	{
-		const float *const mat = rBltData.pTransform->mat;
-		matrix[ 0] = mat[0]; matrix[ 1] = mat[3]; matrix[ 2] = 0; matrix[ 3] = mat[6];
-		matrix[ 4] = mat[1]; matrix[ 5] = mat[4]; matrix[ 6] = 0; matrix[ 7] = mat[7];
-		matrix[ 8] = 0;      matrix[ 9] = 0;      matrix[10] = 1; matrix[11] = 0;
-		matrix[12] = mat[2]; matrix[13] = mat[5]; matrix[14] = 0; matrix[15] = mat[8];
-		glLoadMatrixf(matrix);
-	}
-	else
-	{
-		glLoadIdentity();
-	}
-
-	// draw polygon
-	glBegin(GL_POLYGON);
-	for (int i = 0; i < rBltData.byNumVertices; ++i)
-	{
-		const auto &vtx = rBltData.vtVtx[i];
-		if (fModClr) glColorDw(vtx.dwModClr | dwModMask);
-		glTexCoord2f(vtx.ftx, vtx.fty);
-		glVertex2f(vtx.ftx, vtx.fty);
-	}
-	glEnd();
-	glLoadIdentity();
-	if (shader)
-	{
-		glDisable(GL_FRAGMENT_SHADER_ATI);
-	}
-	else if (shaders[0])
-	{
-		glDisable(GL_FRAGMENT_PROGRAM_ARB);
-	}
-	if (pApp->GetScale() != 1.f || (!fExact && !DDrawCfg.PointFiltering))
-	{
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-	}
+	glShadeModel(GL_FLAT);
 }
 
 void CStdGL::BlitLandscape(CSurface *const sfcSource, CSurface *const sfcSource2,
@@ -317,6 +304,8 @@ void CStdGL::BlitLandscape(CSurface *const sfcSource, CSurface *const sfcSource2
 	if (!PrepareRendering(sfcTarget)) return;
 	// texture present?
 	if (!sfcSource->ppTex) return;
+	// drawn immediately
+	FlushBatch();
 	// blit with basesfc?
 	bool fBaseSfc = false;
 	// get involved texture offsets
@@ -325,6 +314,13 @@ void CStdGL::BlitLandscape(CSurface *const sfcSource, CSurface *const sfcSource2
 	const int iTexY = (std::max)(fy / iTexSize, 0);
 	const int iTexX2 = (std::min)((fx + wdt - 1) / iTexSize + 1, sfcSource->iTexX);
 	const int iTexY2 = (std::min)((fy + hgt - 1) / iTexSize + 1, sfcSource->iTexY);
+	// upload landscape changes not uploaded yet; this binds textures, so do it before setting up the units
+	for (int iY = iTexY; iY < iTexY2; ++iY)
+		for (int iX = iTexX; iX < iTexX2; ++iX)
+		{
+			sfcSource->ppTex[iY * sfcSource->iTexX + iX]->UploadPending();
+			if (sfcSource2) sfcSource2->ppTex[iY * sfcSource2->iTexX + iX]->UploadPending();
+		}
 	// blit from all these textures
 	SetTexture();
 	if (sfcSource2)
@@ -604,97 +600,6 @@ bool CStdGL::CreatePrimarySurfaces()
 	return RestoreDeviceObjects();
 }
 
-void CStdGL::DrawQuadDw(CSurface *const sfcTarget, int *const ipVtx,
-	uint32_t dwClr1, uint32_t dwClr2, uint32_t dwClr3, uint32_t dwClr4)
-{
-	// prepare rendering to target
-	if (!PrepareRendering(sfcTarget)) return;
-	// apply global modulation
-	ClrByCurrentBlitMod(dwClr1);
-	ClrByCurrentBlitMod(dwClr2);
-	ClrByCurrentBlitMod(dwClr3);
-	ClrByCurrentBlitMod(dwClr4);
-	// apply modulation map
-	if (fUseClrModMap)
-	{
-		ModulateClr(dwClr1, pClrModMap->GetModAt(ipVtx[0], ipVtx[1]));
-		ModulateClr(dwClr2, pClrModMap->GetModAt(ipVtx[2], ipVtx[3]));
-		ModulateClr(dwClr3, pClrModMap->GetModAt(ipVtx[4], ipVtx[5]));
-		ModulateClr(dwClr4, pClrModMap->GetModAt(ipVtx[6], ipVtx[7]));
-	}
-	// no clr fading supported
-	if (DDrawCfg.NoBoxFades)
-	{
-		NormalizeColors(dwClr1, dwClr2, dwClr3, dwClr4);
-		glShadeModel(GL_FLAT);
-	}
-	else
-		glShadeModel((dwClr1 == dwClr2 && dwClr1 == dwClr3 && dwClr1 == dwClr4) ? GL_FLAT : GL_SMOOTH);
-	// set blitting state
-	const int iAdditive = dwBlitMode & C4GFXBLIT_ADDITIVE;
-	glBlendFunc(GL_ONE_MINUS_SRC_ALPHA, iAdditive ? GL_ONE : GL_SRC_ALPHA);
-	// draw two triangles
-	glBegin(GL_POLYGON);
-	glColorDw(dwClr1); glVertex2f(ipVtx[0] + DDrawCfg.fBlitOff, ipVtx[1] + DDrawCfg.fBlitOff);
-	glColorDw(dwClr2); glVertex2f(ipVtx[2] + DDrawCfg.fBlitOff, ipVtx[3] + DDrawCfg.fBlitOff);
-	glColorDw(dwClr3); glVertex2f(ipVtx[4] + DDrawCfg.fBlitOff, ipVtx[5] + DDrawCfg.fBlitOff);
-	glColorDw(dwClr4); glVertex2f(ipVtx[6] + DDrawCfg.fBlitOff, ipVtx[7] + DDrawCfg.fBlitOff);
-	glEnd();
-	glShadeModel(GL_FLAT);
-}
-
-void CStdGL::DrawLineDw(CSurface *const sfcTarget,
-	const float x1, const float y1, const float x2, const float y2, uint32_t dwClr)
-{
-	// apply color modulation
-	ClrByCurrentBlitMod(dwClr);
-	// render target?
-	assert(sfcTarget->IsRenderTarget());
-	// prepare rendering to target
-	if (!PrepareRendering(sfcTarget)) return;
-	// set blitting state
-	const int iAdditive = dwBlitMode & C4GFXBLIT_ADDITIVE;
-	// use a different blendfunc here, because GL_LINE_SMOOTH expects this one
-	glBlendFunc(GL_SRC_ALPHA, iAdditive ? GL_ONE : GL_ONE_MINUS_SRC_ALPHA);
-	// draw one line
-	glBegin(GL_LINES);
-	// global clr modulation map
-	uint32_t dwClr1 = dwClr;
-	if (fUseClrModMap)
-	{
-		ModulateClr(dwClr1, pClrModMap->GetModAt(
-			static_cast<int>(x1), static_cast<int>(y1)));
-	}
-	// convert from clonk-alpha to GL_LINE_SMOOTH alpha
-	glColorDw(InvertRGBAAlpha(dwClr1));
-	glVertex2f(x1 + 0.5f, y1 + 0.5f);
-	if (fUseClrModMap)
-	{
-		ModulateClr(dwClr, pClrModMap->GetModAt(
-			static_cast<int>(x2), static_cast<int>(y2)));
-		glColorDw(InvertRGBAAlpha(dwClr));
-	}
-	glVertex2f(x2 + 0.5f, y2 + 0.5f);
-	glEnd();
-}
-
-void CStdGL::DrawPixInt(CSurface *const sfcTarget,
-	const float tx, const float ty, const uint32_t dwClr)
-{
-	// render target?
-	assert(sfcTarget->IsRenderTarget());
-
-	if (!PrepareRendering(sfcTarget)) return;
-	const int iAdditive = dwBlitMode & C4GFXBLIT_ADDITIVE;
-	// use a different blendfunc here because of GL_POINT_SMOOTH
-	glBlendFunc(GL_SRC_ALPHA, iAdditive ? GL_ONE : GL_ONE_MINUS_SRC_ALPHA);
-	// convert the alpha value for that blendfunc
-	glBegin(GL_POINTS);
-	glColorDw(InvertRGBAAlpha(dwClr));
-	glVertex2f(tx + 0.5f, ty + 0.5f);
-	glEnd();
-}
-
 static void DefineShaderARB(const char *const p, GLuint &s)
 {
 	glBindProgramARB(GL_FRAGMENT_PROGRAM_ARB, s);
@@ -993,6 +898,7 @@ void CStdGL::Default()
 {
 	CStdDDraw::Default();
 	sfcFmt = 0;
+	ClipRect = { -1, -1, 0, 0 };
 	MainCtx.Clear();
 }
 
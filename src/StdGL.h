@@ -89,6 +89,7 @@ protected:
 	GLenum sfcFmt; // texture surface format
 	CStdGLCtx MainCtx; // main GL context
 	CStdGLCtx *pCurrCtx; // current context
+	struct { int x, y, Wdt, Hgt; } ClipRect; // viewport set by UpdateClipper
 	// continously numbered shaders for ATI cards
 	unsigned int shader;
 	// shaders for the ARB extension
@@ -113,16 +114,10 @@ public:
 #endif
 
 	// Blit
-	void PerformBlt(CBltData &rBltData, CTexRef *pTex, uint32_t dwModClr, bool fMod2, bool fExact);
 	virtual void BlitLandscape(CSurface *sfcSource, CSurface *sfcSource2, CSurface *sfcLiquidAnimation, int fx, int fy,
 		CSurface *sfcTarget, int tx, int ty, int wdt, int hgt);
 	void FillBG(uint32_t dwClr = 0);
 
-	// Drawing
-	void DrawQuadDw(CSurface *sfcTarget, int *ipVtx, uint32_t dwClr1, uint32_t dwClr2, uint32_t dwClr3, uint32_t dwClr4);
-	void DrawLineDw(CSurface *sfcTarget, float x1, float y1, float x2, float y2, uint32_t dwClr);
-	void DrawPixInt(CSurface *sfcDest, float tx, float ty, uint32_t dwCol);
-
 	// Gamma
 	virtual bool ApplyGammaRamp(CGammaControl &ramp, bool fForce);
 	virtual bool SaveDefaultGammaRamp(CStdWindow *pWindow);
@@ -141,6 +136,7 @@ public:
 #endif
 
 protected:
+	void PerformBatch(const CBltBatchCommand &rCommand, CBltBatchVertex *pVertices);
 	bool CreatePrimarySurfaces();
 	bool CreateDirectDraw();
 
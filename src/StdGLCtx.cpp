@@ -30,6 +30,7 @@ void CStdGLCtx::Deselect(bool secondary)
 {
 	if (pGL && pGL->pCurrCtx == this)
 	{
+		pGL->FlushBatch();
 		DoDeselect();
 		pGL->pCurrCtx = nullptr;
 	}
@@ -112,6 +113,8 @@ bool CStdGLCtx::Init(CStdWindow *pWindow, CStdApp *pApp, HWND hWindow)
 
 bool CStdGLCtx::Select(bool verbose, bool selectOnly)
 {
+	// primitives batched for the previous context
+	if (pGL && pGL->pCurrCtx && pGL->pCurrCtx != this) pGL->FlushBatch();
 	// safety
 	if (!pGL || !hrc) return false; if (!pGL->lpPrimary) return false;
 	// make context current
@@ -163,7 +166,8 @@ bool CStdGLCtx::UpdateSize()
 
 bool CStdGLCtx::PageFlip()
 {
-	// flush GL buffer
+	// flush batched primitives and GL buffer
+	if (pGL) pGL->FlushBatch();
 	glFlush();
 	SwapBuffers(hDC);
 	return true;
@@ -241,6 +245,8 @@ bool CStdGLCtx::Init(CStdWindow *pWindow, CStdApp *)
 
 bool CStdGLCtx::Select(bool verbose, bool selectOnly)
 {
+	// primitives batched for the previous context
+	if (pGL && pGL->pCurrCtx && pGL->pCurrCtx != this) pGL->FlushBatch();
 	// safety
 	if (!pGL || !ctx)
 	{
@@ -316,7 +322,8 @@ bool CStdGLCtx::UpdateSize()
 
 bool CStdGLCtx::PageFlip()
 {
-	// flush GL buffer
+	// flush batched primitives and GL buffer
+	if (pGL) pGL->FlushBatch();
 	glFlush();
 	if (!pWindow || !pWindow->renderwnd) return false;
 	glXSwapBuffers(pWindow->dpy, pWindow->renderwnd);
@@ -385,6 +392,8 @@ bool CStdGLCtx::Init(CStdWindow *pWindow, CStdApp *)
 
 bool CStdGLCtx::Select(bool verbose, bool selectOnly)
 {
+	// primitives batched for the previous context
+	if (pGL && pGL->pCurrCtx && pGL->pCurrCtx != this) pGL->FlushBatch();
 	if (!selectOnly)
 	{
 		pGL->pCurrCtx = this;
@@ -436,7 +445,8 @@ bool CStdGLCtx::UpdateSize()
 
 bool CStdGLCtx::PageFlip()
 {
-	// flush GL buffer
+	// flush batched primitives and GL buffer
+	if (pGL) pGL->FlushBatch();
 	glFlush();
 	if (!pWindow) return false;
 	SDL_GL_SwapBuffers();
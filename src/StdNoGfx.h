@@ -28,7 +28,7 @@ public:
 	virtual bool CreateDirectDraw();
 
 public:
-	virtual bool PageFlip(RECT *pSrcRt = nullptr, RECT *pDstRt = nullptr, CStdWindow *pWindow = nullptr) { return true; }
+	virtual bool PageFlip(RECT *pSrcRt = nullptr, RECT *pDstRt = nullptr, CStdWindow *pWindow = nullptr) { FlushBatch(); return true; }
 	virtual bool BeginScene() { return true; }
 	virtual void EndScene() {}
 	virtual int GetEngine() { return GFXENGN_NOGFX; }
@@ -36,10 +36,6 @@ public:
 	virtual bool OnResolutionChanged() { return true; }
 	virtual bool PrepareRendering(CSurface *) { return true; }
 	virtual void FillBG(uint32_t dwClr = 0) {}
-	virtual void PerformBlt(CBltData &, CTexRef *, uint32_t, bool, bool) {}
-	virtual void DrawLineDw(CSurface *, float, float, float, float, uint32_t) {}
-	virtual void DrawQuadDw(CSurface *, int *, uint32_t, uint32_t, uint32_t, uint32_t) {}
-	virtual void DrawPixInt(CSurface *, float, float, uint32_t) {}
 	virtual bool ApplyGammaRamp(CGammaControl &, bool) { return true; }
 	virtual bool SaveDefaultGammaRamp(CStdWindow *) { return true; }
 	virtual void SetTexture() {}
@@ -48,4 +44,25 @@ public:
 	virtual bool InvalidateDeviceObjects() { return true; }
 	virtual bool DeviceReady() { return true; }
 	virtual bool CreatePrimarySurfaces();
+
+protected:
+	virtual void PerformBatch(const CBltBatchCommand &, CBltBatchVertex *) {}
+};
+
+// records batch commands instead of drawing them; for checking draw submission without a device
+class CStdRecordingGfx : public CStdNoGfx
+{
+public:
+	std::vector<CBltBatchCommand> Commands; // flushed commands; vertex ranges index Vertices
+	std::vector<CBltBatchVertex> Vertices;
+
+	void ClearRecording() { Commands.clear(); Vertices.clear(); }
+	size_t GetDrawCallCount() const { return Commands.size(); }
+
+protected:
+	virtual void PerformBatch(const CBltBatchCommand &rCommand, CBltBatchVertex *pVertices)
+	{
+		Commands.push_back({rCommand.State, Vertices.size(), rCommand.iVertexCount});
+		Vertices.insert(Vertices.end(), pVertices, pVertices + rCommand.iVertexCount);
+	}
 };
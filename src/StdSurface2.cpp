@@ -434,6 +434,7 @@ bool CSurface::SavePNG(const char *szFilename, bool fSaveAlpha, bool fApplyGamma
 	if (fPrimary && pGL)
 	{
 		// Take shortcut. FIXME: Check Endian
+		pGL->FlushBatch();
 		for (int y = 0; y < realHgt; ++y)
 			glReadPixels(0, realHgt - y, realWdt, 1, fSaveAlpha ? GL_BGRA : GL_BGR, GL_UNSIGNED_BYTE, bmp.GetPixelAddr(0, y));
 	}
@@ -541,8 +542,9 @@ bool CSurface::Unlock()
 		{
 			// non-primary unlock: unlock all texture surfaces (if locked)
 			CTexRef **ppTx = ppTex;
+			// changed textures are uploaded once per frame
 			for (int i = 0; i < iTexX * iTexY; ++i, ++ppTx)
-				(*ppTx)->Unlock();
+				(*ppTx)->Unlock(true);
 		}
 	}
 	return true;
@@ -609,6 +611,7 @@ uint32_t CSurface::GetPixDw(int iX, int iY, bool fApplyModulation, float scale)
 				int wdt = static_cast<int32_t>(ceilf(Wdt * scale));
 				wdt = ((wdt + 3) / 4) * 4; // round up to the next multiple of 4
 				PrimarySurfaceLockBits = new unsigned char[wdt * hgt * 3];
+				pGL->FlushBatch();
 				glReadPixels(0, 0, wdt, hgt, GL_BGR, GL_UNSIGNED_BYTE, PrimarySurfaceLockBits);
 				PrimarySurfaceLockPitch = wdt * 3;
 			}
@@ -697,6 +700,42 @@ bool CSurface::SetPixDw(int iX, int iY, uint32_t dwClr)
 	return true;
 }
 
+bool CSurface::SetPixDwRow(int iX, int iY, int iWdt, const uint32_t *pdwClr)
+{
+	if (!ppTex) return false;
+	// clip
+	if (iY < ClipY || iY > ClipY2) return true;
+	if (iX < ClipX) { pdwClr += ClipX - iX; iWdt -= ClipX - iX; iX = ClipX; }
+	if (iX + iWdt > ClipX2 + 1) iWdt = ClipX2 + 1 - iX;
+	// split row into texture spans
+	const int iTexRow = iY / iTexSize, iTexPosY = iY - iTexRow * iTexSize;
+	while (iWdt > 0)
+	{
+		const int iTexCol = iX / iTexSize, iTexPosX = iX - iTexCol * iTexSize;
+		const int iSpan = (std::min)(iWdt, iTexSize - iTexPosX);
+		CTexRef *pTexRef = ppTex[iTexRow * iTexX + iTexCol];
+		const RECT &rLock = pTexRef->LockSize;
+		if (pTexRef->texLock.pBits && rLock.left <= iTexPosX && rLock.right >= iTexPosX + iSpan && rLock.top <= iTexPosY && rLock.bottom > iTexPosY)
+		{
+			// write straight into the lock buffer
+			uint32_t *pDst = reinterpret_cast<uint32_t *>(pTexRef->texLock.pBits + (iTexPosY - rLock.top) * pTexRef->texLock.Pitch) + (iTexPosX - rLock.left);
+			for (int i = 0; i < iSpan; ++i)
+				// if color is fully transparent, ensure it's black
+				pDst[i] = (pdwClr[i] >> 24 == 0xff) ? 0xff000000 : pdwClr[i];
+			pTexRef->AddDirty(iTexPosX, iTexPosY, iTexPosX + iSpan, iTexPosY + 1);
+		}
+		else
+		{
+			// not locked for this span: go the slow way
+			for (int i = 0; i < iSpan; ++i)
+				if (!SetPixDw(iX + i, iY, pdwClr[i])) return false;
+		}
+		iX += iSpan; pdwClr += iSpan; iWdt -= iSpan;
+	}
+	// success
+	return true;
+}
+
 bool CSurface::BltPix(int iX, int iY, CSurface *sfcSource, int iSrcX, int iSrcY, bool fTransparency)
 {
 	// lock target
@@ -704,6 +743,7 @@ bool CSurface::BltPix(int iX, int iY, CSurface *sfcSource, int iSrcX, int iSrcY,
 	if (!GetLockTexAt(&pTexRef, iX, iY)) return false;
 
 	uint32_t *pPix = (uint32_t *)(((uint8_t *)pTexRef->texLock.pBits) + iY * pTexRef->texLock.Pitch + iX * 4);
+	pTexRef->AddDirty(iX, iY, iX + 1, iY + 1);
 	// get source pix as dword
 	uint32_t srcPix = sfcSource->GetPixDw(iSrcX, iSrcY, true);
 	// merge
@@ -787,6 +827,7 @@ bool CSurface::CopyBytes(uint8_t *pImageData)
 			uint8_t *pTarget = (uint8_t *)pTex->texLock.pBits;
 			int iCpyNum = (std::min)(pTex->iSize, Wdt - iXImgPos) * 4;
 			int iYMax = (std::min)(pTex->iSize, Hgt - iLineTotal);
+			pTex->AddDirty(0, 0, iCpyNum / 4, iYMax);
 			for (int iLine = 0; iLine < iYMax; ++iLine)
 			{
 				memcpy(pTarget, pSource, iCpyNum);
@@ -807,7 +848,8 @@ CTexRef::CTexRef(int iSize, bool fSingle)
 #ifndef USE_CONSOLE
 	texName = 0;
 #endif
-	texLock.pBits = nullptr; fIntLock = false;
+	texLock.pBits = nullptr; fIntLock = false; fUploadPending = false;
+	DirtyRect.left = DirtyRect.top = DirtyRect.right = DirtyRect.bottom = 0;
 	// store size
 	this->iSize = iSize;
 	// add to texture manager
@@ -848,11 +890,13 @@ CTexRef::~CTexRef()
 #ifndef USE_CONSOLE
 	if (pGL)
 	{
-		if (texName && pGL->pCurrCtx) glDeleteTextures(1, &texName);
+		// batched primitives might still use the texture
+		if (texName && pGL->pCurrCtx) { pGL->FlushBatch(); glDeleteTextures(1, &texName); }
 	}
 #endif
 	if (lpDDraw) delete[] texLock.pBits; texLock.pBits = nullptr;
 	// remove from texture manager
+	if (fUploadPending) pTexMgr->RemovePendingUpload(this);
 	pTexMgr->UnregTex(this);
 }
 
@@ -861,8 +905,8 @@ bool CTexRef::LockForUpdate(RECT &rtUpdate)
 	// already locked?
 	if (texLock.pBits)
 	{
-		// fully locked
-		if (LockSize.left == 0 && LockSize.right == iSize && LockSize.top == 0 && LockSize.bottom == iSize)
+		// fully locked, or the pending lock covers the rect already
+		if (LockSize.left <= rtUpdate.left && LockSize.right >= rtUpdate.right && LockSize.top <= rtUpdate.top && LockSize.bottom >= rtUpdate.bottom)
 		{
 			return true;
 		}
@@ -883,6 +927,7 @@ bool CTexRef::LockForUpdate(RECT &rtUpdate)
 				(rtUpdate.right - rtUpdate.left) * (rtUpdate.bottom - rtUpdate.top) * 4];
 			texLock.Pitch = (rtUpdate.right - rtUpdate.left) * 4;
 			LockSize = rtUpdate;
+			DirtyRect.left = DirtyRect.top = DirtyRect.right = DirtyRect.bottom = 0;
 			return true;
 		}
 	}
@@ -898,7 +943,14 @@ bool CTexRef::LockForUpdate(RECT &rtUpdate)
 bool CTexRef::Lock()
 {
 	// already locked?
-	if (texLock.pBits) return true;
+	if (texLock.pBits)
+	{
+		if (LockSize.left == 0 && LockSize.right == iSize && LockSize.top == 0 && LockSize.bottom == iSize)
+			return true;
+		// partially locked (e.g. a pending ClearRect): commit that first
+		Unlock();
+		if (texLock.pBits) return false;
+	}
 	LockSize.right = LockSize.bottom = iSize;
 	LockSize.top = LockSize.left = 0;
 	// lock
@@ -914,6 +966,7 @@ bool CTexRef::Lock()
 			texLock.Pitch = iSize * 4;
 			glBindTexture(GL_TEXTURE_2D, texName);
 			glGetTexImage(GL_TEXTURE_2D, 0, GL_BGRA, GL_UNSIGNED_INT_8_8_8_8_REV, texLock.pBits);
+			DirtyRect.left = DirtyRect.top = DirtyRect.right = DirtyRect.bottom = 0;
 			return true;
 		}
 	}
@@ -926,13 +979,21 @@ bool CTexRef::Lock()
 	return false;
 }
 
-void CTexRef::Unlock()
+void CTexRef::Unlock(bool fDefer)
 {
 	// locked?
 	if (!texLock.pBits || fIntLock) return;
 #ifndef USE_CONSOLE
 	if (pGL)
 	{
+		const bool fDirty = DirtyRect.right > DirtyRect.left && DirtyRect.bottom > DirtyRect.top;
+		if (fDefer && texName)
+		{
+			// keep the lock buffer, so further changes until the next frame are uploaded together
+			if (fDirty && !fUploadPending) { fUploadPending = true; pTexMgr->AddPendingUpload(this); }
+			if (fUploadPending) return;
+		}
+		if (fUploadPending) { fUploadPending = false; pTexMgr->RemovePendingUpload(this); }
 		// select context, if not already done
 		if (!pGL->pCurrCtx) if (!pGL->MainCtx.Select()) return;
 		glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
@@ -947,17 +1008,24 @@ void CTexRef::Unlock()
 			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
 			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
 			glTexImage2D(GL_TEXTURE_2D, 0, 4, iSize, iSize, 0, GL_BGRA, GL_UNSIGNED_INT_8_8_8_8_REV, texLock.pBits);
+			pTexMgr->UploadedBytes += iSize * iSize * 4; ++pTexMgr->UploadCount;
 		}
-		else
+		else if (fDirty)
 		{
-			// reuse the existing texture
+			// batched primitives must still see the old texture data
+			pGL->FlushBatch();
+			// upload the changed part of the lock buffer only
+			const int iWdt = DirtyRect.right - DirtyRect.left, iHgt = DirtyRect.bottom - DirtyRect.top;
 			glBindTexture(GL_TEXTURE_2D, texName);
-			glTexSubImage2D(GL_TEXTURE_2D, 0,
-				LockSize.left, LockSize.top, LockSize.right - LockSize.left, LockSize.bottom - LockSize.top,
-				GL_BGRA, GL_UNSIGNED_INT_8_8_8_8_REV, texLock.pBits);
+			glPixelStorei(GL_UNPACK_ROW_LENGTH, texLock.Pitch / 4);
+			glTexSubImage2D(GL_TEXTURE_2D, 0, DirtyRect.left, DirtyRect.top, iWdt, iHgt,
+				GL_BGRA, GL_UNSIGNED_INT_8_8_8_8_REV,
+				texLock.pBits + (DirtyRect.top - LockSize.top) * texLock.Pitch + (DirtyRect.left - LockSize.left) * 4);
+			glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+			pTexMgr->UploadedBytes += iWdt * iHgt * 4; ++pTexMgr->UploadCount;
 		}
 		delete[] texLock.pBits; texLock.pBits = nullptr;
-		// switch back to original context
+		DirtyRect.left = DirtyRect.top = DirtyRect.right = DirtyRect.bottom = 0;
 	}
 	else
 #endif
@@ -970,6 +1038,7 @@ bool CTexRef::ClearRect(RECT &rtClear)
 {
 	// ensure locked
 	if (!LockForUpdate(rtClear)) return false;
+	AddDirty(rtClear.left, rtClear.top, rtClear.right, rtClear.bottom);
 	// clear pixels
 	for (int y = rtClear.top; y < rtClear.bottom; ++y)
 	{
@@ -984,6 +1053,7 @@ bool CTexRef::FillBlack()
 {
 	// ensure locked
 	if (!Lock()) return false;
+	AddDirty(0, 0, iSize, iSize);
 	// clear pixels
 	std::fill_n(reinterpret_cast<std::uint32_t *>(texLock.pBits), iSize * iSize, 0);
 	// success
@@ -996,6 +1066,7 @@ CTexMgr::CTexMgr()
 {
 	// clear textures
 	Textures.clear();
+	UploadedBytes = UploadCount = FrameUploadedBytes = FrameUploadCount = 0;
 }
 
 CTexMgr::~CTexMgr()
@@ -1040,5 +1111,25 @@ void CTexMgr::IntUnlock()
 	}
 }
 
+void CTexMgr::RemovePendingUpload(CTexRef *pTex)
+{
+	PendingUploads.erase(std::find(PendingUploads.begin(), PendingUploads.end(), pTex));
+}
+
+void CTexMgr::FlushUploads()
+{
+	// clear the list first, so Unlock doesn't look for the textures in it
+	std::vector<CTexRef *> Uploads;
+	Uploads.swap(PendingUploads);
+	for (CTexRef *pTex : Uploads)
+	{
+		pTex->fUploadPending = false;
+		pTex->Unlock();
+	}
+	// frame statistics
+	FrameUploadedBytes = UploadedBytes; FrameUploadCount = UploadCount;
+	UploadedBytes = UploadCount = 0;
+}
+
 CTexMgr *pTexMgr;
 const uint8_t FColors[] = { 31, 16, 39, 47, 55, 63, 71, 79, 87, 95, 23, 30, 99, 103 };
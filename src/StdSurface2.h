@@ -27,6 +27,7 @@
 #endif
 
 #include <list>
+#include <vector>
 
 // config settings
 #define C4GFXCFG_NO_ALPHA_ADD    1
@@ -169,6 +170,8 @@ public:
 	uint32_t GetPixDw(int iX, int iY, bool fApplyModulation, float scale = 1.0); // get 32bit-px
 	bool IsPixTransparent(int iX, int iY); // is pixel's alpha value 0xff?
 	bool SetPixDw(int iX, int iY, uint32_t dwCol); // set pix in surface only
+	// set a row of pixels directly in the texture lock buffers; does not lock itself if the textures are already locked for the row (e.g. by ClearBoxDw)
+	bool SetPixDwRow(int iX, int iY, int iWdt, const uint32_t *pdwClr);
 	bool BltPix(int iX, int iY, CSurface *sfcSource, int iSrcX, int iSrcY, bool fTransparency); // blit pixel from source to this surface (assumes clipped coordinates!)
 	bool Create(int iWdt, int iHgt, bool fOwnPal = false, bool fIsRenderTarget = false);
 	bool CreateColorByOwner(CSurface *pBySurface); // create ColorByOwner-surface
@@ -211,20 +214,40 @@ public:
 #endif
 	int iSize;
 	bool fIntLock; // if set, texref is locked internally only
+	bool fUploadPending; // if set, the lock buffer is kept until the next CTexMgr::FlushUploads or until the texture is drawn
 	RECT LockSize;
+	RECT DirtyRect; // part of the lock buffer changed since locking; empty if right <= left
 
 	CTexRef(int iSize, bool fAsRenderTarget); // create texture with given size
 	~CTexRef(); // release texture
 	bool Lock(); // lock texture
 	// Lock a part of the rect, discarding the content
-	// Note: Calling Lock afterwards without an Unlock first is undefined
 	bool LockForUpdate(RECT &rtUpdate);
-	void Unlock(); // unlock texture
+	// unlock texture and upload the dirty rect; if fDefer is set, the upload is postponed and coalesced with later changes
+	void Unlock(bool fDefer = false);
+	void UploadPending() { if (fUploadPending) Unlock(); } // must be done before the texture is drawn
 	bool ClearRect(RECT &rtClear); // clear rect in texture to transparent
 	bool FillBlack(); // fill complete texture in black
 
+	// extend dirty rect; texture coordinates, right and bottom are exclusive
+	// contained rects don't write anything, so threads may share a lock buffer that has been made dirty beforehand
+	void AddDirty(int iX1, int iY1, int iX2, int iY2)
+	{
+		if (DirtyRect.left <= iX1 && DirtyRect.top <= iY1 && DirtyRect.right >= iX2 && DirtyRect.bottom >= iY2) return;
+		if (DirtyRect.right <= DirtyRect.left)
+		{
+			DirtyRect.left = iX1; DirtyRect.top = iY1; DirtyRect.right = iX2; DirtyRect.bottom = iY2;
+			return;
+		}
+		if (iX1 < DirtyRect.left) DirtyRect.left = iX1;
+		if (iY1 < DirtyRect.top) DirtyRect.top = iY1;
+		if (iX2 > DirtyRect.right) DirtyRect.right = iX2;
+		if (iY2 > DirtyRect.bottom) DirtyRect.bottom = iY2;
+	}
+
 	void SetPix(int iX, int iY, uint32_t v)
 	{
+		AddDirty(iX, iY, iX + 1, iY + 1);
 		*((uint32_t *)(((uint8_t *)texLock.pBits) + (iY - LockSize.top) * texLock.Pitch + (iX - LockSize.left) * 4)) = v;
 	}
 };
@@ -244,6 +267,15 @@ public:
 
 	void IntLock(); // do an internal lock
 	void IntUnlock(); // undo internal lock
+
+	// deferred texture uploads
+	std::vector<CTexRef *> PendingUploads;
+	size_t UploadedBytes, UploadCount; // since the last FlushUploads
+	size_t FrameUploadedBytes, FrameUploadCount; // of the last frame
+
+	void AddPendingUpload(CTexRef *pTex) { PendingUploads.push_back(pTex); }
+	void RemovePendingUpload(CTexRef *pTex);
+	void FlushUploads(); // upload all pending textures; called once per frame
 };
 
 extern CTexMgr *pTexMgr;
@@ -68,6 +68,16 @@ void CSurface8::Box(int iX, int iY, int iX2, int iY2, int iCol)
 	for (int cy = iY; cy <= iY2; cy++) HLine(iX, iX2, cy, iCol);
 }
 
+void CSurface8::Box(int iX, int iY, int iX2, int iY2, int iCol, int iClipX, int iClipY, int iClipX2, int iClipY2)
+{
+	if (!Bits) return;
+	// clip
+	iX = std::max(iX, iClipX); iX2 = std::min(iX2, iClipX2);
+	iY = std::max(iY, iClipY); iY2 = std::min(iY2, iClipY2);
+	if (iX > iX2) return;
+	for (int cy = iY; cy <= iY2; cy++) memset(Bits + cy * Pitch + iX, iCol, iX2 - iX + 1);
+}
+
 void CSurface8::NoClip()
 {
 	ClipX = 0; ClipY = 0; ClipX2 = Wdt - 1; ClipY2 = Hgt - 1;
@@ -299,11 +309,15 @@ static CPolyEdge *remove_edge(CPolyEdge *list, CPolyEdge *edge)
 	else return edge->next;
 }
 
-// Global polygon quick buffer
+// Polygon quick buffer size
 const int QuickPolyBufSize = 20;
-CPolyEdge QuickPolyBuf[QuickPolyBufSize];
 
 void CSurface8::Polygon(int iNum, int *ipVtx, int iCol)
+{
+	Polygon(iNum, ipVtx, iCol, ClipX, ClipY, ClipX2, ClipY2);
+}
+
+void CSurface8::Polygon(int iNum, int *ipVtx, int iCol, int iClipX, int iClipY, int iClipX2, int iClipY2)
 {
 	// Variables for polygon drawer
 	int c, x1, x2, y;
@@ -314,6 +328,7 @@ void CSurface8::Polygon(int iNum, int *ipVtx, int iCol)
 	CPolyEdge *active_edges = nullptr;
 	CPolyEdge *inactive_edges = nullptr;
 	bool use_qpb = false;
+	CPolyEdge QuickPolyBuf[QuickPolyBufSize]; // on the stack, so polygons can be drawn by multiple threads
 
 	// Poly Buf
 	if (iNum <= QuickPolyBufSize)
@@ -360,15 +375,16 @@ void CSurface8::Polygon(int iNum, int *ipVtx, int iCol)
 
 		// Draw horizontal line segments
 		edge = active_edges;
-		while ((edge) && (edge->next))
+		while ((edge) && (edge->next) && c >= iClipY && c <= iClipY2 && Bits)
 		{
 			x1 = edge->x >> POLYGON_FIX_SHIFT;
 			x2 = (edge->next->x + edge->next->w) >> POLYGON_FIX_SHIFT;
 			y = c;
 			// Fix coordinates
 			if (x1 > x2) std::swap(x1, x2);
-			// Set line
-			for (int xcnt = x2 - x1; xcnt >= 0; xcnt--) SetPix(x1 + xcnt, y, iCol);
+			// Clip and set line
+			x1 = std::max(x1, iClipX); x2 = std::min(x2, iClipX2);
+			if (x1 <= x2) memset(Bits + y * Pitch + x1, iCol, x2 - x1 + 1);
 			edge = edge->next->next;
 		}
 
@@ -38,6 +38,9 @@ public:
 	void HLine(int iX, int iX2, int iY, int iCol);
 	void Polygon(int iNum, int *ipVtx, int iCol);
 	void Box(int iX, int iY, int iX2, int iY2, int iCol);
+	// draw clipped by the given rect instead of the surface clipper; safe to be called from multiple threads for disjoint clip rects
+	void Polygon(int iNum, int *ipVtx, int iCol, int iClipX, int iClipY, int iClipX2, int iClipY2);
+	void Box(int iX, int iY, int iX2, int iY2, int iCol, int iClipX, int iClipY, int iClipX2, int iClipY2);
 	void Circle(int x, int y, int r, uint8_t col);
 	void ClearBox8Only(int iX, int iY, int iWdt, int iHgt); // clear box in 8bpp-surface only
 
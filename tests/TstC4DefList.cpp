@@ -0,0 +1,72 @@
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <C4Include.h>
+#include <C4Def.h>
+
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+using namespace std;
+
+// number of definitions to create; most IDs share their first letter like in real object packs
+const int32_t DefCount = 4000;
+const int32_t LookupCount = 10000000;
+
+int main(int argc, char *argv[])
+{
+	C4DefList Defs;
+	vector<C4ID> IDs;
+	const char *szChars = "ABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789_";
+	for (int32_t i = 0; i < DefCount; ++i)
+	{
+		char szID[5];
+		szID[0] = (i % 8) ? 'S' : szChars[i % 26];
+		szID[1] = szChars[(i / 37 / 37) % 37];
+		szID[2] = szChars[(i / 37) % 37];
+		szID[3] = szChars[i % 37];
+		szID[4] = 0;
+		C4Def *pDef = new C4Def;
+		pDef->id = C4Id(szID);
+		if (!Defs.Add(pDef, false)) { delete pDef; continue; }
+		IDs.push_back(pDef->id);
+	}
+	// some misses, too
+	const C4ID Absent[] = { C4Id("S___"), C4Id("ZZZZ"), C4ID_None };
+
+	Defs.BuildTable();
+
+	bool fFailed = false;
+	for (C4ID id : IDs)
+	{
+		C4Def *pDef = Defs.ID2Def(id);
+		if (!pDef || pDef->id != id)
+		{
+			cout << "FAILED: " << C4IdText(id) << " not found" << endl;
+			fFailed = true;
+		}
+	}
+	for (C4ID id : Absent)
+		if (Defs.ID2Def(id))
+		{
+			cout << "FAILED: absent " << C4IdText(id) << " found" << endl;
+			fFailed = true;
+		}
+	cout << IDs.size() << " present and " << size(Absent) << " absent IDs looked up" << (fFailed ? "" : ", ok") << endl;
+
+	// timing, hits and misses mixed
+	vector<C4ID> Lookups(IDs);
+	Lookups.insert(Lookups.end(), begin(Absent), end(Absent));
+	size_t iFound = 0;
+	auto Start = chrono::steady_clock::now();
+	for (int32_t i = 0; i < LookupCount; ++i)
+		if (Defs.ID2Def(Lookups[i % Lookups.size()]))
+			++iFound;
+	auto Duration = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - Start).count();
+	cout << LookupCount << " lookups (" << iFound << " found) in " << Duration / 1000000 << " ms (" << double(Duration) / LookupCount << " ns per lookup)" << endl;
+
+	Defs.Clear();
+	return fFailed ? 1 : 0;
+}
@@ -0,0 +1,54 @@
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <C4Include.h>
+#include <C4NetIO.h>
+
+#include <iostream>
+
+using namespace std;
+
+class TestNetIOUDP : public C4NetIOUDP
+{
+public:
+	using C4NetIOUDP::Packet;
+	using C4NetIOUDP::PacketList;
+	using C4NetIOUDP::iMaxOPacketBacklog;
+};
+
+typedef TestNetIOUDP::Packet Packet;
+typedef TestNetIOUDP::PacketList PacketList;
+
+// a complete packet of the given number of one-byte fragments
+static Packet *NewPacket(unsigned int iNr, unsigned int iFragmentCnt)
+{
+	StdBuf Data; Data.New(iFragmentCnt); std::memset(Data.getMData(), 0, iFragmentCnt);
+	return new Packet(C4NetIOPacket(Data), iNr, 1);
+}
+
+int main(int argc, char *argv[])
+{
+	// outgoing: a backlog of big packets spans more fragments than an incoming window may
+	PacketList OPackets(TestNetIOUDP::iMaxOPacketBacklog);
+	const unsigned int iBigFragmentCnt = PacketList::iMaxIWindowSize / 2 + 1;
+	bool fOutOK = true;
+	for (unsigned int i = 0; i < 3; ++i)
+		fOutOK = OPackets.AddPacket(NewPacket(i * iBigFragmentCnt, iBigFragmentCnt)) && fOutOK;
+	const unsigned int iLastFrgm = 3 * iBigFragmentCnt - 1;
+	Packet *pLast = OPackets.GetPacketFrgm(iLastFrgm);
+	fOutOK = fOutOK && pLast && pLast->GetNr() == 2 * iBigFragmentCnt && OPackets.FragmentPresent(iLastFrgm);
+	OPackets.ClearPackets(iBigFragmentCnt);
+	fOutOK = fOutOK && !OPackets.GetPacketFrgm(0) && OPackets.GetPacket(iBigFragmentCnt);
+	cout << "outgoing window of " << iLastFrgm + 1 << " fragments " << (fOutOK ? "ok" : "FAILED") << endl;
+
+	// incoming: fragments behind the window are dropped until it has moved on
+	PacketList IPackets(~0, PacketList::iMaxIWindowSize);
+	Packet *pFirst = NewPacket(0, 1), *pFar = NewPacket(PacketList::iMaxIWindowSize, 1);
+	bool fInOK = IPackets.AddPacket(pFirst) && !IPackets.AddPacket(pFar) && IPackets.GetPacket(0) == pFirst;
+	IPackets.DeletePacket(pFirst);
+	fInOK = fInOK && IPackets.AddPacket(pFar) && IPackets.GetPacket(PacketList::iMaxIWindowSize) == pFar;
+	cout << "incoming window " << (fInOK ? "ok" : "FAILED") << endl;
+
+	return fOutOK && fInOK ? 0 : 1;
+}
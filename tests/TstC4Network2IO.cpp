@@ -0,0 +1,70 @@
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <C4Include.h>
+#include <C4Network2IO.h>
+
+#include <iostream>
+
+using namespace std;
+
+// a peer that doesn't acknowledge anything: packets just pile up in the log
+class SilentNetIO : public C4NetIO
+{
+public:
+	int iSent = 0, iClosed = 0;
+
+	virtual bool Init(uint16_t iPort = addr_t::IPPORT_NONE) { return true; }
+	virtual bool Close() { return true; }
+	virtual bool Execute(int iTimeout = -1) { return true; }
+	virtual bool Connect(const addr_t &addr) { return true; }
+	virtual bool Close(const addr_t &addr) { ++iClosed; return true; }
+	virtual bool Send(const C4NetIOPacket &rPacket) { ++iSent; return true; }
+	virtual bool SetBroadcast(const addr_t &addr, bool fSet = true) { return true; }
+	virtual bool Broadcast(const C4NetIOPacket &rPacket) { return true; }
+	virtual bool GetStatistic(int *pBroadcastRate, int *pRecvBatch = nullptr, int *pSendBatch = nullptr) { return false; }
+	virtual bool GetConnStatistic(const addr_t &addr, int *pIRate, int *pORate, int *pLoss) { return false; }
+	virtual void ClearStatistic() {}
+	virtual void SetCallback(CBClass *pnCallback) {}
+};
+
+class TestConnection : public C4Network2IOConnection
+{
+public:
+	using C4Network2IOConnection::Set;
+};
+
+int main(int argc, char *argv[])
+{
+	SilentNetIO NetIO;
+	TestConnection Conn;
+	const C4NetIO::addr_t Addr(C4NetIO::HostAddress::Loopback, 11112);
+	Conn.Set(&NetIO, P_UDP, Addr, Addr, CS_Accepted, nullptr, 1);
+
+	// send past the limit; every packet carries its number
+	const uint32_t iPacketCount = C4NetMaxPacketLog + 100;
+	bool fSendOK = true;
+	for (uint32_t i = 0; i < iPacketCount; ++i)
+	{
+		uint8_t Data[1 + sizeof(i)] = { PID_PacketLogStart };
+		std::memcpy(Data + 1, &i, sizeof(i));
+		fSendOK = Conn.Send(C4NetIOPacket(Data, sizeof(Data), true)) && fSendOK;
+	}
+	const bool fClosed = Conn.isClosed() && NetIO.iClosed == 1 && NetIO.iSent == C4NetMaxPacketLog;
+	cout << "connection " << (fClosed ? "closed" : "NOT CLOSED") << " after " << NetIO.iSent << " unacknowledged packets" << endl;
+
+	// the post mortem must still hold every packet the peer hasn't seen
+	C4PacketPostMortem PostMortem;
+	bool fRecovered = Conn.CreatePostMortem(&PostMortem) && PostMortem.getPacketCount() == iPacketCount;
+	for (uint32_t i = 0; fRecovered && i < iPacketCount; ++i)
+	{
+		const C4NetIOPacket *pPkt = PostMortem.getPacket(i);
+		uint32_t iNumber;
+		fRecovered = pPkt && pPkt->getPSize() == sizeof(iNumber);
+		if (fRecovered) { std::memcpy(&iNumber, pPkt->getPData(), sizeof(iNumber)); fRecovered = iNumber == i; }
+	}
+	cout << "post mortem " << (fRecovered ? "recovers" : "DOESN'T RECOVER") << " all " << iPacketCount << " packets" << endl;
+
+	return fSendOK && fClosed && fRecovered ? 0 : 1;
+}
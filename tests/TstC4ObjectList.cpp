@@ -0,0 +1,123 @@
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <C4Include.h>
+#include <C4Object.h>
+#include <C4Sector.h>
+
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+using namespace std;
+
+// a busy round: lots of objects wandering around a large landscape
+const int32_t LandscapeWdt = 4000, LandscapeHgt = 1500;
+const int32_t ObjectCount = 5000;
+const int32_t FrameCount = 100;
+
+static uint32_t iSeed = 1;
+static int32_t Random(int32_t iRange) { iSeed = iSeed * 1103515245 + 12345; return (iSeed >> 16) % iRange; }
+
+int main(int argc, char *argv[])
+{
+	const int32_t Categories[] = { C4D_StaticBack, C4D_Structure, C4D_Vehicle, C4D_Living, C4D_Object };
+	vector<C4Def *> Defs;
+	for (int32_t i = 0; i < 20; ++i)
+	{
+		C4Def *pDef = new C4Def;
+		pDef->id = C4Id("OB00") + i;
+		pDef->Category = Categories[i % 5];
+		Defs.push_back(pDef);
+	}
+
+	C4ObjectList Main;
+	C4LSectors Sectors;
+	Sectors.Init(LandscapeWdt, LandscapeHgt);
+	vector<C4Object *> Objects;
+	auto Start = chrono::steady_clock::now();
+	for (int32_t i = 0; i < ObjectCount; ++i)
+	{
+		C4Object *pObj = new C4Object;
+		pObj->Def = Defs[Random(Defs.size())];
+		pObj->id = pObj->Def->id;
+		pObj->Category = pObj->Def->Category;
+		pObj->Status = C4OS_NORMAL;
+		// structures are large and span several sectors
+		const int32_t iSize = (pObj->Category & C4D_Structure) ? 120 : 12;
+		pObj->Shape.x = pObj->Shape.y = -iSize / 2;
+		pObj->Shape.Wdt = pObj->Shape.Hgt = iSize;
+		pObj->x = Random(LandscapeWdt); pObj->y = Random(LandscapeHgt);
+		pObj->SyncHotFields();
+		Main.Add(pObj, C4ObjectList::stMain);
+		Sectors.Add(pObj, &Main);
+		Objects.push_back(pObj);
+	}
+	auto Duration = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - Start).count();
+	cout << ObjectCount << " objects added in " << Duration / 1000000 << " ms" << endl;
+
+	// everything but structures moves every frame; some are fast enough to change sectors often
+	int32_t iUpdates = 0;
+	Start = chrono::steady_clock::now();
+	for (int32_t iFrame = 0; iFrame < FrameCount; ++iFrame)
+		for (C4Object *pObj : Objects)
+		{
+			if (pObj->Category & (C4D_StaticBack | C4D_Structure)) continue;
+			pObj->x = BoundBy<int32_t>(pObj->x + Random(41) - 20, 0, LandscapeWdt - 1);
+			pObj->y = BoundBy<int32_t>(pObj->y + Random(41) - 20, 0, LandscapeHgt - 1);
+			Sectors.Update(pObj, &Main);
+			++iUpdates;
+		}
+	Duration = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - Start).count();
+	cout << iUpdates << " sector updates in " << Duration / 1000000 << " ms (" << double(Duration) / iUpdates << " ns per update)" << endl;
+
+	// lookups by object, as done by Remove, GetLink and IsContained
+	int32_t iFound = 0;
+	Start = chrono::steady_clock::now();
+	for (int32_t i = 0; i < 1000; ++i)
+		for (C4Object *pObj : Objects)
+			if (Main.IsContained(pObj) && Sectors.SectorAt(pObj->x, pObj->y)->Objects.GetLink(pObj))
+				++iFound;
+	Duration = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - Start).count();
+	cout << iFound << " lookups in " << Duration / 1000000 << " ms (" << double(Duration) / iFound << " ns per lookup)" << endl;
+
+	// sector lists must still be in main list order
+	bool fSorted = true;
+	for (int32_t i = 0; i < Sectors.Size; ++i)
+		fSorted = fSorted && Sectors.Sectors[i].Objects.CheckSort(&Main) && Sectors.Sectors[i].ObjectShapes.CheckSort(&Main);
+	cout << "sector lists " << (fSorted ? "sorted" : "NOT SORTED") << ", " << Sectors.getShapeSum() << " shape links" << endl;
+
+	// removing objects while iterating: the iterator goes on with the successor,
+	// and removed links are only freed with the last iterator
+	bool fIterOK;
+	{
+		C4ObjectList List;
+		for (int32_t i = 0; i < 10; ++i) List.Add(Objects[i], C4ObjectList::stNone);
+		const size_t iLinks = ObjectLinkPool.GetUsedCount();
+		int32_t iVisited = 0;
+		fIterOK = true;
+		for (C4ObjectList::iterator it = List.begin(); it != List.end(); ++it)
+		{
+			++iVisited;
+			// drop the current object and the one after it
+			C4ObjectLink *pNext = it.GetLink()->Next;
+			List.Remove(*it);
+			if (pNext) List.Remove(pNext->Obj);
+			fIterOK = fIterOK && ObjectLinkPool.GetUsedCount() == iLinks;
+		}
+		fIterOK = fIterOK && iVisited == 4 && List.ObjectCount() == 3 && ObjectLinkPool.GetUsedCount() == iLinks - 7;
+		cout << "removal while iterating " << (fIterOK ? "ok" : "FAILED") << endl;
+	}
+
+	for (C4Object *pObj : Objects)
+	{
+		Sectors.Remove(pObj);
+		Main.Remove(pObj);
+		pObj->Status = 0;
+		delete pObj;
+	}
+	Sectors.Clear();
+	for (C4Def *pDef : Defs) delete pDef;
+	return fSorted && fIterOK ? 0 : 1;
+}
@@ -0,0 +1,142 @@
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <C4Include.h>
+#include <C4Value.h>
+#include <C4ValueList.h>
+
+#include <chrono>
+#include <iostream>
+
+using namespace std;
+
+const int32_t ArraySize = 100;
+const int32_t LoopCount = 20000;
+
+static bool fFailed = false;
+
+static void Check(bool fOK, const char *szWhat)
+{
+	cout << szWhat << ": " << (fOK ? "ok" : "FAILED") << endl;
+	if (!fOK) fFailed = true;
+}
+
+// times what the interpreter does for typical script loops
+template <typename Fn> void Measure(const char *szName, Fn &&Loop)
+{
+	auto Start = chrono::steady_clock::now();
+	const int64_t iOps = Loop();
+	auto Duration = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - Start).count();
+	cout << szName << ": " << Duration / 1000000 << " ms (" << double(Duration) / iOps << " ns per iteration)" << endl;
+}
+
+static void Benchmark(C4ValueArray *pArray, C4Value &Array)
+{
+	cout << "sizeof(C4Value) = " << sizeof(C4Value) << endl;
+
+	C4Value Stack[16];
+
+	// for (var i = 0; i < size; ++i) sum += a[i];
+	Measure("stack pushes", [&]()
+	{
+		C4Value Sum, Index;
+		for (int32_t l = 0; l < LoopCount; ++l)
+			for (Index.SetInt(0); Index._getInt() < ArraySize; Index.SetInt(Index._getInt() + 1))
+			{
+				Stack[0] = Sum;
+				Stack[1] = Array;
+				Stack[2] = Index;
+				Stack[1].Set(pArray->GetItem(Stack[2]._getInt()));
+				Stack[0].SetInt(Stack[0]._getInt() + Stack[1]._getInt());
+				Sum = Stack[0];
+				for (C4Value &Val : Stack) Val.Set0();
+			}
+		return int64_t{LoopCount} * ArraySize;
+	});
+
+	// for (var i = 0; i < size; ++i) a[i] += 1; (element references)
+	Measure("element references", [&]()
+	{
+		for (int32_t l = 0; l < LoopCount; ++l)
+			for (int32_t i = 0; i < ArraySize; ++i)
+			{
+				Stack[0].SetRef(&(*pArray)[i]);
+				C4Value &Val = Stack[0].GetRefVal();
+				Val.SetInt(Val._getInt() + 1);
+				Stack[0].Set0();
+			}
+		return int64_t{LoopCount} * ArraySize;
+	});
+
+	// copying value lists (e.g. passing arrays by value)
+	Measure("list copies", [&]()
+	{
+		for (int32_t l = 0; l < LoopCount; ++l)
+		{
+			C4ValueList Copy(*pArray);
+			Stack[0].SetInt(Copy.GetSize());
+		}
+		return int64_t{LoopCount} * ArraySize;
+	});
+}
+
+int main(int argc, char *argv[])
+{
+	// reference links live in a side table, so values stay small
+	if (sizeof(void *) == 8)
+		Check(sizeof(C4Value) == 16, "sizeof(C4Value) == 16");
+
+	C4ValueArray *pArray = new C4ValueArray(ArraySize);
+	C4Value Array(pArray);
+	for (int32_t i = 0; i < ArraySize; ++i)
+		(*pArray)[i].SetInt(i);
+
+	// plain copies don't need link records
+	{
+		C4Value Copy = Array, Int = (*pArray)[5];
+		Check(Int._getInt() == 5 && Copy._getArray() == pArray, "copies");
+	}
+	Check(ValueLinks.GetUsedCount() == 0, "no link records for plain values");
+
+	// a[i] += 1 through element references
+	C4Value Ref;
+	for (int32_t i = 0; i < ArraySize; ++i)
+	{
+		Ref.SetRef(&(*pArray)[i]);
+		C4Value &Val = Ref.GetRefVal();
+		Val.SetInt(Val._getInt() + 1);
+	}
+	bool fWritten = true;
+	for (int32_t i = 0; i < ArraySize; ++i)
+		fWritten = fWritten && (*pArray)[i]._getInt() == i + 1;
+	Check(fWritten, "element references write through");
+
+	// the referenced element tracks the reference until it's dropped
+	Check(ValueLinks.GetUsedCount() > 0, "link records for references");
+	Ref.Set0();
+	Check(ValueLinks.GetUsedCount() == 0, "link records freed after Set0");
+
+	// several references to the same element
+	{
+		C4Value Ref1, Ref2;
+		Ref1.SetRef(&(*pArray)[0]);
+		Ref2.SetRef(&(*pArray)[0]);
+		Ref2.GetRefVal().SetInt(42);
+		Check(Ref1.GetRefVal()._getInt() == 42, "shared references");
+	}
+	Check(ValueLinks.GetUsedCount() == 0, "link records freed with the references");
+
+	// copying a value list copies the values, not the references to them
+	{
+		C4ValueList Copy(*pArray);
+		Copy[1].SetInt(-1);
+		Check(Copy.GetSize() == ArraySize && (*pArray)[1]._getInt() == 2, "list copies");
+	}
+
+	Benchmark(pArray, Array);
+
+	Array.Set0();
+	Check(ValueLinks.GetUsedCount() == 0, "no link records left");
+	return fFailed ? 1 : 0;
+}
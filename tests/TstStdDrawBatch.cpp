@@ -0,0 +1,159 @@
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <C4Include.h>
+#include <C4Application.h>
+#include <C4Config.h>
+#include <StdNoGfx.h>
+
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+using namespace std;
+
+// primitives per test; e.g. rain drops or glyphs of a long message
+const int32_t PrimitiveCount = 10000;
+
+static bool fFailed = false;
+
+static void Check(CStdRecordingGfx &Gfx, const char *szName, size_t iDrawCalls, size_t iVertices)
+{
+	Gfx.FlushBatch();
+	const bool fOK = Gfx.GetDrawCallCount() == iDrawCalls && Gfx.Vertices.size() == iVertices;
+	cout << szName << ": " << Gfx.GetDrawCallCount() << " draw calls, " << Gfx.Vertices.size() << " vertices";
+	if (!fOK)
+	{
+		cout << " - FAILED, expected " << iDrawCalls << " draw calls, " << iVertices << " vertices";
+		fFailed = true;
+	}
+	cout << endl;
+	Gfx.ClearRecording();
+}
+
+// blits only batch if the target can be rendered to, as the primary surface can
+class CTestScreen : public CSurface
+{
+public:
+	CTestScreen(int iWdt, int iHgt) { Wdt = iWdt; Hgt = iHgt; fPrimary = true; NoClip(); }
+};
+
+// the command textures must alternate between the given textures
+static void CheckTextures(CStdRecordingGfx &Gfx, const char *szName, CTexRef *pTex1, CTexRef *pTex2)
+{
+	Gfx.FlushBatch();
+	bool fOK = true;
+	for (size_t i = 0; i < Gfx.Commands.size(); ++i)
+		fOK = fOK && Gfx.Commands[i].State.pTex == ((i & 1) ? pTex2 : pTex1) && Gfx.Commands[i].State.ePrimitive == BBP_Triangles;
+	if (!fOK)
+	{
+		cout << szName << ": FAILED, wrong texture or primitive" << endl;
+		fFailed = true;
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	CStdRecordingGfx Gfx;
+	lpDDraw = &Gfx;
+	Gfx.CreatePrimarySurfaces();
+	CSurface *sfcTarget = Gfx.lpPrimary;
+
+	// same state: everything goes into one command
+	for (int32_t i = 0; i < PrimitiveCount; ++i)
+		Gfx.DrawLineDw(sfcTarget, float(i % 640), 0.0f, float(i % 640), 10.0f, 0x4080ff);
+	Check(Gfx, "lines", 1, 2 * PrimitiveCount);
+
+	for (int32_t i = 0; i < PrimitiveCount; ++i)
+		Gfx.DrawPix(sfcTarget, float(i % 640), float(i / 640), 0xff0000);
+	Check(Gfx, "pixels", 1, PrimitiveCount);
+
+	// bulk submission, as done for PXS
+	vector<CBltVertex> Pixels;
+	for (int32_t i = 0; i < PrimitiveCount; ++i)
+		Pixels.push_back({ float(i % 640), float(i / 640), 0x4080ff });
+	Gfx.DrawPixelsDw(sfcTarget, Pixels.data(), Pixels.size());
+	Gfx.DrawLinesDw(sfcTarget, Pixels.data(), Pixels.size());
+	Check(Gfx, "bulk pixels and lines", 2, 2 * PrimitiveCount);
+
+	int Vtx[8] = { 0, 0, 10, 0, 10, 10, 0, 10 };
+	for (int32_t i = 0; i < PrimitiveCount; ++i)
+		Gfx.DrawQuadDw(sfcTarget, Vtx, 0x808080, 0x808080, 0x808080, 0x808080);
+	Check(Gfx, "quads", 1, 6 * PrimitiveCount);
+
+	// state changes split the batch, but order is kept
+	for (int32_t i = 0; i < PrimitiveCount; ++i)
+	{
+		Gfx.DrawPix(sfcTarget, 1.0f, 1.0f, 0xff0000);
+		Gfx.DrawLineDw(sfcTarget, 0.0f, 0.0f, 5.0f, 5.0f, 0xff0000);
+	}
+	Check(Gfx, "alternating pixels and lines", 2 * PrimitiveCount, 3 * PrimitiveCount);
+
+	for (int32_t i = 0; i < PrimitiveCount; ++i)
+	{
+		Gfx.SetBlitMode((i & 1) ? C4GFXBLIT_ADDITIVE : 0);
+		Gfx.DrawPix(sfcTarget, 1.0f, 1.0f, 0xff0000);
+	}
+	Gfx.ResetBlitMode();
+	Check(Gfx, "alternating blit modes", PrimitiveCount, PrimitiveCount);
+
+	// a batch holds 0x10000 vertices; more are flushed in another command
+	for (int32_t i = 0; i < 0x10000; ++i)
+		Gfx.DrawLineDw(sfcTarget, float(i % 640), 0.0f, float(i % 640), 10.0f, 0x4080ff);
+	Check(Gfx, "overflowing batch", 2, 2 * 0x10000);
+
+	// textured blits
+	Gfx.pApp = &Application;
+	Config.Graphics.Scale = 100;
+	CTestScreen sfcScreen(640, 480);
+	CSurface sfcSprite1, sfcSprite2;
+	sfcSprite1.Create(64, 64);
+	sfcSprite2.Create(64, 64);
+	CTexRef *pTex1 = *sfcSprite1.ppTex, *pTex2 = *sfcSprite2.ppTex;
+
+	// consecutive blits of the same texture share one command
+	for (int32_t i = 0; i < PrimitiveCount; ++i)
+		Gfx.Blit(&sfcSprite1, 0.0f, 0.0f, 64.0f, 64.0f, &sfcScreen, i % 576, 0, 64, 64);
+	CheckTextures(Gfx, "sprites", pTex1, pTex1);
+	Check(Gfx, "sprites", 1, 6 * PrimitiveCount);
+
+	// texture or blend mode changes split them
+	for (int32_t i = 0; i < PrimitiveCount; ++i)
+		Gfx.Blit((i & 1) ? &sfcSprite2 : &sfcSprite1, 0.0f, 0.0f, 64.0f, 64.0f, &sfcScreen, i % 576, 0, 64, 64);
+	CheckTextures(Gfx, "alternating textures", pTex1, pTex2);
+	Check(Gfx, "alternating textures", PrimitiveCount, 6 * PrimitiveCount);
+
+	for (int32_t i = 0; i < PrimitiveCount; ++i)
+	{
+		Gfx.SetBlitMode((i & 1) ? C4GFXBLIT_ADDITIVE : 0);
+		Gfx.Blit(&sfcSprite1, 0.0f, 0.0f, 64.0f, 64.0f, &sfcScreen, i % 576, 0, 64, 64);
+	}
+	Gfx.ResetBlitMode();
+	CheckTextures(Gfx, "alternating blit modes (sprites)", pTex1, pTex1);
+	Check(Gfx, "alternating blit modes (sprites)", PrimitiveCount, 6 * PrimitiveCount);
+
+	// texture positions of a sprite sheet section: two triangles of the rectangle
+	// (16, 32)-(32, 48), drawn at (100, 50)
+	Gfx.Blit(&sfcSprite1, 16.0f, 32.0f, 16.0f, 16.0f, &sfcScreen, 100, 50, 16, 16);
+	Gfx.FlushBatch();
+	{
+		const float fOff = DDrawCfg.fBlitOff, fIndent = DDrawCfg.fTexIndent;
+		const float fU1 = (16 + fIndent) / 64, fV1 = (32 + fIndent) / 64, fSize = 16 / (64 + 2 * fIndent);
+		const int Corners[6] = { 0, 1, 2, 0, 2, 3 }; // triangle fan of top left, top right, bottom right, bottom left
+		bool fOK = Gfx.Vertices.size() == 6;
+		for (size_t i = 0; fOK && i < 6; ++i)
+		{
+			const bool fRight = Corners[i] == 1 || Corners[i] == 2, fBottom = Corners[i] >= 2;
+			const CBltBatchVertex &rVtx = Gfx.Vertices[i];
+			fOK = std::fabs(rVtx.ftx - (100 + fOff + (fRight ? 16 : 0))) < 1e-4f && std::fabs(rVtx.fty - (50 + fOff + (fBottom ? 16 : 0))) < 1e-4f
+				&& std::fabs(rVtx.ftu - (fU1 + (fRight ? fSize : 0))) < 1e-5f && std::fabs(rVtx.ftv - (fV1 + (fBottom ? fSize : 0))) < 1e-5f;
+		}
+		cout << "sprite texture positions: " << (fOK ? "ok" : "FAILED") << endl;
+		if (!fOK) fFailed = true;
+	}
+	Check(Gfx, "sprite section", 1, 6);
+
+	lpDDraw = nullptr;
+	return fFailed ? 1 : 0;
+}